@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: bench.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Declarations for the benchmarks linked into bandwidth_bench, plus the
+// small timing helpers they share. Each benchmark lives in its own
+// translation unit and is registered in main.cpp.
+//
+// repeat() runs a measurement after warmup runs and summarizes its
+// figures with the tester's statistics (benchmark::summarize), so a table
+// cell is the mean of the runs +/- the 95% confidence interval.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __BENCH_HPP__
+#define __BENCH_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+namespace bench {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+typedef std::chrono::steady_clock clock;
+
+inline double seconds_since(clock::time_point start)
+{
+   std::chrono::duration<double> elapsed = clock::now() - start;
+
+   return elapsed.count();
+}
+
+inline double gbits(std::size_t bytes, double seconds)
+{
+   return seconds > 0 ? bytes * 8.0 / seconds / 1e9 : 0;
+}
+
+// Each run fills in figures[0, count); the summaries are in their units
+inline std::vector<ev9::benchmark::result> repeat(std::size_t count, const std::function<void(double*)>& measure, std::size_t samples = 5, std::size_t warmup = 1)
+{
+   std::vector<double> figures(count);
+
+   for (std::size_t run = 0; run < warmup; ++run)
+   {
+      measure(&figures[0]);
+   }
+
+   std::vector<std::vector<double> > runs(count);
+
+   for (std::size_t run = 0; run < samples; ++run)
+   {
+      measure(&figures[0]);
+
+      for (std::size_t index = 0; index < count; ++index)
+      {
+         runs[index].push_back(figures[index]);
+      }
+   }
+
+   std::vector<ev9::benchmark::result> summaries;
+
+   for (std::size_t index = 0; index < count; ++index)
+   {
+      summaries.push_back(ev9::benchmark::summarize(std::string(), runs[index]));
+   }
+
+   return summaries;
+}
+
+inline ev9::benchmark::result repeat(const std::function<double()>& measure, std::size_t samples = 5, std::size_t warmup = 1)
+{
+   return repeat(1, [&measure](double* figures) { figures[0] = measure(); }, samples, warmup)[0];
+}
+
+// "mean +/- confidence" for a table column
+inline std::string cell(const ev9::benchmark::result& summary, int precision)
+{
+   char text[64];
+
+   std::snprintf(text, sizeof(text), "%.*f +/- %.*f", precision, summary.mean, precision, summary.confidence);
+
+   return text;
+}
+
+inline double ratio(const ev9::benchmark::result& numerator, const ev9::benchmark::result& denominator)
+{
+   return denominator.mean > 0 ? numerator.mean / denominator.mean : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void read_sizes();
+void scatter_gather();
+void reactor_connections();
+void tester_scheduling();
+void tester_pool();
+void tester_scaling();
+void framing_rate();
+void write_coalescing();
+void connection_reuse();
+void sharded_accept();
+void thread_placement();
+void transport_comparison();
+void memory_baseline();
+void verify_cost();
+void buffer_reuse();
+void session_models();
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(bench)
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __BENCH_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: buffer_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// What set_buffer_pool() saves when a run is many short transfers, as in a
+// sweep or a tuning pass. The same 64 loopback transfers of 32 MiB with 1
+// MiB payloads run with freshly mapped payloads, then with one pool of
+// small pages and one of huge pages. Each row shows the page faults the
+// process took per transfer and the rate of one transfer, both the mean
+// over the 64 after a warmup one, and how much of the process sat on
+// transparent huge pages afterwards.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "bandwidth.hpp"
+#include "buffer_pool.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7132;
+
+const std::size_t payload = 1024 * 1024;
+const std::size_t transfer_bytes = 32 * 1024 * 1024;
+const std::size_t transfers = 64;
+
+void transfer(ev9::buffer_pool* pool)
+{
+   ev9::bandwidth receiver(port, payload);
+   ev9::bandwidth sender(port, payload);
+
+   receiver.set_buffer_pool(pool);
+   sender.set_buffer_pool(pool);
+   sender.set_byte_count(transfer_bytes);
+
+   receiver.listen();
+
+   std::thread receiving_thread([&]() { receiver.receive(); });
+
+   sender.send("127.0.0.1");
+
+   receiving_thread.join();
+}
+
+// AnonHugePages of the whole process in KiB, -1 without smaps_rollup
+long huge_kib()
+{
+   std::ifstream rollup("/proc/self/smaps_rollup");
+
+   std::string line;
+
+   while (std::getline(rollup, line))
+   {
+      if (line.compare(0, 14, "AnonHugePages:") == 0) return std::strtol(line.c_str() + 14, nullptr, 10);
+   }
+
+   return -1;
+}
+
+void row(const char* const label, ev9::buffer_pool* pool)
+{
+   // The warmup transfer maps the pool's regions; the rest are the point
+   std::vector<ev9::benchmark::result> figures = ev9::bench::repeat(3, [pool](double* figures)
+   {
+      ev9::page_faults before = ev9::page_faults::now();
+
+      auto start = ev9::bench::clock::now();
+
+      transfer(pool);
+
+      double seconds = ev9::bench::seconds_since(start);
+
+      ev9::page_faults taken = ev9::page_faults::now() - before;
+
+      figures[0] = (double)taken.minor;
+      figures[1] = (double)taken.major;
+      figures[2] = ev9::bench::gbits(transfer_bytes, seconds);
+
+   }, transfers, 1);
+
+   std::printf("%14s %18s %10.0f %20s %10ld\n",
+               label,
+               ev9::bench::cell(figures[0], 1).c_str(),
+               figures[1].mean * transfers,
+               ev9::bench::cell(figures[2], 3).c_str(),
+               huge_kib());
+}
+
+} // end of namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::buffer_reuse()
+{
+   std::printf("%lu transfers of %lu MiB over loopback, %lu KiB payloads\n", (unsigned long)transfers, (unsigned long)(transfer_bytes >> 20), (unsigned long)(payload >> 10));
+   std::printf("%14s %18s %10s %20s %10s\n", "payloads", "minor/xfer", "major", "Gbit/s", "huge KiB");
+
+   row("mapped", nullptr);
+
+   ev9::buffer_pool small_pages;
+
+   small_pages.set_huge_pages(false);
+
+   row("pool 4 KiB", &small_pages);
+
+   ev9::buffer_pool huge_pages;
+
+   row("pool huge", &huge_pages);
+
+   std::printf("huge page pool: %lu KiB mapped, %lu KiB hugetlb, %lu KiB advised transparent, %lu hits, %lu misses\n",
+               (unsigned long)(huge_pages.mapped_bytes() >> 10),
+               (unsigned long)(huge_pages.hugetlb_bytes() >> 10),
+               (unsigned long)(huge_pages.transparent_bytes() >> 10),
+               (unsigned long)huge_pages.hits(),
+               (unsigned long)huge_pages.misses());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of buffer_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: connect_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Short loopback probes: the client sends a probe of 1 KiB to 1 MiB and
+// waits for a one byte acknowledgement. The fresh column connects and
+// closes for every probe, the pooled column leases a warm connection from
+// a connection_pool. Each cell is the mean over 5 runs of 500 probes.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "pool.hpp"
+#include "socket.hpp"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7105;
+
+// Acknowledges every probe, taking connections one after another
+void serve(ev9::socket* server, std::size_t probe_size, std::size_t count)
+{
+   std::vector<char> probe(probe_size);
+
+   std::size_t served = 0;
+
+   while (served < count)
+   {
+      server->accept();
+
+      while (served < count && server->read_all(&probe[0], probe_size) == probe_size)
+      {
+         server->write_back("k");
+
+         ++served;
+      }
+
+      server->close_accepted();
+   }
+}
+
+void probe(ev9::socket& connection, const std::vector<char>& payload)
+{
+   for (std::size_t sent = 0; sent < payload.size(); )
+   {
+      sent += connection.write(&payload[sent], payload.size() - sent);
+   }
+
+   char ack = 0;
+
+   if (connection.read_back_all(&ack, 1) != 1)
+   {
+      throw std::runtime_error("Probe was not acknowledged");
+   }
+}
+
+double measure(std::size_t probe_size, std::size_t count, bool pooled)
+{
+   ev9::socket server(port);
+
+   server.bind();
+   server.listen(64);
+
+   std::thread serving_thread(serve, &server, probe_size, count);
+
+   std::vector<char> payload(probe_size, 'p');
+
+   ev9::connection_pool pool;
+
+   auto start = ev9::bench::clock::now();
+
+   for (std::size_t index = 0; index < count; ++index)
+   {
+      if (pooled)
+      {
+         ev9::connection_pool::lease connection = pool.acquire("127.0.0.1", port);
+
+         probe(*connection, payload);
+
+         connection.release();
+      }
+
+      else
+      {
+         ev9::socket connection(port);
+
+         connection.connect(5);
+
+         probe(connection, payload);
+      }
+   }
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   // Ends the server's last read
+   pool.clear();
+
+   serving_thread.join();
+
+   return seconds * 1e6 / count;
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::connection_reuse()
+{
+   const std::size_t count = 500;
+
+   std::printf("%10s %20s %20s %8s\n", "probe", "fresh us/probe", "pooled us/probe", "speedup");
+
+   for (std::size_t probe_size = 1024; probe_size <= 1024 * 1024; probe_size *= 8)
+   {
+      ev9::benchmark::result fresh = ev9::bench::repeat([probe_size]() { return measure(probe_size, count, false); });
+      ev9::benchmark::result pooled = ev9::bench::repeat([probe_size]() { return measure(probe_size, count, true); });
+
+      std::printf("%9luK %20s %20s %7.1fx\n", (unsigned long)(probe_size / 1024), ev9::bench::cell(fresh, 1).c_str(), ev9::bench::cell(pooled, 1).c_str(), ev9::bench::ratio(fresh, pooled));
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of connect_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: framing_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Loopback message rate for 16 byte to 4 KiB length-prefixed frames. The
+// sender streams the same pre-encoded frames to both receivers. The read
+// column uses socket::read(std::vector<char>&) and cuts frames out of the
+// accumulated bytes, copying each one out and erasing it, as a caller of
+// that path has to. The framed column uses frame_reader views. Each cell
+// is the mean over 5 runs of 16 MiB.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "framing.hpp"
+#include "socket.hpp"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7103;
+
+void stream(const std::vector<char>* encoded)
+{
+   ev9::socket socket(port);
+
+   socket.connect();
+
+   std::size_t sent = 0;
+
+   while (sent < encoded->size())
+   {
+      sent += socket.write(&(*encoded)[sent], encoded->size() - sent);
+   }
+}
+
+std::size_t read_frames(ev9::socket& socket, std::size_t count)
+{
+   std::vector<char> pending;
+   std::vector<char> message;
+
+   std::size_t frames = 0;
+
+   while (frames < count)
+   {
+      std::size_t before = pending.size();
+
+      socket.read(pending);
+
+      if (pending.size() == before)
+      {
+         break;
+      }
+
+      std::size_t offset = 0;
+
+      while (pending.size() - offset >= ev9::frame_header_size)
+      {
+         std::size_t size = ev9::decode_frame_header(&pending[offset]);
+
+         if (pending.size() - offset < ev9::frame_header_size + size)
+         {
+            break;
+         }
+
+         message.assign(pending.begin() + offset + ev9::frame_header_size, pending.begin() + offset + ev9::frame_header_size + size);
+
+         offset += ev9::frame_header_size + size;
+
+         ++frames;
+      }
+
+      pending.erase(pending.begin(), pending.begin() + offset);
+   }
+
+   return frames;
+}
+
+double measure(std::size_t frame_size, std::size_t count, bool framed, std::size_t* reads)
+{
+   std::vector<char> encoded(count * (ev9::frame_header_size + frame_size), 'f');
+
+   for (std::size_t index = 0; index < count; ++index)
+   {
+      ev9::encode_frame_header(&encoded[index * (ev9::frame_header_size + frame_size)], (std::uint32_t)frame_size);
+   }
+
+   ev9::socket socket(port);
+
+   socket.bind();
+   socket.listen();
+
+   std::thread sender(stream, &encoded);
+
+   socket.accept();
+
+   std::size_t frames = 0;
+
+   auto start = ev9::bench::clock::now();
+
+   if (framed)
+   {
+      ev9::frame_reader reader(socket);
+      ev9::frame_reader::frame current;
+
+      while (frames < count && reader.next(current))
+      {
+         ++frames;
+      }
+
+      *reads = reader.reads();
+   }
+
+   else
+   {
+      frames = read_frames(socket, count);
+   }
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   sender.join();
+
+   return seconds > 0 ? frames / seconds / 1e6 : 0;
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::framing_rate()
+{
+   const std::size_t total = 16 * 1024 * 1024;
+
+   std::printf("%10s %20s %20s %8s %16s\n", "frame", "read Mframe/s", "framed Mframe/s", "speedup", "frames per read");
+
+   for (std::size_t frame_size = 16; frame_size <= 4096; frame_size *= 4)
+   {
+      std::size_t count = total / (frame_size + ev9::frame_header_size);
+      std::size_t reads = 0;
+
+      ev9::benchmark::result current = ev9::bench::repeat([&]() { return measure(frame_size, count, false, &reads); });
+      ev9::benchmark::result framed = ev9::bench::repeat([&]() { return measure(frame_size, count, true, &reads); });
+
+      std::printf("%10lu %20s %20s %7.1fx %16.1f\n", (unsigned long)frame_size, ev9::bench::cell(current, 3).c_str(), ev9::bench::cell(framed, 3).c_str(), ev9::bench::ratio(framed, current), reads > 0 ? (double)count / reads : 0);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of framing_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
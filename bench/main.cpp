@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: main.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// bandwidth_bench [name ...]
+//
+// Runs the named benchmarks, or all of them when no name is given.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+
+#include <csignal>
+#include <cstdio>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct benchmark_entry
+{
+   const char* name;
+   void (*function)();
+};
+
+const benchmark_entry benchmarks[] =
+{
+   { "read", ev9::bench::read_sizes },
+   { "vector", ev9::bench::scatter_gather },
+   { "reactor", ev9::bench::reactor_connections },
+   { "tester", ev9::bench::tester_scheduling },
+   { "pool", ev9::bench::tester_pool },
+   { "scaling", ev9::bench::tester_scaling },
+   { "framing", ev9::bench::framing_rate },
+   { "writer", ev9::bench::write_coalescing },
+   { "connect", ev9::bench::connection_reuse },
+   { "shard", ev9::bench::sharded_accept },
+   { "placement", ev9::bench::thread_placement },
+   { "transport", ev9::bench::transport_comparison },
+   { "memory", ev9::bench::memory_baseline },
+   { "verify", ev9::bench::verify_cost },
+   { "buffers", ev9::bench::buffer_reuse },
+   { "sessions", ev9::bench::session_models },
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv)
+{
+   #if !_WIN32
+      std::signal(SIGPIPE, SIG_IGN);
+   #endif
+
+   bool ran = false;
+
+   for (const benchmark_entry& entry : benchmarks)
+   {
+      bool selected = argc == 1;
+
+      for (int index = 1; index < argc; ++index)
+      {
+         if (std::string(argv[index]) == entry.name) selected = true;
+      }
+
+      if (!selected) continue;
+
+      std::printf("=== %s ===\n", entry.name);
+
+      entry.function();
+
+      ran = true;
+   }
+
+   if (!ran)
+   {
+      std::printf("usage: bandwidth_bench [name ...]\n\nbenchmarks:");
+
+      for (const benchmark_entry& entry : benchmarks)
+      {
+         std::printf(" %s", entry.name);
+      }
+
+      std::printf("\n");
+
+      return 1;
+   }
+
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of main.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: memory_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// The memory bandwidth baseline (see memory.hpp): every kernel on one
+// thread from an L1 sized working set out to DRAM, then every kernel at
+// the largest working set on 1 thread up to all of them.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "memory.hpp"
+
+#include <cstdio>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::memory_baseline()
+{
+   ev9::memory_bandwidth suite;
+
+   std::string caches;
+
+   for (std::size_t size : suite.caches())
+   {
+      caches += (caches.empty() ? "" : ", ") + std::to_string(size >> 10) + " KiB";
+   }
+
+   std::printf("caches %s, %lu cpus\n", caches.c_str(), (unsigned long)suite.thread_counts().back());
+
+   suite.print(suite.size_sweep(1));
+
+   std::printf("\n");
+
+   suite.print(suite.thread_sweep(suite.sizes().back()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of memory_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: placement_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Four loopback streams of 64 MiB each under every thread placement. Both
+// ends of a stream are placed the same way, so with compact a sender and
+// its receiver share a core's caches, and with scatter they sit as far
+// apart as the machine allows. Each placement gets its own block of ports.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "parallel.hpp"
+#include "topology.hpp"
+
+#include <cstdio>
+#include <thread>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7107;
+
+const std::size_t streams = 4;
+const std::size_t stream_bytes = 64 * 1024 * 1024;
+
+double placed_rate(ev9::placement policy, std::size_t base_port)
+{
+   ev9::parallel_bandwidth receiver(base_port, streams);
+   ev9::parallel_bandwidth sender(base_port, streams);
+
+   receiver.set_placement(policy);
+   sender.set_placement(policy);
+   sender.set_byte_count(stream_bytes);
+
+   receiver.listen();
+
+   std::thread receiving_thread([&]() { receiver.receive(); });
+
+   ev9::parallel_bandwidth::results sent = sender.send("127.0.0.1");
+
+   receiving_thread.join();
+
+   return ev9::parallel_bandwidth::aggregate(sent).gbits();
+}
+
+} // end of namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::thread_placement()
+{
+   const ev9::placement policies[] = { ev9::placement_none, ev9::placement_compact, ev9::placement_scatter, ev9::placement_node };
+
+   ev9::topology layout;
+
+   std::printf("%lu streams of %lu MiB, %lu cpus, %lu cores, %lu nodes\n",
+               (unsigned long)streams,
+               (unsigned long)(stream_bytes >> 20),
+               (unsigned long)layout.cpus().size(),
+               (unsigned long)layout.cores(),
+               (unsigned long)layout.nodes().size());
+
+   std::printf("%10s %10s  %s\n", "placement", "Gbit/s", "threads");
+
+   for (std::size_t index = 0; index < sizeof(policies) / sizeof(policies[0]); ++index)
+   {
+      double gbits = placed_rate(policies[index], port + index * streams);
+
+      std::printf("%10s %10.3f  %s\n", ev9::placement_name(policies[index]), gbits, layout.describe(policies[index], layout.place(policies[index], streams)).c_str());
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of placement_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: reactor_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// One ev9::reactor thread drains 1 to 512 concurrent loopback connections
+// while a client thread writes 16 KiB chunks round robin across them.
+// Reports aggregate throughput and how many events each epoll wakeup
+// carried.
+//
+// Requirements: c++11, Linux
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "reactor.hpp"
+#include "socket.hpp"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7102;
+const double duration = 1.0;
+
+void measure(std::size_t connection_count)
+{
+   ev9::socket server(port);
+
+   server.bind();
+   server.listen(1024);
+
+   ev9::reactor reactor;
+
+   std::vector<char> buffer(256 * 1024);
+
+   std::size_t received = 0;
+
+   reactor.listen(server, ev9::reactor::handler(), [&](ev9::reactor::connection& conn)
+   {
+      std::size_t amount_read;
+
+      while ((amount_read = conn.read(&buffer[0], buffer.size())) != 0)
+      {
+         received += amount_read;
+      }
+   });
+
+   std::thread loop([&]() { reactor.run(); });
+
+   std::vector<ev9::socket*> clients;
+
+   for (std::size_t index = 0; index < connection_count; ++index)
+   {
+      clients.push_back(new ev9::socket(port));
+      clients.back()->connect();
+   }
+
+   std::vector<char> chunk(16 * 1024, 'r');
+
+   std::size_t sent = 0;
+
+   auto start = ev9::bench::clock::now();
+
+   while (ev9::bench::seconds_since(start) < duration)
+   {
+      for (ev9::socket* client : clients)
+      {
+         sent += client->write(&chunk[0], chunk.size());
+      }
+   }
+
+   for (ev9::socket* client : clients)
+   {
+      delete client;
+   }
+
+   // Every connection has been closed by its peer once the count drops
+   while (reactor.connections() != 0)
+   {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   reactor.stop();
+   loop.join();
+
+   std::printf("%12lu %12.3f %12lu %16.2f\n",
+               (unsigned long)connection_count,
+               ev9::bench::gbits(received, seconds),
+               (unsigned long)reactor.wakeups(),
+               reactor.wakeups() ? (double)reactor.events() / reactor.wakeups() : 0);
+
+   if (received != sent)
+   {
+      std::printf("warning: sent %lu bytes but received %lu\n", (unsigned long)sent, (unsigned long)received);
+   }
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::reactor_connections()
+{
+   std::printf("%12s %12s %12s %16s\n", "connections", "Gbit/s", "wakeups", "events/wakeup");
+
+   for (std::size_t connection_count = 1; connection_count <= 512; connection_count *= 4)
+   {
+      measure(connection_count);
+   }
+
+   measure(512);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of reactor_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
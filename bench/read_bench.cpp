@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: read_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Loopback receive throughput for 4 KiB to 4 MiB reads. The legacy column
+// reproduces the original socket::_read path: a memset 256 byte buffer,
+// 255 bytes per syscall and a push_back per byte into a fresh vector. The
+// bulk column uses read_all() into one preallocated buffer.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "socket.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7100;
+
+void stream(std::size_t total)
+{
+   ev9::socket socket(port);
+
+   socket.connect();
+
+   std::vector<char> payload(128 * 1024, 'x');
+
+   std::size_t sent = 0;
+
+   while (sent < total)
+   {
+      std::size_t size = total - sent < payload.size() ? total - sent : payload.size();
+
+      sent += socket.write(&payload[0], size);
+   }
+}
+
+std::size_t legacy_read(ev9::socket& socket, std::size_t size)
+{
+   char chunk[256];
+
+   std::vector<char> message;
+
+   while (message.size() < size)
+   {
+      memset(chunk, 0, sizeof(chunk));
+
+      std::size_t amount_read = socket.read(chunk, sizeof(chunk) - 1);
+
+      if (amount_read == 0)
+      {
+         break;
+      }
+
+      for (std::size_t index = 0; index < amount_read; ++index)
+      {
+         message.push_back(chunk[index]);
+      }
+   }
+
+   return message.size();
+}
+
+double measure(std::size_t read_size, std::size_t total, bool legacy)
+{
+   ev9::socket socket(port);
+
+   socket.bind();
+   socket.listen();
+
+   std::thread sender(stream, total);
+
+   socket.accept();
+
+   std::vector<char> buffer(read_size);
+
+   std::size_t received = 0;
+
+   auto start = ev9::bench::clock::now();
+
+   while (received < total)
+   {
+      std::size_t amount_read = legacy ? legacy_read(socket, read_size) : socket.read_all(&buffer[0], read_size);
+
+      if (amount_read == 0)
+      {
+         break;
+      }
+
+      received += amount_read;
+   }
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   sender.join();
+
+   return ev9::bench::gbits(received, seconds);
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::read_sizes()
+{
+   const std::size_t total = 256 * 1024 * 1024;
+
+   std::printf("%10s %16s %16s %8s\n", "read size", "legacy Gbit/s", "bulk Gbit/s", "speedup");
+
+   for (std::size_t read_size = 4 * 1024; read_size <= 4 * 1024 * 1024; read_size *= 4)
+   {
+      double legacy = measure(read_size, total / 4, true);
+      double bulk = measure(read_size, total, false);
+
+      std::printf("%9luK %16.3f %16.3f %7.1fx\n", (unsigned long)(read_size / 1024), legacy, bulk, legacy > 0 ? bulk / legacy : 0);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of read_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: server_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// sharded_server on loopback with 1 to 8 workers. The accept column has 8
+// client threads open and close 8000 connections that the server closes
+// straight away. The stream column has 16 clients send 16 MiB each, which
+// the workers drain, and reports aggregate Gbit/s. Each cell is the mean
+// over 5 runs.
+//
+// Every run connects to its own 127.0.0.x. Back to back bursts to one
+// address keep finding their ephemeral ports in TIME_WAIT from the burst
+// before, which costs far more than the accept path being measured.
+//
+// Requirements: c++11, Linux
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "server.hpp"
+#include "socket.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7106;
+
+const std::size_t client_threads = 8;
+const std::size_t connections = 8000;
+
+const std::size_t streams = 16;
+const std::size_t stream_bytes = 16 * 1024 * 1024;
+
+void run_clients(std::size_t count, const std::function<void()>& client)
+{
+   std::vector<std::thread> threads;
+
+   for (std::size_t index = 0; index < count; ++index)
+   {
+      threads.push_back(std::thread(client));
+   }
+
+   for (std::thread& thread : threads)
+   {
+      thread.join();
+   }
+}
+
+// A fresh loopback address per run
+std::string next_address()
+{
+   static int host = 1;
+
+   host = host % 250 + 1;
+
+   return "127.0.0." + std::to_string(host);
+}
+
+double accept_rate(std::size_t workers)
+{
+   std::string address = next_address();
+
+   ev9::sharded_server server(port, workers);
+
+   server.start([](ev9::socket&, std::size_t) { });
+
+   auto start = ev9::bench::clock::now();
+
+   run_clients(client_threads, [&address]()
+   {
+      for (std::size_t index = 0; index < connections / client_threads; ++index)
+      {
+         ev9::socket client(address, port);
+
+         client.connect(5);
+      }
+   });
+
+   while (server.accepted() < connections)
+   {
+      std::this_thread::yield();
+   }
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   server.stop();
+
+   return seconds > 0 ? connections / seconds : 0;
+}
+
+double stream_rate(std::size_t workers)
+{
+   std::string address = next_address();
+
+   ev9::sharded_server server(port, workers);
+
+   std::atomic<std::size_t> received(0);
+
+   server.start([&received](ev9::socket& connection, std::size_t)
+   {
+      std::vector<char> buffer(256 * 1024);
+
+      std::size_t amount_read;
+
+      while ((amount_read = connection.read(&buffer[0], buffer.size())) != 0)
+      {
+         received += amount_read;
+      }
+   });
+
+   auto start = ev9::bench::clock::now();
+
+   run_clients(streams, [&address]()
+   {
+      ev9::socket client(address, port);
+
+      client.connect(5);
+
+      std::vector<char> payload(128 * 1024, 's');
+
+      for (std::size_t sent = 0; sent < stream_bytes; )
+      {
+         sent += client.write(&payload[0], payload.size() < stream_bytes - sent ? payload.size() : stream_bytes - sent);
+      }
+   });
+
+   while (received < streams * stream_bytes)
+   {
+      std::this_thread::yield();
+   }
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   server.stop();
+
+   return ev9::bench::gbits(streams * stream_bytes, seconds);
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::sharded_accept()
+{
+   std::printf("%8s %20s %20s\n", "workers", "accepts/s", "stream Gbit/s");
+
+   for (std::size_t workers = 1; workers <= 8; workers *= 2)
+   {
+      ev9::benchmark::result accepts = ev9::bench::repeat([workers]() { return accept_rate(workers); });
+      ev9::benchmark::result gbits = ev9::bench::repeat([workers]() { return stream_rate(workers); });
+
+      std::printf("%8lu %20s %20s\n", (unsigned long)workers, ev9::bench::cell(accepts, 0).c_str(), ev9::bench::cell(gbits, 3).c_str());
+   }
+
+   std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of server_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
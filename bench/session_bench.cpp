@@ -0,0 +1,357 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: session_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// What a session costs served by coroutines on one async_loop thread
+// (async.hpp) against one blocking thread per connection. A child process
+// opens 1000 loopback connections and runs 100 round trips of 64 bytes on
+// each, holding every connection open until all are done. Once every
+// session has echoed once, the server samples its resident and virtual
+// memory; the context switches are those of the server process over the
+// whole run. Each cell is the mean over 5 runs after a warmup one. Every
+// run serves from a fresh process, as memory an earlier run freed would
+// otherwise hide what the sessions cost.
+//
+// Coroutines need C++20: make bench STD=c++20.
+//
+// Requirements: c++11, Linux
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "async.hpp"
+#include "socket.hpp"
+
+#include <cstdio>
+
+#if __cplusplus >= 202002L && __linux__
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#if __cplusplus >= 202002L && __linux__
+
+namespace {
+
+const std::size_t port = 7133;
+
+const std::size_t sessions = 1000;
+const std::size_t round_trips = 100;
+const std::size_t message = 64;
+
+struct memory_sample
+{
+   std::size_t virtual_bytes;
+   std::size_t resident_bytes;
+};
+
+memory_sample sample_memory()
+{
+   std::ifstream statm("/proc/self/statm");
+
+   std::size_t size = 0;
+   std::size_t resident = 0;
+
+   statm >> size >> resident;
+
+   std::size_t page = (std::size_t)::sysconf(_SC_PAGESIZE);
+
+   memory_sample res = { size * page, resident * page };
+
+   return res;
+}
+
+// Sampled by whichever session echoes its first message last
+struct server_state
+{
+   std::atomic<std::size_t> echoed;
+
+   memory_sample peak;
+};
+
+void first_echo(server_state& state)
+{
+   if (++state.echoed == sessions) state.peak = sample_memory();
+}
+
+long context_switches()
+{
+   rusage usage;
+
+   ::getrusage(RUSAGE_SELF, &usage);
+
+   return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+ev9::task<> client(ev9::async_loop& loop, ev9::socket& connection)
+{
+   ev9::async_stream stream = co_await ev9::async_connect(loop, connection);
+
+   char request[message] = { 0 };
+   char reply[message];
+
+   for (std::size_t trip = 0; trip < round_trips; ++trip)
+   {
+      co_await stream.async_write(request, sizeof(request));
+
+      std::size_t amount_read = co_await stream.async_read_all(reply, sizeof(reply));
+
+      if (amount_read != sizeof(reply)) break;
+   }
+}
+
+// The child: every client on one loop, connections closed on exit
+void run_clients(ev9::socket& listener)
+{
+   listener.close();
+
+   ev9::async_loop loop;
+
+   std::vector<std::unique_ptr<ev9::socket> > connections;
+
+   for (std::size_t index = 0; index < sessions; ++index)
+   {
+      connections.push_back(std::unique_ptr<ev9::socket>(new ev9::socket("127.0.0.1", port)));
+
+      loop.spawn(client(loop, *connections.back()));
+   }
+
+   loop.run();
+
+   ::_exit(0);
+}
+
+ev9::task<> coroutine_session(ev9::async_stream stream, server_state& state)
+{
+   char buffer[message];
+
+   bool first = true;
+
+   while (true)
+   {
+      std::size_t amount_read = co_await stream.async_read_all(buffer, sizeof(buffer));
+
+      if (amount_read == 0) break;
+
+      co_await stream.async_write(buffer, amount_read);
+
+      if (first) first_echo(state);
+
+      first = false;
+   }
+}
+
+ev9::task<> acceptor(ev9::async_loop& loop, ev9::socket& listener, server_state& state)
+{
+   for (std::size_t index = 0; index < sessions; ++index)
+   {
+      ev9::async_stream stream = co_await ev9::async_accept(loop, listener);
+
+      loop.spawn(coroutine_session(std::move(stream), state));
+   }
+}
+
+void serve_coroutines(ev9::socket& listener, server_state& state)
+{
+   ev9::async_loop loop;
+
+   loop.spawn(acceptor(loop, listener, state));
+   loop.run();
+
+   loop.forget(listener.native_handle());
+}
+
+std::size_t read_all(int fd, char* buffer, std::size_t size)
+{
+   std::size_t total = 0;
+
+   while (total < size)
+   {
+      ssize_t amount_read = ::read(fd, buffer + total, size - total);
+
+      if (amount_read <= 0) break;
+
+      total += (std::size_t)amount_read;
+   }
+
+   return total;
+}
+
+void thread_session(int fd, server_state& state)
+{
+   char buffer[message];
+
+   bool first = true;
+
+   while (read_all(fd, buffer, sizeof(buffer)) == sizeof(buffer))
+   {
+      if (::send(fd, buffer, sizeof(buffer), MSG_NOSIGNAL) != (ssize_t)sizeof(buffer)) break;
+
+      if (first) first_echo(state);
+
+      first = false;
+   }
+
+   ::close(fd);
+}
+
+void serve_threads(ev9::socket& listener, server_state& state)
+{
+   listener.set_non_blocking(false);
+
+   std::vector<std::thread> threads;
+
+   for (std::size_t index = 0; index < sessions; ++index)
+   {
+      int fd = ::accept(listener.native_handle(), nullptr, nullptr);
+
+      if (fd < 0) throw std::runtime_error("Unable to accept a connection");
+
+      threads.push_back(std::thread(thread_session, fd, std::ref(state)));
+   }
+
+   for (std::thread& thread : threads)
+   {
+      thread.join();
+   }
+}
+
+void serve(bool coroutines, double* figures)
+{
+   ev9::socket listener(port);
+
+   listener.bind();
+   listener.listen();
+
+   server_state state;
+
+   state.echoed = 0;
+   state.peak = memory_sample();
+
+   memory_sample before = sample_memory();
+   long switches = context_switches();
+
+   auto start = ev9::bench::clock::now();
+
+   pid_t child = ::fork();
+
+   if (child < 0) throw std::runtime_error("Unable to fork the clients");
+
+   if (child == 0) run_clients(listener);
+
+   if (coroutines) serve_coroutines(listener, state);
+   else serve_threads(listener, state);
+
+   int status = 0;
+
+   ::waitpid(child, &status, 0);
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   switches = context_switches() - switches;
+
+   figures[0] = ((double)state.peak.resident_bytes - (double)before.resident_bytes) / sessions / 1024;
+   figures[1] = ((double)state.peak.virtual_bytes - (double)before.virtual_bytes) / sessions / 1024;
+   figures[2] = (double)switches / (sessions * round_trips);
+   figures[3] = sessions * round_trips / seconds;
+}
+
+// RSS and virtual KiB per session, context switches per round trip and
+// round trips per second
+void measure(bool coroutines, double* figures)
+{
+   int results[2];
+
+   if (::pipe(results) != 0) throw std::runtime_error("Unable to create a pipe for the server's figures");
+
+   pid_t server = ::fork();
+
+   if (server < 0) throw std::runtime_error("Unable to fork the server");
+
+   if (server == 0)
+   {
+      ::close(results[0]);
+
+      double served[4] = { 0 };
+
+      serve(coroutines, served);
+
+      ssize_t written = ::write(results[1], served, sizeof(served));
+
+      ::_exit(written == (ssize_t)sizeof(served) ? 0 : 1);
+   }
+
+   ::close(results[1]);
+
+   ssize_t amount_read = ::read(results[0], figures, 4 * sizeof(double));
+
+   ::close(results[0]);
+
+   int status = 0;
+
+   ::waitpid(server, &status, 0);
+
+   if (amount_read != (ssize_t)(4 * sizeof(double)) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+   {
+      throw std::runtime_error("The server process did not report its figures");
+   }
+}
+
+void row(const char* const label, bool coroutines)
+{
+   std::vector<ev9::benchmark::result> figures = ev9::bench::repeat(4, [coroutines](double* figures) { measure(coroutines, figures); });
+
+   std::printf("%12s %18s %18s %18s %22s\n",
+               label,
+               ev9::bench::cell(figures[0], 1).c_str(),
+               ev9::bench::cell(figures[1], 1).c_str(),
+               ev9::bench::cell(figures[2], 3).c_str(),
+               ev9::bench::cell(figures[3], 0).c_str());
+}
+
+} // end of anonymous namespace
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::session_models()
+{
+   #if __cplusplus >= 202002L && __linux__
+      std::printf("%lu sessions, %lu round trips of %lu bytes each, server side\n", (unsigned long)sessions, (unsigned long)round_trips, (unsigned long)message);
+      std::printf("%12s %18s %18s %18s %22s\n", "model", "RSS KiB/sess", "virt KiB/sess", "switches/trip", "trips/s");
+
+      row("coroutines", true);
+      row("threads", false);
+   #else
+      std::printf("needs C++20 coroutines on Linux: make bench STD=c++20\n");
+   #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of session_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
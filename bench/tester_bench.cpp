@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: tester_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Wall time of ev9::tester on skewed test durations against the contiguous
+// range partitioning it used to do. The slow tests are registered first,
+// the way a suite's socket tests with sleeps tend to be, so a static split
+// hands them all to the first workers. Tests sleep rather than spin so the
+// result does not depend on the core count.
+//
+// The pool benchmark measures the fixed cost of a run: a batch of empty
+// tests on a tester created for that run, which starts and joins its
+// threads, against the same batch on one tester whose workers stay parked
+// between runs.
+//
+// The scaling benchmark registers a million trivial tests and runs them on
+// 1 to 64 threads, reporting the heap the registered tests take and the
+// time spent adding them, running them and releasing them.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "test.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if __GLIBC__
+   #include <malloc.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t threads = 4;
+const std::size_t tests = 64;
+
+void pause(std::size_t milliseconds)
+{
+   std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+// Durations in milliseconds, the slow_count slow ones first
+std::vector<std::size_t> durations(std::size_t slow_count, std::size_t slow, std::size_t fast)
+{
+   std::vector<std::size_t> result(tests, fast);
+
+   for (std::size_t index = 0; index < slow_count; ++index)
+   {
+      result[index] = slow;
+   }
+
+   return result;
+}
+
+// The old scheduler: one contiguous slice of the list per thread
+double run_partitioned(const std::vector<std::size_t>& work)
+{
+   auto start = ev9::bench::clock::now();
+
+   std::vector<std::thread> workers;
+
+   std::size_t slice = work.size() / threads;
+   std::size_t remainder = work.size() % threads;
+   std::size_t begin = 0;
+
+   for (std::size_t index = 0; index < threads; ++index)
+   {
+      std::size_t end = begin + slice + (index < remainder ? 1 : 0);
+
+      workers.push_back(std::thread([&work, begin, end]()
+      {
+         for (std::size_t test = begin; test < end; ++test) pause(work[test]);
+      }));
+
+      begin = end;
+   }
+
+   for (std::thread& worker : workers)
+   {
+      worker.join();
+   }
+
+   return ev9::bench::seconds_since(start);
+}
+
+double run_tester(const std::vector<std::size_t>& work)
+{
+   auto start = ev9::bench::clock::now();
+
+   {
+      ev9::test suite(threads);
+
+      for (std::size_t milliseconds : work)
+      {
+         suite.add_test(std::bind(pause, milliseconds));
+      }
+
+      // Tests run and report when the suite goes out of scope
+   }
+
+   return ev9::bench::seconds_since(start);
+}
+
+// Fixed cost per run of a batch of empty tests, in microseconds, with a
+// tester created for each run
+double run_spawned(std::size_t runs)
+{
+   auto start = ev9::bench::clock::now();
+
+   for (std::size_t run = 0; run < runs; ++run)
+   {
+      ev9::tester fresh(threads);
+
+      for (std::size_t index = 0; index < threads; ++index) fresh.run([]() { });
+
+      fresh.run_tests(false);
+   }
+
+   return ev9::bench::seconds_since(start) / runs * 1e6;
+}
+
+// The same with one tester, its workers parked between runs
+double run_parked(std::size_t runs)
+{
+   ev9::tester pool(threads);
+
+   auto start = ev9::bench::clock::now();
+
+   for (std::size_t run = 0; run < runs; ++run)
+   {
+      for (std::size_t index = 0; index < threads; ++index) pool.run([]() { });
+
+      pool.run_tests(false);
+   }
+
+   return ev9::bench::seconds_since(start) / runs * 1e6;
+}
+
+// Bytes in use on the heap, 0 where the allocator cannot say
+std::size_t heap_in_use()
+{
+   #if __GLIBC__ && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+      struct mallinfo2 info = mallinfo2();
+
+      // Large blocks are mapped separately from the arena
+      return info.uordblks + info.hblkhd;
+   #else
+      return 0;
+   #endif
+}
+
+void trivial()
+{
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::tester_scheduling()
+{
+   struct shape
+   {
+      const char* name;
+      std::size_t slow_count;
+      std::size_t slow;
+      std::size_t fast;
+   };
+
+   const shape shapes[] =
+   {
+      { "uniform", 0, 5, 5 },
+      { "8 slow", 8, 40, 2 },
+      { "1 slow", 1, 100, 2 },
+   };
+
+   std::vector<double> partitioned;
+   std::vector<double> stealing;
+   std::vector<double> ideal;
+
+   for (const shape& current : shapes)
+   {
+      std::vector<std::size_t> work = durations(current.slow_count, current.slow, current.fast);
+
+      std::size_t total = 0;
+      std::size_t longest = 0;
+
+      for (std::size_t milliseconds : work)
+      {
+         total += milliseconds;
+
+         if (milliseconds > longest) longest = milliseconds;
+      }
+
+      // No schedule beats total / threads or the single longest test
+      double bound = (double)total / threads > longest ? (double)total / threads : longest;
+
+      ideal.push_back(bound / 1000.0);
+      partitioned.push_back(run_partitioned(work));
+      stealing.push_back(run_tester(work));
+   }
+
+   std::printf("%lu tests on %lu threads\n", (unsigned long)tests, (unsigned long)threads);
+   std::printf("%10s %12s %12s %12s %10s\n", "shape", "ideal ms", "static ms", "stealing ms", "speedup");
+
+   for (std::size_t index = 0; index < ideal.size(); ++index)
+   {
+      std::printf("%10s %12.1f %12.1f %12.1f %9.2fx\n",
+                  shapes[index].name,
+                  ideal[index] * 1e3,
+                  partitioned[index] * 1e3,
+                  stealing[index] * 1e3,
+                  partitioned[index] / stealing[index]);
+   }
+}
+
+void ev9::bench::tester_pool()
+{
+   const std::size_t runs = 2000;
+
+   double spawned = run_spawned(runs);
+   double parked = run_parked(runs);
+
+   std::printf("%lu runs of %lu empty tests on %lu threads\n", (unsigned long)runs, (unsigned long)threads, (unsigned long)threads);
+   std::printf("%22s %12s\n", "", "us per run");
+   std::printf("%22s %12.1f\n", "threads per run", spawned);
+   std::printf("%22s %12.1f\n", "persistent pool", parked);
+   std::printf("%22s %11.2fx\n", "speedup", spawned / parked);
+}
+
+void ev9::bench::tester_scaling()
+{
+   const std::size_t count = 1000000;
+   const std::size_t thread_counts[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+   std::printf("%lu trivial tests\n", (unsigned long)count);
+   std::printf("%8s %12s %12s %12s %12s %14s\n", "threads", "add ms", "run ms", "release ms", "heap MiB", "heap B/test");
+
+   for (std::size_t threads : thread_counts)
+   {
+      std::unique_ptr<ev9::tester> suite(new ev9::tester(threads));
+
+      std::size_t heap_before = heap_in_use();
+
+      auto start = ev9::bench::clock::now();
+
+      suite->reserve(count);
+
+      for (std::size_t index = 0; index < count; ++index)
+      {
+         suite->run(trivial);
+      }
+
+      double add = ev9::bench::seconds_since(start);
+
+      std::size_t heap = heap_in_use() - heap_before;
+
+      start = ev9::bench::clock::now();
+
+      suite->run_tests(false);
+
+      double run = ev9::bench::seconds_since(start);
+
+      start = ev9::bench::clock::now();
+
+      suite.reset();
+
+      double release = ev9::bench::seconds_since(start);
+
+      std::printf("%8lu %12.1f %12.1f %12.1f %12.1f %14.1f\n",
+                  (unsigned long)threads,
+                  add * 1e3,
+                  run * 1e3,
+                  release * 1e3,
+                  heap / 1048576.0,
+                  (double)heap / count);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of tester_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: transport_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// The same 256 MiB copy stream and 64 byte ping-pong over TCP loopback,
+// AF_UNIX stream and seqpacket sockets, and the shared memory rings. Each
+// transport gets its own pair of ports. Throughput and p50 are the mean
+// over 5 runs; p99 and p99.9 come from the round trips of all of them.
+//
+// Requirements: c++11, Linux
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "bandwidth.hpp"
+#include "latency.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7123;
+
+const std::size_t stream_bytes = 256 * 1024 * 1024;
+const std::size_t round_trips = 20000;
+
+ev9::bandwidth::result stream_rate(ev9::transport_kind kind, std::size_t stream_port)
+{
+   ev9::bandwidth receiver(stream_port);
+   ev9::bandwidth sender(stream_port);
+
+   receiver.set_transport(kind);
+   sender.set_transport(kind);
+   sender.set_byte_count(stream_bytes);
+
+   receiver.listen();
+
+   std::thread receiving_thread([&]() { receiver.receive(); });
+
+   ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+   receiving_thread.join();
+
+   return sent;
+}
+
+ev9::histogram round_trip(ev9::transport_kind kind, std::size_t ping_port)
+{
+   ev9::latency server(ping_port);
+   ev9::latency client(ping_port, 64);
+
+   server.set_transport(kind);
+   client.set_transport(kind);
+   client.set_iterations(round_trips);
+
+   server.listen();
+
+   std::thread serving_thread([&]() { server.serve(); });
+
+   ev9::histogram samples = client.ping("127.0.0.1");
+
+   serving_thread.join();
+
+   return samples;
+}
+
+} // end of namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::transport_comparison()
+{
+   const ev9::transport_kind kinds[] = { ev9::transport_tcp, ev9::transport_unix, ev9::transport_unix_datagram, ev9::transport_shm };
+
+   std::printf("%lu MiB streams, %lu round trips of 64 bytes\n", (unsigned long)(stream_bytes >> 20), (unsigned long)round_trips);
+   std::printf("%14s %20s %20s %18s %10s %10s\n", "transport", "Gbit/s", "cycles/byte", "p50 us", "p99 us", "p99.9 us");
+
+   for (std::size_t index = 0; index < sizeof(kinds) / sizeof(kinds[0]); ++index)
+   {
+      std::vector<ev9::benchmark::result> sent = ev9::bench::repeat(2, [&](double* figures)
+      {
+         ev9::bandwidth::result res = stream_rate(kinds[index], port + 2 * index);
+
+         figures[0] = res.gbits();
+         figures[1] = res.cycles_per_byte();
+      });
+
+      // Every ping run discards its own warmup round trips
+      std::unique_ptr<ev9::histogram> all;
+
+      ev9::benchmark::result median = ev9::bench::repeat([&]()
+      {
+         ev9::histogram samples = round_trip(kinds[index], port + 2 * index + 1);
+
+         if (all) all->merge(samples);
+         else all.reset(new ev9::histogram(samples));
+
+         return samples.percentile(50) / 1e3;
+
+      }, 5, 0);
+
+      std::printf("%14s %20s %20s %18s %10.2f %10.2f\n",
+                  ev9::transport_kind_name(kinds[index]),
+                  ev9::bench::cell(sent[0], 3).c_str(),
+                  ev9::bench::cell(sent[1], 3).c_str(),
+                  ev9::bench::cell(median, 2).c_str(),
+                  all->percentile(99) / 1e3,
+                  all->percentile(99.9) / 1e3);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of transport_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: vector_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Small-message send rate over loopback. Every message is an 8 byte length
+// header plus a 64 B to 1 KiB body. The two-write column sends header and
+// body with separate write() calls, the batch columns gather that many
+// messages into one vectored write.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "socket.hpp"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7101;
+const std::size_t messages = 100000;
+
+void drain(ev9::socket* server)
+{
+   server->accept();
+
+   std::vector<char> buffer(256 * 1024);
+
+   while (server->read(&buffer[0], buffer.size()) != 0) { }
+
+   server->close_accepted();
+}
+
+// Messages per second; batch 0 means separate header and body writes
+double measure(std::size_t body_size, std::size_t batch, std::size_t& syscalls)
+{
+   ev9::socket server(port);
+
+   server.bind();
+   server.listen();
+
+   std::thread receiver(drain, &server);
+
+   double rate = 0;
+
+   {
+      ev9::socket client(port);
+
+      client.connect();
+
+      unsigned long long header = body_size;
+
+      std::vector<char> body(body_size, 'm');
+
+      std::size_t per_call = batch ? batch : 1;
+
+      std::vector<ev9::socket::segment> segments(per_call * 2);
+
+      for (std::size_t index = 0; index < per_call; ++index)
+      {
+         segments[index * 2].iov_base = &header;
+         segments[index * 2].iov_len = sizeof(header);
+         segments[index * 2 + 1].iov_base = &body[0];
+         segments[index * 2 + 1].iov_len = body.size();
+      }
+
+      syscalls = 0;
+
+      auto start = ev9::bench::clock::now();
+
+      for (std::size_t sent = 0; sent < messages; sent += per_call)
+      {
+         if (batch == 0)
+         {
+            client.write((const char*)&header, sizeof(header));
+            client.write(&body[0], body.size());
+
+            syscalls += 2;
+         }
+
+         else
+         {
+            client.write(segments);
+         }
+      }
+
+      if (batch) syscalls = client.vector_calls();
+
+      rate = messages / ev9::bench::seconds_since(start);
+   }
+
+   receiver.join();
+
+   return rate;
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::scatter_gather()
+{
+   const std::size_t batches[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+   std::printf("%8s %8s %14s %14s %10s\n", "body", "batch", "messages/s", "syscalls/msg", "speedup");
+
+   for (std::size_t body_size = 64; body_size <= 1024; body_size *= 4)
+   {
+      std::size_t syscalls = 0;
+
+      double baseline = measure(body_size, 0, syscalls);
+
+      std::printf("%7luB %8s %14.0f %14.3f %9.2fx\n", (unsigned long)body_size, "2-write", baseline, (double)syscalls / messages, 1.0);
+
+      for (std::size_t batch : batches)
+      {
+         double rate = measure(body_size, batch, syscalls);
+
+         std::printf("%7luB %8lu %14.0f %14.3f %9.2fx\n", (unsigned long)body_size, (unsigned long)batch, rate, (double)syscalls / messages, rate / baseline);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of vector_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: writer_bench.cpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Loopback send rate for 16 to 512 byte messages. The direct column makes
+// one socket::write per message, the buffered column goes through a
+// buffered_writer with the default 64 KiB threshold. The clock stops once
+// the receiver has drained every byte. Each cell is the mean over 5 runs
+// of 200000 messages.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bench.hpp"
+#include "socket.hpp"
+#include "writer.hpp"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const std::size_t port = 7104;
+
+void drain(ev9::socket* server)
+{
+   server->accept();
+
+   std::vector<char> buffer(256 * 1024);
+
+   while (server->read(&buffer[0], buffer.size()) != 0)
+   {
+   }
+}
+
+double measure(std::size_t message_size, std::size_t count, bool buffered, double* per_syscall)
+{
+   ev9::socket server(port);
+
+   server.bind();
+   server.listen();
+
+   std::thread receiver(drain, &server);
+
+   std::vector<char> message(message_size, 'm');
+
+   auto start = ev9::bench::clock::now();
+
+   {
+      ev9::socket client(port);
+
+      client.connect();
+
+      if (buffered)
+      {
+         ev9::buffered_writer writer(client);
+
+         for (std::size_t index = 0; index < count; ++index)
+         {
+            writer.write(&message[0], message_size);
+         }
+
+         writer.flush();
+
+         *per_syscall = writer.writes_per_syscall();
+      }
+
+      else
+      {
+         for (std::size_t index = 0; index < count; ++index)
+         {
+            for (std::size_t sent = 0; sent < message_size; )
+            {
+               sent += client.write(&message[sent], message_size - sent);
+            }
+         }
+      }
+   }
+
+   receiver.join();
+
+   double seconds = ev9::bench::seconds_since(start);
+
+   return seconds > 0 ? count / seconds / 1e6 : 0;
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ev9::bench::write_coalescing()
+{
+   const std::size_t count = 200000;
+
+   std::printf("%10s %20s %20s %8s %18s\n", "message", "direct Mmsg/s", "buffered Mmsg/s", "speedup", "writes per syscall");
+
+   for (std::size_t message_size = 16; message_size <= 512; message_size *= 2)
+   {
+      double per_syscall = 0;
+
+      ev9::benchmark::result direct = ev9::bench::repeat([&]() { return measure(message_size, count, false, &per_syscall); });
+      ev9::benchmark::result buffered = ev9::bench::repeat([&]() { return measure(message_size, count, true, &per_syscall); });
+
+      std::printf("%10lu %20s %20s %7.1fx %18.1f\n", (unsigned long)message_size, ev9::bench::cell(direct, 3).c_str(), ev9::bench::cell(buffered, 3).c_str(), ev9::bench::ratio(buffered, direct), per_syscall);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// end of writer_bench.cpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,795 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: async.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// C++20 coroutines over ev9::socket, so one thread can serve thousands of
+// connections without a thread, or a stack, per connection.
+//
+//    ev9::task<> session(ev9::async_stream stream)
+//    {
+//       char buffer[4096];
+//
+//       std::size_t amount_read;
+//
+//       while ((amount_read = co_await stream.async_read(buffer, sizeof(buffer))) != 0)
+//       {
+//          co_await stream.async_write(buffer, amount_read);
+//       }
+//    }
+//
+//    loop.spawn(session(co_await ev9::async_accept(loop, listener)));
+//
+// async_loop is a single threaded epoll readiness loop. Each operation
+// first tries the system call on a non-blocking descriptor and only when
+// the kernel says it would block does the coroutine suspend, until epoll
+// reports the descriptor ready (edge-triggered) and the loop resumes it
+// to try again. A suspended coroutine costs its frame: the locals it
+// keeps across a co_await, nothing more.
+//
+// task<T> is a lazily started coroutine returning T. co_await runs it and
+// resumes the awaiting coroutine when it finishes, without going back
+// through the loop; spawn() starts one detached, owned by the loop, which
+// rethrows from run_once() anything it failed with.
+//
+// GCC 12 miscompiles co_await of a task inside an if condition (the
+// program hits ud2 at run time); await into a local and test that.
+//
+// At most one coroutine can wait to read and one to write each
+// descriptor. A descriptor the loop has waited on must be forgotten
+// before it is closed while the loop lives on; async_stream does that for
+// its own, listeners passed to async_accept need forget().
+//
+// Requirements: c++20, Linux (epoll)
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ASYNC_HPP__
+#define __ASYNC_HPP__
+
+#if __cplusplus >= 202002L && __linux__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "socket.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <coroutine>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename value_type = void> class task;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class async_loop
+{
+   public:  // Inner Classes
+
+      // co_await loop.readable(fd) suspends until epoll reports fd ready
+      class readiness
+      {
+         public:  // Constructor
+
+            readiness(async_loop* loop, int fd, bool write) : _m_loop(loop), _m_fd(fd), _m_write(write) { }
+
+         public:  // Awaitable
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> waiting) { _m_loop->_wait(_m_fd, _m_write, waiting); }
+            void await_resume() const noexcept { }
+
+         private: // Member Variables
+
+            async_loop* _m_loop;
+            int _m_fd;
+            bool _m_write;
+
+      }; // end of class(readiness)
+
+   public:  // Constructor | Destructor
+
+      async_loop(std::size_t max_events = 256) { _ctor(max_events); }
+      ~async_loop() { _dtor(); }
+
+   private: // Owns the epoll descriptor and spawned frames, not copyable
+
+      async_loop(const async_loop&);
+      async_loop& operator=(const async_loop&);
+
+   public:  // Public Member Functions
+
+      // Runs work now, up to its first suspension, and keeps it until it
+      // finishes
+      void spawn(task<void> work);
+
+      readiness readable(int fd) { return readiness(this, fd, false); }
+      readiness writable(int fd) { return readiness(this, fd, true); }
+
+      // Drops fd from epoll; call it before closing a descriptor this loop
+      // has waited on
+      void forget(int fd) { _forget(fd); }
+
+      // Waits up to timeout (-1 for ever) and resumes whatever is ready;
+      // returns the number of events
+      std::size_t run_once(int timeout_milliseconds = -1) { return _run_once(timeout_milliseconds); }
+
+      // Until every spawned task has finished or stop() is called
+      void run() { _run(); }
+
+      // From any thread
+      void stop() { _stop(); }
+
+      std::size_t tasks() const { return _m_spawned.size(); }
+      std::size_t wakeups() const { return _m_wakeups; }
+      std::size_t events() const { return _m_events; }
+
+   private: // Private Inner Class
+
+      // What an epoll event's data pointer refers to
+      class entry
+      {
+         public:  // Constructor
+
+            entry(int descriptor) : fd(descriptor), retired(false) { }
+
+         public:  // Member Variables
+
+            int fd;
+
+            std::coroutine_handle<> reader;
+            std::coroutine_handle<> writer;
+
+            bool retired;
+
+      }; // end of class(entry)
+
+   private: // Private Member Functions
+
+      template <typename value_type> friend class task;
+
+      void _ctor(std::size_t max_events)
+      {
+         _m_stopped = false;
+         _m_wakeups = 0;
+         _m_events = 0;
+
+         _m_ready.resize(max_events ? max_events : 1);
+
+         _m_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+
+         if (_m_epoll_fd < 0)
+         {
+            throw std::runtime_error("Unable to create the epoll instance");
+         }
+
+         // stop() writes here so a blocked epoll_wait returns
+         _m_wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+         if (_m_wake_fd < 0)
+         {
+            ::close(_m_epoll_fd);
+
+            throw std::runtime_error("Unable to create the loop's eventfd");
+         }
+
+         epoll_event event;
+
+         event.events = EPOLLIN;
+         event.data.ptr = nullptr;
+
+         ::epoll_ctl(_m_epoll_fd, EPOLL_CTL_ADD, _m_wake_fd, &event);
+      }
+
+      void _dtor()
+      {
+         // Frames first: their streams forget their descriptors here
+         while (!_m_spawned.empty())
+         {
+            void* frame = *_m_spawned.begin();
+
+            _m_spawned.erase(_m_spawned.begin());
+
+            std::coroutine_handle<>::from_address(frame).destroy();
+         }
+
+         for (auto& watched : _m_watched)
+         {
+            delete watched.second;
+         }
+
+         _collect_retired();
+
+         ::close(_m_wake_fd);
+         ::close(_m_epoll_fd);
+      }
+
+      void _spawned(std::coroutine_handle<> frame)
+      {
+         _m_spawned.insert(frame.address());
+      }
+
+      // A spawned frame has finished and destroyed itself
+      void _finished(std::coroutine_handle<> frame, std::exception_ptr error)
+      {
+         _m_spawned.erase(frame.address());
+
+         if (error && !_m_error) _m_error = error;
+      }
+
+      void _wait(int fd, bool write, std::coroutine_handle<> waiting)
+      {
+         auto found = _m_watched.find(fd);
+
+         entry* current = found != _m_watched.end() ? found->second : _watch(fd);
+
+         std::coroutine_handle<>& slot = write ? current->writer : current->reader;
+
+         if (slot)
+         {
+            throw std::runtime_error(std::string("Two coroutines waiting to ") + (write ? "write" : "read") + " the same descriptor");
+         }
+
+         slot = waiting;
+      }
+
+      entry* _watch(int fd)
+      {
+         entry* current = new entry(fd);
+
+         epoll_event event;
+
+         // Data that arrived before registration still raises an edge
+         event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+         event.data.ptr = current;
+
+         if (::epoll_ctl(_m_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+         {
+            delete current;
+
+            throw std::runtime_error("Unable to register the descriptor with epoll");
+         }
+
+         _m_watched[fd] = current;
+
+         return current;
+      }
+
+      void _forget(int fd)
+      {
+         auto found = _m_watched.find(fd);
+
+         if (found == _m_watched.end()) return;
+
+         ::epoll_ctl(_m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+
+         // Deleted after the current batch; later events in it may still
+         // point at this entry
+         found->second->retired = true;
+
+         _m_retired.push_back(found->second);
+         _m_watched.erase(found);
+      }
+
+      void _collect_retired()
+      {
+         for (entry* current : _m_retired)
+         {
+            delete current;
+         }
+
+         _m_retired.clear();
+      }
+
+      void _dispatch(entry& current, unsigned int events)
+      {
+         if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && current.reader)
+         {
+            std::coroutine_handle<> reader = current.reader;
+
+            current.reader = nullptr;
+
+            reader.resume();
+         }
+
+         if ((events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) && !current.retired && current.writer)
+         {
+            std::coroutine_handle<> writer = current.writer;
+
+            current.writer = nullptr;
+
+            writer.resume();
+         }
+      }
+
+      std::size_t _run_once(int timeout_milliseconds)
+      {
+         int count = ::epoll_wait(_m_epoll_fd, &_m_ready[0], (int)_m_ready.size(), timeout_milliseconds);
+
+         if (count < 0)
+         {
+            if (errno == EINTR) return 0;
+
+            throw std::runtime_error("Error waiting on epoll");
+         }
+
+         ++_m_wakeups;
+
+         _m_events += (std::size_t)count;
+
+         for (int index = 0; index < count; ++index)
+         {
+            entry* current = (entry*)_m_ready[index].data.ptr;
+
+            if (current == nullptr)
+            {
+               unsigned long long value;
+
+               while (::read(_m_wake_fd, &value, sizeof(value)) > 0) { }
+
+               continue;
+            }
+
+            if (current->retired) continue;
+
+            _dispatch(*current, _m_ready[index].events);
+         }
+
+         _collect_retired();
+
+         if (_m_error)
+         {
+            std::exception_ptr error = _m_error;
+
+            _m_error = nullptr;
+
+            std::rethrow_exception(error);
+         }
+
+         return (std::size_t)count;
+      }
+
+      void _run()
+      {
+         while (!_m_spawned.empty() && !_m_stopped.load())
+         {
+            _run_once(-1);
+         }
+
+         _m_stopped = false;
+      }
+
+      void _stop()
+      {
+         _m_stopped = true;
+
+         unsigned long long value = 1;
+
+         if (::write(_m_wake_fd, &value, sizeof(value)) < 0)
+         {
+            // Counter saturated; a wakeup is already pending
+         }
+      }
+
+   private: // Member Variables
+
+      int _m_epoll_fd;
+      int _m_wake_fd;
+
+      std::atomic<bool> _m_stopped;
+
+      std::size_t _m_wakeups;
+      std::size_t _m_events;
+
+      std::vector<epoll_event> _m_ready;
+
+      std::unordered_map<int, entry*> _m_watched;
+      std::vector<entry*> _m_retired;
+
+      // Frame addresses of spawned tasks still running
+      std::unordered_set<void*> _m_spawned;
+      std::exception_ptr _m_error;
+
+}; // end of class(async_loop)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Where a finished task keeps what it returned
+template <typename value_type>
+class task_result
+{
+   public:  // Public Member Functions
+
+      template <typename from_type> void return_value(from_type&& value) { _m_value.emplace(std::forward<from_type>(value)); }
+
+      value_type take() { return std::move(*_m_value); }
+
+   private: // Member Variables
+
+      std::optional<value_type> _m_value;
+
+}; // end of class(task_result)
+
+template <>
+class task_result<void>
+{
+   public:  // Public Member Functions
+
+      void return_void() { }
+
+      void take() { }
+
+}; // end of class(task_result<void>)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename value_type>
+class task
+{
+   public:  // Inner Classes
+
+      class promise_type : public task_result<value_type>
+      {
+         public:  // Inner Classes
+
+            class final_awaiter
+            {
+               public:  // Awaitable
+
+                  bool await_ready() const noexcept { return false; }
+                  std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept { return self.promise()._finish(self); }
+                  void await_resume() const noexcept { }
+
+            }; // end of class(final_awaiter)
+
+         public:  // Constructor
+
+            promise_type() : loop(nullptr) { }
+
+         public:  // Coroutine Hooks
+
+            task get_return_object() { return task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+            std::suspend_always initial_suspend() const noexcept { return std::suspend_always(); }
+            final_awaiter final_suspend() const noexcept { return final_awaiter(); }
+
+            void unhandled_exception() { error = std::current_exception(); }
+
+         public:  // Member Variables
+
+            // Resumed when this task finishes, if something awaits it
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+
+            // Set by spawn(); the loop then owns the frame
+            async_loop* loop;
+
+         private: // Private Member Functions
+
+            std::coroutine_handle<> _finish(std::coroutine_handle<promise_type> self) noexcept
+            {
+               if (continuation) return continuation;
+
+               if (loop != nullptr)
+               {
+                  async_loop* owner = loop;
+                  std::exception_ptr failure = error;
+
+                  self.destroy();
+
+                  owner->_finished(self, failure);
+               }
+
+               return std::noop_coroutine();
+            }
+
+      }; // end of class(promise_type)
+
+   public:  // Constructor | Destructor
+
+      task() : _m_handle(nullptr) { }
+      task(task&& other) noexcept : _m_handle(std::exchange(other._m_handle, nullptr)) { }
+      ~task() { if (_m_handle) _m_handle.destroy(); }
+
+      task& operator=(task&& other) noexcept
+      {
+         if (this != &other)
+         {
+            if (_m_handle) _m_handle.destroy();
+
+            _m_handle = std::exchange(other._m_handle, nullptr);
+         }
+
+         return *this;
+      }
+
+   private: // Owns the frame, not copyable
+
+      task(const task&);
+      task& operator=(const task&);
+
+   public:  // Awaitable
+
+      bool await_ready() const noexcept { return false; }
+
+      // Starts the task; it resumes the awaiting coroutine when done
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> waiting) noexcept
+      {
+         _m_handle.promise().continuation = waiting;
+
+         return _m_handle;
+      }
+
+      value_type await_resume()
+      {
+         if (_m_handle.promise().error) std::rethrow_exception(_m_handle.promise().error);
+
+         return _m_handle.promise().take();
+      }
+
+   private: // Private Member Functions
+
+      friend class async_loop;
+
+      explicit task(std::coroutine_handle<promise_type> handle) : _m_handle(handle) { }
+
+      std::coroutine_handle<promise_type> _release() { return std::exchange(_m_handle, nullptr); }
+
+   private: // Member Variables
+
+      std::coroutine_handle<promise_type> _m_handle;
+
+}; // end of class(task)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+inline void async_loop::spawn(task<void> work)
+{
+   std::coroutine_handle<task<void>::promise_type> frame = work._release();
+
+   if (!frame) return;
+
+   frame.promise().loop = this;
+
+   _spawned(frame);
+
+   frame.resume();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// A connected, non-blocking descriptor that coroutines read and write
+// through a loop
+class async_stream
+{
+   public:  // Constructor | Destructor
+
+      async_stream() : _m_loop(nullptr), _m_fd(-1), _m_owned(false) { }
+
+      // owned closes fd along with the stream; fd must be non-blocking
+      async_stream(async_loop& loop, int fd, bool owned) : _m_loop(&loop), _m_fd(fd), _m_owned(owned) { }
+
+      async_stream(async_stream&& other) noexcept : _m_loop(other._m_loop), _m_fd(std::exchange(other._m_fd, -1)), _m_owned(other._m_owned) { }
+      ~async_stream() { _close(); }
+
+      async_stream& operator=(async_stream&& other) noexcept
+      {
+         if (this != &other)
+         {
+            _close();
+
+            _m_loop = other._m_loop;
+            _m_fd = std::exchange(other._m_fd, -1);
+            _m_owned = other._m_owned;
+         }
+
+         return *this;
+      }
+
+   private: // Owns its registration, not copyable
+
+      async_stream(const async_stream&);
+      async_stream& operator=(const async_stream&);
+
+   public:  // Public Member Functions
+
+      // Up to size bytes, as soon as there are any; 0 at end of stream
+      task<std::size_t> async_read(char* buffer, std::size_t size) { return _read(buffer, size, false); }
+
+      // All size bytes, fewer only at end of stream
+      task<std::size_t> async_read_all(char* buffer, std::size_t size) { return _read(buffer, size, true); }
+
+      // All size bytes
+      task<std::size_t> async_write(const char* buffer, std::size_t size) { return _write(buffer, size); }
+
+      int fd() const { return _m_fd; }
+      bool is_open() const { return _m_fd >= 0; }
+
+      void close() { _close(); }
+
+   private: // Private Member Functions
+
+      void _close()
+      {
+         if (_m_fd < 0) return;
+
+         _m_loop->forget(_m_fd);
+
+         if (_m_owned) ::close(_m_fd);
+
+         _m_fd = -1;
+      }
+
+      task<std::size_t> _read(char* buffer, std::size_t size, bool all)
+      {
+         std::size_t total = 0;
+
+         while (total < size)
+         {
+            ssize_t amount_read = ::read(_m_fd, buffer + total, size - total);
+
+            if (amount_read > 0)
+            {
+               total += (std::size_t)amount_read;
+
+               if (!all) break;
+
+               continue;
+            }
+
+            if (amount_read == 0) break;
+
+            if (errno == EINTR) continue;
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+               throw std::runtime_error(std::string("Error reading the connection: ") + std::strerror(errno));
+            }
+
+            co_await _m_loop->readable(_m_fd);
+         }
+
+         co_return total;
+      }
+
+      task<std::size_t> _write(const char* buffer, std::size_t size)
+      {
+         std::size_t total = 0;
+
+         while (total < size)
+         {
+            ssize_t amount_written = ::send(_m_fd, buffer + total, size - total, MSG_NOSIGNAL);
+
+            if (amount_written >= 0)
+            {
+               total += (std::size_t)amount_written;
+
+               continue;
+            }
+
+            if (errno == EINTR) continue;
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+               throw std::runtime_error(std::string("Error writing the connection: ") + std::strerror(errno));
+            }
+
+            co_await _m_loop->writable(_m_fd);
+         }
+
+         co_return total;
+      }
+
+   private: // Member Variables
+
+      async_loop* _m_loop;
+
+      int _m_fd;
+      bool _m_owned;
+
+}; // end of class(async_stream)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// The next connection on a bound and listening socket, which is made
+// non-blocking. One coroutine at a time accepts on a listener.
+inline task<async_stream> async_accept(async_loop& loop, socket& listener)
+{
+   listener.set_non_blocking(true);
+
+   while (true)
+   {
+      int fd = ::accept4(listener.native_handle(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+      if (fd >= 0)
+      {
+         co_return async_stream(loop, fd, true);
+      }
+
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+      {
+         throw std::runtime_error(std::string("Unable to accept a connection: ") + std::strerror(errno));
+      }
+
+      co_await loop.readable(listener.native_handle());
+   }
+}
+
+// Connects client to the address it was made with. The stream borrows
+// the socket's descriptor, so the socket must outlive it.
+inline task<async_stream> async_connect(async_loop& loop, socket& client)
+{
+   int error = client.connect_non_blocking();
+
+   async_stream stream(loop, client.native_handle(), false);
+
+   if (error == EINPROGRESS)
+   {
+      co_await loop.writable(client.native_handle());
+
+      error = client.connect_error();
+   }
+
+   if (error != 0)
+   {
+      throw std::runtime_error(std::string("Error cannot connect to the address: ") + std::strerror(error));
+   }
+
+   co_return stream;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __cplusplus >= 202002L && __linux__
+
+#endif // __ASYNC_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of async.hpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,1138 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: bandwidth.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Bulk throughput engine built on ev9::socket. The sender streams a payload
+// buffer for a fixed duration or byte count, the receiver drains the
+// connection until the sender closes it. Both sides report goodput, bytes
+// per syscall and per-interval throughput.
+//
+// The sender can copy (write), sendfile from a file or memfd, or use
+// MSG_ZEROCOPY, and records the CPU cycles its thread spent so the modes
+// can be compared per byte.
+//
+// Either side can run ev9::socket on its io_uring backend instead of plain
+// system calls (set_backend); syscalls then counts io_uring_enter calls.
+//
+// set_socket_options() applies ev9::socket::options to the listener (and
+// through it every accepted connection) or to the sender's socket before
+// it connects.
+//
+// set_transport() runs the copy mode over a local transport (local.hpp)
+// instead of TCP, for comparison on one host; syscalls then counts reads
+// or writes of the transport, which for shared memory are ring calls.
+//
+// set_verify() frames the copy mode stream into payload sized chunks, each
+// stamped with a sequence number and a CRC32C (integrity.hpp), and makes
+// the receiver check every chunk right after the read that completes it.
+// Both sides have to set it.
+//
+// The payload is mapped memory, faulted in just before a stream first
+// needs it, that set_buffer_node() can bind to a NUMA node; every result
+// records the CPU its side finished on and the node the payload sat on,
+// so a run can be reproduced.
+//
+// set_buffer_pool() takes the payload from a buffer_pool (buffer_pool.hpp)
+// instead, on huge pages faulted in once and handed back when the stream
+// object goes, so repeated runs stop paying for fresh pages. Each result
+// counts the page faults its side's thread took while streaming.
+//
+// set_connection_pool() takes the sender's connection from a
+// connection_pool (pool.hpp) and gives it back after each run, so repeated
+// short runs to one receiver pay for one handshake. Closing can then no
+// longer end a run: every write goes out as a burst behind an 8 byte
+// little endian length, a zero length ends the run and the receiver
+// answers it with one byte before the connection goes back. The receiver
+// has to set_framed_runs(); it keeps the connection between receive()
+// calls and counts its burst header reads as syscalls. Copy mode, classic
+// backend and TCP only; new connections take the pool's socket options.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __BANDWIDTH_HPP__
+#define __BANDWIDTH_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "buffer_pool.hpp"
+#include "cycles.hpp"
+#include "integrity.hpp"
+#include "pool.hpp"
+#include "socket.hpp"
+#include "topology.hpp"
+#include "transport.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if __linux__
+
+#include "local.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class bandwidth
+{
+   public:  // Constants
+
+      // Length in front of every burst of a framed run
+      static const std::size_t burst_header_size = 8;
+
+   public:  // Type definitions
+
+      typedef std::chrono::steady_clock clock;
+
+      enum send_mode
+      {
+         mode_copy,
+         mode_sendfile,
+         mode_zerocopy
+      };
+
+      enum backend
+      {
+         backend_classic,
+         backend_uring
+      };
+
+      class result
+      {
+         public:  // Constructor
+
+            result() : bytes(0), syscalls(0), seconds(0), cpu_seconds(0), cycles(0), zerocopy_copied(0), uring(false), transport(transport_tcp), verified(false), chunks(0), bad_chunks(0), minor_faults(0), major_faults(0), cpu(-1), buffer_node(-1) { }
+
+         public:  // Public Member Functions
+
+            double gbits() const { return seconds > 0 ? (bytes * 8.0) / seconds / 1e9 : 0; }
+            double bytes_per_syscall() const { return syscalls ? (double)bytes / syscalls : 0; }
+            double cycles_per_byte() const { return bytes ? cycles / bytes : 0; }
+
+         public:  // Member Variables
+
+            std::size_t bytes;
+            std::size_t syscalls;
+            double seconds;
+
+            // CPU time and cycles of the thread that ran this side
+            double cpu_seconds;
+            double cycles;
+
+            // MSG_ZEROCOPY sends the kernel completed by copying anyway
+            std::size_t zerocopy_copied;
+
+            // Ran on the io_uring backend (false if it had to fall back)
+            bool uring;
+
+            transport_kind transport;
+
+            // With set_verify(): chunks stamped or checked good, and on the
+            // receiver those that failed (a cut short stream counts one)
+            bool verified;
+            std::size_t chunks;
+            std::size_t bad_chunks;
+
+            // Page faults of the thread that ran this side, while it ran
+            std::size_t minor_faults;
+            std::size_t major_faults;
+
+            // CPU the side finished on and node holding the payload, -1
+            // where the system does not say
+            int cpu;
+            int buffer_node;
+
+            // Gbit/s for each reporting interval, in order
+            std::vector<double> intervals;
+
+      }; // end of class(result)
+
+   public:  // Constructor | Destructor
+
+      bandwidth(std::size_t port, std::size_t payload_size = 128 * 1024) { _ctor(port, payload_size); }
+      ~bandwidth() { _dtor(); }
+
+   public:  // Public Member Functions
+
+      void listen() { _listen(); }
+      result receive() { return _receive(); }
+
+      // Reads a connection something else accepted (a sharded_server
+      // worker, say) to end of stream, as receive() does
+      result drain(socket& connection) { return _drain(connection, &connection); }
+      result send(const std::string& host) { _connect_or_drop(host); return _stream_or_drop(clock::now()); }
+
+      // send() in two steps, so several senders can connect first and then
+      // stream from a shared start time (see parallel.hpp). A step that
+      // throws drops the connection, so the receiver sees it end.
+      void connect(const std::string& host) { _connect_or_drop(host); }
+      result stream(clock::time_point start) { return _stream_or_drop(start); }
+
+      // Sender: drops the connection connect() made, for a stream that
+      // will not run
+      void close() { _drop_connection(); }
+
+      // Receiver, from another thread: makes a receive() blocked in
+      // accept() fail, for when its sender gave up before connecting
+      void interrupt() { _interrupt(); }
+
+      void set_byte_count(std::size_t bytes) { _m_byte_count = bytes; }
+
+      // How long connect() retries a receiver that is not listening yet
+      void set_connect_timeout(double seconds) { _m_connect_timeout = seconds; }
+      void set_duration(double seconds) { _m_duration = seconds; }
+      void set_interval(double seconds) { _m_interval = seconds; }
+      void set_send_file(const std::string& path) { _m_send_file = path; }
+      void set_send_mode(send_mode mode) { _m_send_mode = mode; }
+      void set_backend(backend kind) { _m_backend = kind; }
+      void set_socket_options(const socket::options& opts) { _m_socket_options = opts; _m_socket_options_set = true; }
+
+      // Anything but transport_tcp needs the copy mode and the classic
+      // backend; the port names the local endpoint
+      void set_transport(transport_kind kind) { _m_transport = kind; }
+
+      // Copy mode only, with a payload of at least 32 bytes; chunks count
+      // in the byte count, headers included
+      void set_verify(bool verify) { _m_verify = verify; }
+
+      // Moves the payload onto a NUMA node, -1 for wherever it faults in.
+      // Call it from the thread that will use the stream.
+      void set_buffer_node(int node) { _allocate_payload(_m_size, node); }
+
+      // Takes the payload from pool, which must outlive this object, until
+      // set_buffer_node() or set_buffer_pool(nullptr) maps one again
+      void set_buffer_pool(buffer_pool* pool) { _use_pool(pool); }
+
+      // Sender: leases each run's connection from pool, which must outlive
+      // this object, and frames the run so the connection can go back.
+      // Needs a receiver with set_framed_runs(true).
+      void set_connection_pool(connection_pool* pool) { _m_connections = pool; }
+
+      // Receiver: reads runs framed by a pooled sender, several to a
+      // connection. connection_held() says the last run ended with its
+      // marker, so drain() can be called again on the same connection.
+      void set_framed_runs(bool framed) { _m_framed_runs = framed; }
+      bool connection_held() const { return _m_held; }
+
+      static const char* mode_name(send_mode mode) { return _mode_name(mode); }
+      static const char* backend_name(backend kind) { return kind == backend_uring ? "io_uring" : "classic"; }
+
+      static void print(const char* const label, const result& res) { _print(label, res); }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t port, std::size_t payload_size)
+      {
+         if (payload_size == 0)
+         {
+            throw std::runtime_error("Payload size must be greater than zero");
+         }
+
+         _m_port = port;
+         _m_byte_count = 0;
+         _m_duration = 10;
+         _m_interval = 1;
+         _m_connect_timeout = 5;
+         _m_socket = nullptr;
+         _m_local = nullptr;
+         _m_transport = transport_tcp;
+         _m_send_mode = mode_copy;
+         _m_backend = backend_classic;
+         _m_file_fd = -1;
+         _m_file_size = 0;
+         _m_socket_options_set = false;
+         _m_verify = false;
+         _m_sequence = 0;
+         _m_chunk_offset = 0;
+         _m_chunk_size = 0;
+         _m_data = nullptr;
+         _m_size = payload_size;
+         _m_connections = nullptr;
+         _m_framed_runs = false;
+         _m_held = false;
+         _m_burst_left = 0;
+
+         // Each run counts cycles; calibrating now keeps the one-off TSC
+         // measurement out of the first run's timing
+         cycle_counter::timestamp_hz();
+      }
+
+      void _allocate_payload(std::size_t payload_size, int node)
+      {
+         _m_pooled.release();
+         _m_payload.allocate(payload_size, node);
+
+         _m_data = _m_payload.data();
+         _m_size = payload_size;
+
+         _fill_payload();
+      }
+
+      // Mapped on first use, so a pool or a node set before then is the
+      // only memory the payload ever touches
+      void _ensure_payload()
+      {
+         if (_m_data == nullptr) _allocate_payload(_m_size, -1);
+      }
+
+      void _use_pool(buffer_pool* pool)
+      {
+         if (pool == nullptr)
+         {
+            if (_m_pooled) _m_data = nullptr;
+
+            _m_pooled.release();
+
+            return;
+         }
+
+         _m_pooled = pool->acquire(_m_size);
+         _m_payload.allocate(0);
+
+         _m_data = _m_pooled.data();
+
+         _fill_payload();
+      }
+
+      void _fill_payload()
+      {
+         // Non-constant pattern so compression or page sharing cannot help
+         for (std::size_t index = 0; index < _m_size; ++index)
+         {
+            _m_data[index] = (char)(index * 31 + 7);
+         }
+      }
+
+      void _dtor()
+      {
+         _close_source();
+
+         _reset_socket(nullptr);
+         _reset_local(nullptr);
+      }
+
+      void _interrupt()
+      {
+         if (_m_socket != nullptr) _m_socket->interrupt();
+         if (_m_local != nullptr) _m_local->interrupt();
+      }
+
+      void _listen()
+      {
+         if (_m_transport != transport_tcp)
+         {
+            _reset_local(_make_local());
+
+            _m_local->bind();
+            _m_local->listen(EV9_SOCKET_BACKLOG);
+
+            return;
+         }
+
+         _reset_socket(new ev9::socket(_m_port));
+
+         if (_m_socket_options_set) _m_socket->set_options(_m_socket_options);
+
+         _m_socket->bind();
+         _m_socket->listen();
+
+         _use_backend();
+      }
+
+      result _receive()
+      {
+         if (_m_socket == nullptr && _m_local == nullptr)
+         {
+            _listen();
+         }
+
+         if (_m_local != nullptr)
+         {
+            _m_local->accept();
+
+            result res = _drain(*_m_local, nullptr);
+
+            _m_local->close_accepted();
+
+            return res;
+         }
+
+         while (true)
+         {
+            // A framed run can follow the last one on the same connection
+            if (!_m_held) _m_socket->accept();
+
+            result res = _drain(*_m_socket, _m_socket);
+
+            // Keep listening so the next receive() can take another sender
+            if (!_m_held) _m_socket->close_accepted();
+
+            // A held connection closed before its next run is not a run
+            if (!_m_framed_runs || _m_held || res.bytes != 0) return res;
+         }
+      }
+
+      // A template so the TCP path calls ev9::socket directly
+      template <typename connection_type> result _drain(connection_type& connection, socket* tcp)
+      {
+         result res;
+
+         res.uring = tcp != nullptr && tcp->uring_enabled();
+         res.transport = tcp != nullptr ? transport_tcp : _m_transport;
+
+         std::size_t enters = tcp != nullptr ? tcp->ring_enters() : 0;
+
+         _ensure_payload();
+
+         _m_verifier.reset();
+
+         bool framed = _m_framed_runs && tcp != nullptr;
+
+         // A held connection idles between runs, so the clock starts with
+         // the run's first burst
+         if (framed && !_start_run(*tcp, res))
+         {
+            return res;
+         }
+
+         page_faults faults = page_faults::now(true);
+
+         cycle_counter counter;
+
+         counter.start();
+
+         auto start = clock::now();
+         auto interval_start = start;
+         std::size_t interval_bytes = 0;
+
+         while (true)
+         {
+            std::size_t amount_read = framed ? _read_burst(*tcp, res) : connection.read(_m_data, _m_size);
+
+            if (amount_read == 0)
+            {
+               break;
+            }
+
+            // While the bytes are still in cache
+            if (_m_verify) _m_verifier.consume(_m_data, amount_read);
+
+            res.bytes += amount_read;
+            ++res.syscalls;
+
+            interval_bytes += amount_read;
+
+            _record_interval(res, interval_start, interval_bytes);
+         }
+
+         res.seconds = _seconds_since(start);
+
+         _finish_interval(res, interval_start, interval_bytes);
+
+         counter.stop();
+
+         res.cpu_seconds = counter.cpu_seconds();
+         res.cpu = topology::current_cpu();
+         res.buffer_node = node_buffer::node_of(_m_data);
+         res.cycles = counter.cycles();
+
+         _record_faults(res, faults);
+
+         if (res.uring) res.syscalls = tcp->ring_enters() - enters;
+
+         if (_m_verify)
+         {
+            _m_verifier.finish();
+
+            res.verified = true;
+            res.chunks = _m_verifier.chunks();
+            res.bad_chunks = _m_verifier.bad_chunks();
+         }
+
+         return res;
+      }
+
+      void _connect_or_drop(const std::string& host)
+      {
+         try
+         {
+            _connect(host);
+         }
+
+         catch (...)
+         {
+            _drop_connection();
+
+            throw;
+         }
+      }
+
+      result _stream_or_drop(clock::time_point start)
+      {
+         try
+         {
+            return _stream(start);
+         }
+
+         catch (...)
+         {
+            _drop_connection();
+
+            throw;
+         }
+      }
+
+      void _drop_connection()
+      {
+         _close_source();
+
+         _reset_socket(nullptr);
+         _reset_local(nullptr);
+
+         // A lease dropped unreleased closes its connection
+         _m_lease = connection_pool::lease();
+      }
+
+      void _connect(const std::string& host)
+      {
+         if (_m_verify && (_m_send_mode != mode_copy || _m_size < 2 * chunk_verifier::header_size || (_m_byte_count != 0 && _m_byte_count < chunk_verifier::header_size)))
+         {
+            throw std::runtime_error("Verification needs the copy mode, a payload of at least 32 bytes and room for one chunk header");
+         }
+
+         _m_sequence = 0;
+         _m_chunk_offset = 0;
+         _m_chunk_size = 0;
+
+         _ensure_payload();
+
+         if (_m_transport != transport_tcp)
+         {
+            if (_m_send_mode != mode_copy || _m_backend != backend_classic)
+            {
+               throw std::runtime_error(std::string("The ") + transport_kind_name(_m_transport) + " transport only sends in copy mode on the classic backend");
+            }
+
+            // Always this host; the name is only for TCP
+            _reset_local(_make_local());
+
+            _m_local->connect(_m_connect_timeout);
+
+            return;
+         }
+
+         if (_m_connections != nullptr)
+         {
+            if (_m_send_mode != mode_copy || _m_backend != backend_classic)
+            {
+               throw std::runtime_error("A pooled connection only sends in copy mode on the classic backend");
+            }
+
+            _reset_socket(nullptr);
+
+            // Replacing a lease a failed run left behind closes its connection
+            _m_lease = _m_connections->acquire(host, _m_port);
+            _m_socket = _m_lease.get();
+
+            return;
+         }
+
+         _reset_socket(new ev9::socket(host, _m_port));
+
+         if (_m_socket_options_set) _m_socket->set_options(_m_socket_options);
+
+         _m_socket->connect(_m_connect_timeout);
+
+         _use_backend();
+
+         _open_source();
+      }
+
+      // Waits for a framed run's first burst header; false when the peer
+      // closed the connection instead or sent an empty run
+      bool _start_run(socket& connection, result& res)
+      {
+         _m_burst_left = 0;
+
+         return _read_burst_header(connection, res) && _m_burst_left != 0;
+      }
+
+      // Reads no further than the burst it is in, so the next run's bytes
+      // stay in the socket; 0 at the end of the run or the connection
+      std::size_t _read_burst(socket& connection, result& res)
+      {
+         if (_m_burst_left == 0 && (!_read_burst_header(connection, res) || _m_burst_left == 0))
+         {
+            return 0;
+         }
+
+         std::size_t amount_read = connection.read(_m_data, _m_burst_left < _m_size ? _m_burst_left : _m_size);
+
+         if (amount_read == 0)
+         {
+            // Cut short: the connection cannot carry another run
+            _m_burst_left = 0;
+            _m_held = false;
+
+            return 0;
+         }
+
+         _m_burst_left -= amount_read;
+
+         return amount_read;
+      }
+
+      // Sets _m_burst_left; a zero length ends the run and is acknowledged
+      bool _read_burst_header(socket& connection, result& res)
+      {
+         char header[burst_header_size];
+
+         ++res.syscalls;
+
+         if (connection.read_all(header, sizeof(header)) != sizeof(header))
+         {
+            _m_held = false;
+
+            return false;
+         }
+
+         _m_burst_left = (std::size_t)_get_length(header);
+
+         if (_m_burst_left == 0)
+         {
+            char acknowledgement = 0;
+
+            _m_held = connection.write_back(&acknowledgement, 1) == 1;
+         }
+
+         return true;
+      }
+
+      // Sends the length in front of the bytes in one call
+      std::size_t _send_burst(std::size_t offset, std::size_t size)
+      {
+         char header[burst_header_size];
+
+         _put_length(header, size);
+
+         #if _WIN32
+            (void)offset;
+
+            throw std::runtime_error("Framed runs need scatter-gather writes");
+         #else
+            socket::segment segments[2];
+
+            segments[0].iov_base = header;
+            segments[0].iov_len = sizeof(header);
+            segments[1].iov_base = _m_data + offset;
+            segments[1].iov_len = size;
+
+            _m_socket->write(segments, 2);
+
+            return size;
+         #endif
+      }
+
+      // Ends a framed run and gives the connection back once the receiver
+      // has acknowledged it, with nothing left unread on either side
+      void _end_run()
+      {
+         char header[burst_header_size];
+
+         _put_length(header, 0);
+
+         #if !_WIN32
+            socket::segment marker;
+
+            marker.iov_base = header;
+            marker.iov_len = sizeof(header);
+
+            _m_socket->write(&marker, 1);
+         #endif
+
+         char acknowledgement = 0;
+
+         if (_m_socket->read_back_all(&acknowledgement, 1) != 1)
+         {
+            throw std::runtime_error("The receiver closed the connection before acknowledging the run");
+         }
+
+         _m_socket = nullptr;
+         _m_lease.release();
+      }
+
+      static void _put_length(char* header, std::uint64_t length)
+      {
+         for (std::size_t index = 0; index < burst_header_size; ++index)
+         {
+            header[index] = (char)(length >> (8 * index));
+         }
+      }
+
+      static std::uint64_t _get_length(const char* header)
+      {
+         std::uint64_t length = 0;
+
+         for (std::size_t index = 0; index < burst_header_size; ++index)
+         {
+            length |= (std::uint64_t)(unsigned char)header[index] << (8 * index);
+         }
+
+         return length;
+      }
+
+      result _stream(clock::time_point start)
+      {
+         if (_m_socket == nullptr && _m_local == nullptr)
+         {
+            throw std::runtime_error("bandwidth::stream() called before connect()");
+         }
+
+         result res;
+
+         res.uring = _m_socket != nullptr && _m_socket->uring_enabled();
+         res.transport = _m_socket != nullptr ? transport_tcp : _m_transport;
+
+         std::size_t enters = _m_socket != nullptr ? _m_socket->ring_enters() : 0;
+
+         bool framed = _m_lease && _m_socket == _m_lease.get();
+
+         page_faults faults = page_faults::now(true);
+
+         cycle_counter counter;
+
+         counter.start();
+
+         auto interval_start = start;
+         std::size_t interval_bytes = 0;
+
+         while (true)
+         {
+            std::size_t offset = 0;
+            std::size_t size = _m_size;
+
+            if (_m_chunk_offset < _m_chunk_size)
+            {
+               // Finish a verified chunk before stopping, so the receiver
+               // never sees one cut short
+               offset = _m_chunk_offset;
+               size = _m_chunk_size - _m_chunk_offset;
+            }
+
+            else
+            {
+               if (_m_byte_count)
+               {
+                  if (res.bytes >= _m_byte_count)
+                  {
+                     break;
+                  }
+
+                  if (_m_byte_count - res.bytes < size)
+                  {
+                     size = _m_byte_count - res.bytes;
+                  }
+               }
+
+               else if (_seconds_since(start) >= _m_duration)
+               {
+                  break;
+               }
+
+               if (_m_verify) size = _next_chunk(size, res.bytes);
+            }
+
+            std::size_t amount_written = _send_chunk(offset, size);
+
+            if (_m_verify) _m_chunk_offset += amount_written;
+
+            res.bytes += amount_written;
+            ++res.syscalls;
+
+            interval_bytes += amount_written;
+
+            _record_interval(res, interval_start, interval_bytes);
+         }
+
+         if (_m_send_mode == mode_zerocopy)
+         {
+            // Pages are only released once the last notification arrives
+            _m_socket->reap_zerocopy(true);
+
+            res.zerocopy_copied = _m_socket->zerocopy_copied();
+         }
+
+         res.seconds = _seconds_since(start);
+
+         _finish_interval(res, interval_start, interval_bytes);
+
+         counter.stop();
+
+         res.cpu_seconds = counter.cpu_seconds();
+         res.cpu = topology::current_cpu();
+         res.buffer_node = node_buffer::node_of(_m_data);
+         res.cycles = counter.cycles();
+
+         _record_faults(res, faults);
+
+         if (res.uring) res.syscalls = _m_socket->ring_enters() - enters;
+
+         if (_m_verify)
+         {
+            res.verified = true;
+            res.chunks = (std::size_t)_m_sequence;
+         }
+
+         _close_source();
+
+         if (framed)
+         {
+            _end_run();
+
+            return res;
+         }
+
+         // Closing the connection is the end-of-stream marker for the receiver
+         _reset_socket(nullptr);
+         _reset_local(nullptr);
+
+         return res;
+      }
+
+      void _use_backend()
+      {
+         // Falls back to the classic calls when io_uring is not available
+         if (_m_backend == backend_uring && _m_socket->use_uring())
+         {
+            _ensure_payload();
+
+            // Writes straight from the payload become WRITE_FIXED
+            _m_socket->register_buffer(_m_data, _m_size);
+         }
+      }
+
+      void _open_source()
+      {
+         if (_m_send_mode == mode_zerocopy)
+         {
+            _m_socket->enable_zerocopy();
+         }
+
+         if (_m_send_mode != mode_sendfile)
+         {
+            return;
+         }
+
+         #if __linux__
+            if (!_m_send_file.empty())
+            {
+               _m_file_fd = ::open(_m_send_file.c_str(), O_RDONLY);
+            }
+
+            else
+            {
+               // Without a file, send the payload pattern from a memfd
+               _m_file_fd = ::memfd_create("ev9_bandwidth", 0);
+
+               if (_m_file_fd >= 0 && ::write(_m_file_fd, _m_data, _m_size) != (ssize_t)_m_size)
+               {
+                  _close_source();
+               }
+            }
+
+            struct stat status;
+
+            if (_m_file_fd < 0 || ::fstat(_m_file_fd, &status) != 0 || status.st_size == 0)
+            {
+               _close_source();
+
+               throw std::runtime_error("Unable to open the sendfile source");
+            }
+
+            _m_file_size = (std::size_t)status.st_size;
+            _m_file_offset = 0;
+         #else
+            throw std::runtime_error("sendfile is not supported on this platform");
+         #endif
+      }
+
+      void _close_source()
+      {
+         #if __linux__
+            if (_m_file_fd >= 0) ::close(_m_file_fd);
+         #endif
+
+         _m_file_fd = -1;
+      }
+
+      // Stamps the next chunk at the start of the payload and returns its
+      // size, at most size; with a byte count it leaves room for the
+      // header of the chunk after it
+      std::size_t _next_chunk(std::size_t size, std::size_t sent)
+      {
+         std::size_t left = _m_byte_count ? _m_byte_count - sent - size : 0;
+
+         if (left != 0 && left < chunk_verifier::header_size)
+         {
+            size -= chunk_verifier::header_size;
+         }
+
+         chunk_verifier::stamp(_m_data, _m_sequence++, size - chunk_verifier::header_size);
+
+         _m_chunk_offset = 0;
+         _m_chunk_size = size;
+
+         return size;
+      }
+
+      std::size_t _send_chunk(std::size_t offset, std::size_t size)
+      {
+         if (_m_send_mode == mode_sendfile)
+         {
+            // Wrap around the file so any duration can be covered
+            if (_m_file_offset == _m_file_size)
+            {
+               _m_file_offset = 0;
+            }
+
+            if (size > _m_file_size - _m_file_offset)
+            {
+               size = _m_file_size - _m_file_offset;
+            }
+
+            std::size_t amount_written = _m_socket->send_file(_m_file_fd, _m_file_offset, size);
+
+            _m_file_offset += amount_written;
+
+            return amount_written;
+         }
+
+         if (_m_send_mode == mode_zerocopy)
+         {
+            std::size_t amount_written = _m_socket->write_zerocopy(_m_data + offset, size);
+
+            // The payload is never modified, so completions only need to be
+            // drained to keep the error queue from filling up.
+            _m_socket->reap_zerocopy(false);
+
+            return amount_written;
+         }
+
+         if (_m_local != nullptr)
+         {
+            return _m_local->write(_m_data + offset, size);
+         }
+
+         if (_m_lease && _m_socket == _m_lease.get())
+         {
+            return _send_burst(offset, size);
+         }
+
+         return _m_socket->write(_m_data + offset, size);
+      }
+
+      void _record_interval(result& res, clock::time_point& interval_start, std::size_t& interval_bytes)
+      {
+         double elapsed = _seconds_since(interval_start);
+
+         if (elapsed >= _m_interval)
+         {
+            res.intervals.push_back(interval_bytes * 8.0 / elapsed / 1e9);
+
+            interval_start = clock::now();
+            interval_bytes = 0;
+         }
+      }
+
+      void _finish_interval(result& res, clock::time_point interval_start, std::size_t interval_bytes)
+      {
+         double elapsed = _seconds_since(interval_start);
+
+         if (interval_bytes && elapsed > 0)
+         {
+            res.intervals.push_back(interval_bytes * 8.0 / elapsed / 1e9);
+         }
+      }
+
+      static void _record_faults(result& res, const page_faults& before)
+      {
+         page_faults taken = page_faults::now(true) - before;
+
+         res.minor_faults = taken.minor;
+         res.major_faults = taken.major;
+      }
+
+      void _reset_socket(ev9::socket* socket)
+      {
+         // A leased connection is the lease's to close
+         if (_m_socket != nullptr && _m_socket != _m_lease.get()) delete _m_socket;
+
+         _m_socket = socket;
+      }
+
+      void _reset_local(transport* local)
+      {
+         if (_m_local != nullptr) delete _m_local;
+
+         _m_local = local;
+      }
+
+      transport* _make_local()
+      {
+         #if __linux__
+            return make_local_transport(_m_transport, _m_port);
+         #else
+            throw std::runtime_error("Local transports need Linux");
+         #endif
+      }
+
+      static double _seconds_since(clock::time_point start)
+      {
+         std::chrono::duration<double> elapsed = clock::now() - start;
+
+         return elapsed.count();
+      }
+
+      static const char* _mode_name(send_mode mode)
+      {
+         switch (mode)
+         {
+            case mode_sendfile: return "sendfile";
+            case mode_zerocopy: return "zerocopy";
+            default: return "copy";
+         }
+      }
+
+      static void _print(const char* const label, const result& res)
+      {
+         for (std::size_t index = 0; index < res.intervals.size(); ++index)
+         {
+            std::printf("[%s] interval %3lu: %8.3f Gbit/s\n", label, (unsigned long)index, res.intervals[index]);
+         }
+
+         std::printf("[%s] %lu bytes in %.3f s, %lu syscalls, %.0f bytes/syscall, %.3f Gbit/s\n",
+                     label,
+                     (unsigned long)res.bytes,
+                     res.seconds,
+                     (unsigned long)res.syscalls,
+                     res.bytes_per_syscall(),
+                     res.gbits());
+
+         std::printf("[%s] %.3f s cpu, %.3f cycles/byte\n", label, res.cpu_seconds, res.cycles_per_byte());
+
+         std::printf("[%s] %lu minor, %lu major page faults\n", label, (unsigned long)res.minor_faults, (unsigned long)res.major_faults);
+
+         if (res.uring)
+         {
+            std::printf("[%s] io_uring backend, syscalls are io_uring_enter calls\n", label);
+         }
+
+         if (res.transport != transport_tcp)
+         {
+            std::printf("[%s] %s transport%s\n", label, transport_kind_name(res.transport), res.transport == transport_shm ? ", syscalls are ring reads or writes" : "");
+         }
+
+         if (res.verified)
+         {
+            std::printf("[%s] %lu chunks with good CRC32C (%s), %lu bad\n", label, (unsigned long)res.chunks, crc32c::implementation(), (unsigned long)res.bad_chunks);
+         }
+
+         if (res.zerocopy_copied)
+         {
+            std::printf("[%s] %lu zero-copy sends fell back to copying\n", label, (unsigned long)res.zerocopy_copied);
+         }
+      }
+
+   private: // Member Variables
+
+      ev9::socket* _m_socket;
+
+      // Set instead of _m_socket when the transport is not TCP
+      transport* _m_local;
+      transport_kind _m_transport;
+
+      std::size_t _m_port;
+      std::size_t _m_byte_count;
+
+      double _m_duration;
+      double _m_interval;
+      double _m_connect_timeout;
+
+      send_mode _m_send_mode;
+      backend _m_backend;
+
+      socket::options _m_socket_options;
+      bool _m_socket_options_set;
+
+      std::string _m_send_file;
+
+      int _m_file_fd;
+      std::size_t _m_file_size;
+      std::size_t _m_file_offset;
+
+      // Where the payload is: _m_payload, or _m_pooled with a pool
+      char* _m_data;
+      std::size_t _m_size;
+
+      node_buffer _m_payload;
+      buffer_pool::lease _m_pooled;
+
+      // Chunk framing for set_verify(): the sender's place in the chunk it
+      // is writing, the receiver's checker
+      bool _m_verify;
+      std::uint64_t _m_sequence;
+      std::size_t _m_chunk_offset;
+      std::size_t _m_chunk_size;
+      chunk_verifier _m_verifier;
+
+      // Framed runs: the sender's pool and the connection it leased, the
+      // receiver's switch, whether it holds its connection for another
+      // run and what is left of the burst it is reading
+      connection_pool* _m_connections;
+      connection_pool::lease _m_lease;
+      bool _m_framed_runs;
+      bool _m_held;
+      std::size_t _m_burst_left;
+
+}; // end of class(bandwidth)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __BANDWIDTH_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of bandwidth.hpp
+////////////////////////////////////////////////////////////////////////////////
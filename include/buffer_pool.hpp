@@ -0,0 +1,456 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: buffer_pool.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Transfer buffers that are faulted in once and then reused. acquire()
+// rounds the size up to a power of two (4 KiB at least) and hands out an
+// idle buffer of that size, or carves a new huge page sized region (2 MiB)
+// into buffers of that size when there is none. Sizes past a region get
+// a region of their own, rounded up to whole huge pages.
+//
+// Regions come from mmap, 2 MiB aligned. With huge pages on (the default)
+// a region is first tried with MAP_HUGETLB, which needs pages reserved in
+// /proc/sys/vm/nr_hugepages; failing that it asks for transparent huge
+// pages with madvise(MADV_HUGEPAGE). Every page is written before the
+// region is used, so the faults happen in acquire() and never in a timed
+// transfer. set_lock() also mlocks new regions; a lock the limits refuse
+// is skipped and shows in locked_bytes().
+//
+// A lease returns its buffer to the pool when dropped or released. Memory
+// goes back to the system only when the pool is destroyed, so the pool
+// must outlive its leases.
+//
+// page_faults::now() reads the minor and major fault counters of the
+// process or the calling thread with getrusage, to show what the pool
+// saves.
+//
+// Requirements: c++11, Linux for huge pages and locking
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __BUFFER_POOL_HPP__
+#define __BUFFER_POOL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if __linux__
+
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Region size and alignment; the x86-64 and arm64 huge page size
+#ifndef EV9_HUGE_PAGE_SIZE
+#define EV9_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class page_faults
+{
+   public:  // Constructor
+
+      page_faults() : minor(0), major(0) { }
+
+   public:  // Public Member Functions
+
+      // Counters so far, for the whole process or only the calling thread
+      // (Linux); zero where getrusage is not available
+      static page_faults now(bool thread = false)
+      {
+         page_faults res;
+
+         #if __linux__
+            rusage usage;
+
+            if (::getrusage(thread ? RUSAGE_THREAD : RUSAGE_SELF, &usage) == 0)
+            {
+               res.minor = (std::size_t)usage.ru_minflt;
+               res.major = (std::size_t)usage.ru_majflt;
+            }
+         #else
+            (void)thread;
+         #endif
+
+         return res;
+      }
+
+      page_faults operator-(const page_faults& earlier) const
+      {
+         page_faults res;
+
+         res.minor = minor - earlier.minor;
+         res.major = major - earlier.major;
+
+         return res;
+      }
+
+   public:  // Member Variables
+
+      std::size_t minor;
+      std::size_t major;
+
+}; // end of class(page_faults)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class buffer_pool
+{
+   public:  // Inner Classes
+
+      class lease
+      {
+         public:  // Constructor | Destructor
+
+            lease() : _m_pool(nullptr), _m_data(nullptr), _m_size(0) { }
+            lease(lease&& other) : _m_pool(other._m_pool), _m_data(other._m_data), _m_size(other._m_size) { other._m_pool = nullptr; other._m_data = nullptr; other._m_size = 0; }
+            ~lease() { release(); }
+
+            lease& operator=(lease&& other)
+            {
+               if (this != &other)
+               {
+                  release();
+
+                  _m_pool = other._m_pool;
+                  _m_data = other._m_data;
+                  _m_size = other._m_size;
+
+                  other._m_pool = nullptr;
+                  other._m_data = nullptr;
+                  other._m_size = 0;
+               }
+
+               return *this;
+            }
+
+         private: // Owns the buffer, not copyable
+
+            lease(const lease&);
+            lease& operator=(const lease&);
+
+         public:  // Public Member Functions
+
+            char* data() const { return _m_data; }
+
+            // The rounded up size, at least what was asked for
+            std::size_t size() const { return _m_size; }
+
+            char& operator[](std::size_t index) const { return _m_data[index]; }
+
+            explicit operator bool() const { return _m_data != nullptr; }
+
+            // Hands the buffer back for reuse; the lease is empty after
+            void release()
+            {
+               if (_m_pool != nullptr && _m_data != nullptr) _m_pool->_release(_m_data, _m_size);
+
+               _m_pool = nullptr;
+               _m_data = nullptr;
+               _m_size = 0;
+            }
+
+         private: // Private Member Functions
+
+            friend class buffer_pool;
+
+            lease(buffer_pool* pool, char* data, std::size_t size) : _m_pool(pool), _m_data(data), _m_size(size) { }
+
+         private: // Member Variables
+
+            buffer_pool* _m_pool;
+            char* _m_data;
+            std::size_t _m_size;
+
+      }; // end of class(lease)
+
+   public:  // Constructor | Destructor
+
+      buffer_pool() { _ctor(); }
+      ~buffer_pool() { _dtor(); }
+
+   private: // Owns its regions, not copyable
+
+      buffer_pool(const buffer_pool&);
+      buffer_pool& operator=(const buffer_pool&);
+
+   public:  // Public Member Functions
+
+      // A buffer of at least size bytes, 4 KiB aligned and faulted in
+      lease acquire(std::size_t size) { return _acquire(size); }
+
+      // Maps and faults in count buffers of size now, so later acquires
+      // are all hits
+      void reserve(std::size_t size, std::size_t count) { _reserve(size, count); }
+
+      // Both apply to regions mapped after the call
+      void set_huge_pages(bool huge) { std::lock_guard<std::mutex> lock(_m_lock); _m_huge_pages = huge; }
+      void set_lock(bool lock_pages) { std::lock_guard<std::mutex> lock(_m_lock); _m_lock_pages = lock_pages; }
+
+      // Acquires served from idle buffers, and those that mapped a region
+      std::size_t hits() const { std::lock_guard<std::mutex> lock(_m_lock); return _m_hits; }
+      std::size_t misses() const { std::lock_guard<std::mutex> lock(_m_lock); return _m_misses; }
+
+      // Bytes mapped, on MAP_HUGETLB pages, advised for transparent huge
+      // pages, and mlocked
+      std::size_t mapped_bytes() const { return _total(0); }
+      std::size_t hugetlb_bytes() const { return _total(1); }
+      std::size_t transparent_bytes() const { return _total(2); }
+      std::size_t locked_bytes() const { return _total(3); }
+
+      // Size class a request for size bytes is served from
+      static std::size_t rounded_size(std::size_t size) { return _rounded_size(size); }
+
+   private: // Region bookkeeping
+
+      class region
+      {
+         public:
+
+            region() : base(nullptr), bytes(0), hugetlb(false), transparent(false), locked(false) { }
+
+            char* base;
+            std::size_t bytes;
+
+            bool hugetlb;
+            bool transparent;
+            bool locked;
+
+      }; // end of class(region)
+
+   private: // Private Member Functions
+
+      void _ctor()
+      {
+         _m_huge_pages = true;
+         _m_lock_pages = false;
+
+         _m_hits = 0;
+         _m_misses = 0;
+      }
+
+      void _dtor()
+      {
+         for (region& current : _m_regions)
+         {
+            #if __linux__
+               if (current.locked) ::munlock(current.base, current.bytes);
+
+               ::munmap(current.base, current.bytes);
+            #else
+               delete [] current.base;
+            #endif
+         }
+      }
+
+      lease _acquire(std::size_t size)
+      {
+         std::size_t rounded = _rounded_size(size);
+
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         std::vector<char*>& idle = _m_idle[rounded];
+
+         if (!idle.empty())
+         {
+            ++_m_hits;
+         }
+
+         else
+         {
+            ++_m_misses;
+
+            _grow(rounded);
+         }
+
+         char* data = idle.back();
+
+         idle.pop_back();
+
+         return lease(this, data, rounded);
+      }
+
+      void _reserve(std::size_t size, std::size_t count)
+      {
+         std::size_t rounded = _rounded_size(size);
+
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         while (_m_idle[rounded].size() < count)
+         {
+            _grow(rounded);
+         }
+      }
+
+      void _release(char* data, std::size_t size)
+      {
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         _m_idle[size].push_back(data);
+      }
+
+      // Maps one region and splits it into idle buffers of size bytes;
+      // called with the lock held
+      void _grow(std::size_t size)
+      {
+         region current = _map(size < EV9_HUGE_PAGE_SIZE ? EV9_HUGE_PAGE_SIZE : size);
+
+         _m_regions.push_back(current);
+
+         std::vector<char*>& idle = _m_idle[size];
+
+         for (std::size_t offset = 0; offset + size <= current.bytes; offset += size)
+         {
+            idle.push_back(current.base + offset);
+         }
+      }
+
+      region _map(std::size_t bytes)
+      {
+         region res;
+
+         res.bytes = bytes;
+
+         #if __linux__
+            void* memory = MAP_FAILED;
+
+            if (_m_huge_pages)
+            {
+               memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+               res.hugetlb = memory != MAP_FAILED;
+            }
+
+            if (memory == MAP_FAILED)
+            {
+               // Over-map, then trim to a huge page boundary so the kernel
+               // can back the region with whole huge pages
+               void* raw = ::mmap(nullptr, bytes + EV9_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+               if (raw == MAP_FAILED)
+               {
+                  throw std::runtime_error("Unable to map a " + std::to_string(bytes) + " byte buffer region");
+               }
+
+               std::uintptr_t start = (std::uintptr_t)raw;
+               std::uintptr_t aligned = (start + EV9_HUGE_PAGE_SIZE - 1) & ~(std::uintptr_t)(EV9_HUGE_PAGE_SIZE - 1);
+
+               if (aligned != start) ::munmap(raw, aligned - start);
+               if (aligned + bytes != start + bytes + EV9_HUGE_PAGE_SIZE) ::munmap((void*)(aligned + bytes), start + EV9_HUGE_PAGE_SIZE - aligned);
+
+               memory = (void*)aligned;
+
+               // Before the first touch, or the region faults in small pages
+               res.transparent = _m_huge_pages && ::madvise(memory, bytes, MADV_HUGEPAGE) == 0;
+            }
+
+            res.base = (char*)memory;
+         #else
+            res.base = new char[bytes];
+         #endif
+
+         // One write per small page faults the whole region in
+         for (std::size_t offset = 0; offset < bytes; offset += 4096)
+         {
+            res.base[offset] = 0;
+         }
+
+         #if __linux__
+            res.locked = _m_lock_pages && ::mlock(res.base, bytes) == 0;
+         #endif
+
+         return res;
+      }
+
+      std::size_t _total(int kind) const
+      {
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         std::size_t total = 0;
+
+         for (const region& current : _m_regions)
+         {
+            bool counted = kind == 0 || (kind == 1 && current.hugetlb) || (kind == 2 && current.transparent) || (kind == 3 && current.locked);
+
+            if (counted) total += current.bytes;
+         }
+
+         return total;
+      }
+
+      static std::size_t _rounded_size(std::size_t size)
+      {
+         if (size > EV9_HUGE_PAGE_SIZE)
+         {
+            return (size + EV9_HUGE_PAGE_SIZE - 1) / EV9_HUGE_PAGE_SIZE * EV9_HUGE_PAGE_SIZE;
+         }
+
+         std::size_t rounded = 4096;
+
+         while (rounded < size)
+         {
+            rounded *= 2;
+         }
+
+         return rounded;
+      }
+
+   private: // Member Variables
+
+      mutable std::mutex _m_lock;
+
+      std::vector<region> _m_regions;
+      std::map<std::size_t, std::vector<char*> > _m_idle;
+
+      bool _m_huge_pages;
+      bool _m_lock_pages;
+
+      std::size_t _m_hits;
+      std::size_t _m_misses;
+
+}; // end of class(buffer_pool)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __BUFFER_POOL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of buffer_pool.hpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,288 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: crc32c.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// CRC32C (Castagnoli, the iSCSI and ext4 checksum), computed incrementally.
+//
+// On x86-64 CPUs with SSE4.2 and PCLMULQDQ, picked at run time, the crc32
+// instruction runs over three 1 KiB lanes of each 3 KiB block at once, to
+// cover its three cycle latency, and the three lane CRCs are joined with
+// carry-less multiplies by x^8192 and x^16384 mod P. Elsewhere a
+// slicing-by-8 table does eight bytes per step.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __CRC32C_HPP__
+#define __CRC32C_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+   #define EV9_CRC32C_X86 1
+
+   #include <immintrin.h>
+#else
+   #define EV9_CRC32C_X86 0
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class crc32c
+{
+   public:  // Constructor | Destructor
+
+      crc32c() : _m_state(0xFFFFFFFF) { }
+      ~crc32c() { }
+
+   public:  // Public Member Functions
+
+      // Adds bytes to the checksum; updating with a then b is the same as
+      // updating with a and b joined
+      void update(const void* data, std::size_t size) { _m_state = _extend(_m_state, (const char*)data, size); }
+
+      std::uint32_t value() const { return ~_m_state; }
+      void reset() { _m_state = 0xFFFFFFFF; }
+
+      static std::uint32_t compute(const void* data, std::size_t size) { return ~_extend(0xFFFFFFFF, (const char*)data, size); }
+
+      // Always the table, for checking and timing the hardware path
+      static std::uint32_t compute_software(const void* data, std::size_t size) { return ~_software(0xFFFFFFFF, (const char*)data, size); }
+
+      // SSE4.2 and PCLMULQDQ are in use
+      static bool hardware() { return _hardware_available(); }
+      static const char* implementation() { return _hardware_available() ? "sse4.2+pclmul" : "slicing-by-8"; }
+
+   private: // Private Member Functions
+
+      static const std::uint32_t _polynomial = 0x82F63B78;
+      static const std::size_t _lane = 1024;
+
+      static std::uint32_t _extend(std::uint32_t state, const char* data, std::size_t size)
+      {
+         #if EV9_CRC32C_X86
+            if (_hardware_available())
+            {
+               return _hardware(state, data, size);
+            }
+         #endif
+
+         return _software(state, data, size);
+      }
+
+      static bool _hardware_available()
+      {
+         #if EV9_CRC32C_X86
+            static const bool available = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul");
+
+            return available;
+         #else
+            return false;
+         #endif
+      }
+
+      static const std::uint32_t* _table()
+      {
+         // Table k advances a byte through k more zero bytes
+         static std::uint32_t table[8][256];
+         static bool built = _build_table(table);
+
+         (void)built;
+
+         return &table[0][0];
+      }
+
+      static bool _build_table(std::uint32_t (&table)[8][256])
+      {
+         for (std::uint32_t index = 0; index < 256; ++index)
+         {
+            std::uint32_t value = index;
+
+            for (int bit = 0; bit < 8; ++bit)
+            {
+               value = (value & 1) ? (value >> 1) ^ _polynomial : value >> 1;
+            }
+
+            table[0][index] = value;
+         }
+
+         for (std::uint32_t index = 0; index < 256; ++index)
+         {
+            for (int slice = 1; slice < 8; ++slice)
+            {
+               table[slice][index] = (table[slice - 1][index] >> 8) ^ table[0][table[slice - 1][index] & 0xFF];
+            }
+         }
+
+         return true;
+      }
+
+      static std::uint32_t _software(std::uint32_t state, const char* data, std::size_t size)
+      {
+         const std::uint32_t* table = _table();
+         const unsigned char* bytes = (const unsigned char*)data;
+
+         while (size >= 8)
+         {
+            std::uint32_t low = state ^ ((std::uint32_t)bytes[0] | (std::uint32_t)bytes[1] << 8 | (std::uint32_t)bytes[2] << 16 | (std::uint32_t)bytes[3] << 24);
+
+            state = table[7 * 256 + (low & 0xFF)] ^
+                    table[6 * 256 + ((low >> 8) & 0xFF)] ^
+                    table[5 * 256 + ((low >> 16) & 0xFF)] ^
+                    table[4 * 256 + (low >> 24)] ^
+                    table[3 * 256 + bytes[4]] ^
+                    table[2 * 256 + bytes[5]] ^
+                    table[1 * 256 + bytes[6]] ^
+                    table[0 * 256 + bytes[7]];
+
+            bytes += 8;
+            size -= 8;
+         }
+
+         while (size--)
+         {
+            state = (state >> 8) ^ table[(state ^ *bytes++) & 0xFF];
+         }
+
+         return state;
+      }
+
+      // a * b mod P, bit 31 holding x^0 as the CRC register does
+      static std::uint32_t _multiply(std::uint32_t a, std::uint32_t b)
+      {
+         std::uint32_t product = 0;
+
+         for (int bit = 0; bit < 32; ++bit)
+         {
+            if (a & 0x80000000) product ^= b;
+
+            a <<= 1;
+            b = (b & 1) ? (b >> 1) ^ _polynomial : b >> 1;
+         }
+
+         return product;
+      }
+
+      // x^bits mod P: what the register is multiplied by over bits zero bits
+      static std::uint32_t _power(std::size_t bits)
+      {
+         std::uint32_t result = 0x80000000;
+         std::uint32_t square = 0x40000000;
+
+         for (; bits != 0; bits >>= 1)
+         {
+            if (bits & 1) result = _multiply(result, square);
+
+            square = _multiply(square, square);
+         }
+
+         return result;
+      }
+
+      #if EV9_CRC32C_X86
+
+      static std::uint64_t _load(const char* data)
+      {
+         std::uint64_t value;
+
+         std::memcpy(&value, data, sizeof(value));
+
+         return value;
+      }
+
+      // _multiply() in a few instructions: the 63 bit carry-less product,
+      // shifted into register order, is reduced by the crc32 instruction
+      __attribute__((target("sse4.2,pclmul"))) static std::uint32_t _multiply_hardware(std::uint32_t a, std::uint32_t b)
+      {
+         __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128((int)a), _mm_cvtsi32_si128((int)b), 0x00);
+
+         product = _mm_slli_epi64(product, 1);
+
+         return _mm_crc32_u32(0, (std::uint32_t)_mm_cvtsi128_si32(product)) ^ (std::uint32_t)_mm_extract_epi32(product, 1);
+      }
+
+      __attribute__((target("sse4.2,pclmul"))) static std::uint32_t _hardware(std::uint32_t state, const char* data, std::size_t size)
+      {
+         static const std::uint32_t one_lane = _power(8 * _lane);
+         static const std::uint32_t two_lanes = _power(16 * _lane);
+
+         std::uint64_t crc = state;
+
+         while (size >= 3 * _lane)
+         {
+            std::uint64_t crc1 = 0;
+            std::uint64_t crc2 = 0;
+
+            for (std::size_t offset = 0; offset < _lane; offset += 8)
+            {
+               crc = _mm_crc32_u64(crc, _load(data + offset));
+               crc1 = _mm_crc32_u64(crc1, _load(data + _lane + offset));
+               crc2 = _mm_crc32_u64(crc2, _load(data + 2 * _lane + offset));
+            }
+
+            // Lane 0 runs on through lanes 1 and 2, lane 1 through lane 2
+            crc = _multiply_hardware((std::uint32_t)crc, two_lanes) ^ _multiply_hardware((std::uint32_t)crc1, one_lane) ^ (std::uint32_t)crc2;
+
+            data += 3 * _lane;
+            size -= 3 * _lane;
+         }
+
+         for (; size >= 8; size -= 8, data += 8)
+         {
+            crc = _mm_crc32_u64(crc, _load(data));
+         }
+
+         std::uint32_t tail = (std::uint32_t)crc;
+
+         for (; size != 0; --size)
+         {
+            tail = _mm_crc32_u8(tail, (unsigned char)*data++);
+         }
+
+         return tail;
+      }
+
+      #endif
+
+   private: // Member Variables
+
+      std::uint32_t _m_state;
+
+}; // end of class(crc32c)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __CRC32C_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of crc32c.hpp
+////////////////////////////////////////////////////////////////////////////////
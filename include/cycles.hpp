@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: cycles.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Counts the CPU cycles spent by the calling thread, user and kernel time
+// included. Uses the hardware cycle counter through perf_event_open when the
+// kernel allows it, otherwise estimates cycles from the thread's CPU time
+// and the calibrated TSC rate. source() says which one was used.
+//
+// The TSC rate is calibrated once per process, taking 20 ms, by the first
+// counter constructed (or timestamp_hz()), never inside stop().
+//
+// Requirements: c++11, Linux for exact counts
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __CYCLES_HPP__
+#define __CYCLES_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#if __linux__
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <x86intrin.h>
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class cycle_counter
+{
+   public:  // Constructor | Destructor
+
+      cycle_counter() { _ctor(); }
+      ~cycle_counter() { _dtor(); }
+
+   private: // Copying would share the perf descriptor
+
+      cycle_counter(const cycle_counter&);
+      cycle_counter& operator=(const cycle_counter&);
+
+   public:  // Public Member Functions
+
+      void start() { _start(); }
+      void stop() { _stop(); }
+
+      double cpu_seconds() const { return _m_cpu_seconds; }
+      double cycles() const { return _m_cycles; }
+
+      const char* source() const { return _m_perf_fd >= 0 ? "perf" : "tsc-estimate"; }
+
+      static unsigned long long timestamp() { return _timestamp(); }
+      static double timestamp_hz() { return _timestamp_hz(); }
+
+   private: // Private Member Functions
+
+      void _ctor()
+      {
+         _m_perf_fd = -1;
+         _m_cpu_seconds = 0;
+         _m_cycles = 0;
+         _m_cpu_start = 0;
+
+         #if __linux__
+            perf_event_attr attributes;
+
+            memset(&attributes, 0, sizeof(attributes));
+
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            attributes.disabled = 1;
+            attributes.exclude_hv = 1;
+
+            // pid 0, cpu -1: this thread on whichever core it runs
+            _m_perf_fd = (int)::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+         #endif
+
+         // Ready for a perf read that fails, before anything is measured
+         _timestamp_hz();
+      }
+
+      void _dtor()
+      {
+         #if __linux__
+            if (_m_perf_fd >= 0) ::close(_m_perf_fd);
+         #endif
+      }
+
+      void _start()
+      {
+         #if __linux__
+            if (_m_perf_fd >= 0)
+            {
+               ::ioctl(_m_perf_fd, PERF_EVENT_IOC_RESET, 0);
+               ::ioctl(_m_perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+         #endif
+
+         _m_cpu_start = _thread_cpu_seconds();
+      }
+
+      void _stop()
+      {
+         _m_cpu_seconds = _thread_cpu_seconds() - _m_cpu_start;
+
+         #if __linux__
+            if (_m_perf_fd >= 0)
+            {
+               ::ioctl(_m_perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+
+               long long count = 0;
+
+               if (::read(_m_perf_fd, &count, sizeof(count)) == sizeof(count))
+               {
+                  _m_cycles = (double)count;
+
+                  return;
+               }
+            }
+         #endif
+
+         _m_cycles = _m_cpu_seconds * _timestamp_hz();
+      }
+
+      static double _thread_cpu_seconds()
+      {
+         #if __linux__
+            timespec now;
+
+            ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+            return now.tv_sec + now.tv_nsec / 1e9;
+         #else
+            return (double)std::clock() / CLOCKS_PER_SEC;
+         #endif
+      }
+
+      static unsigned long long _timestamp()
+      {
+         #if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+         #else
+            return (unsigned long long)std::chrono::steady_clock::now().time_since_epoch().count();
+         #endif
+      }
+
+      static double _timestamp_hz()
+      {
+         static const double hz = _calibrate_timestamp();
+
+         return hz;
+      }
+
+      static double _calibrate_timestamp()
+      {
+         // Measured against steady_clock; constant_tsc parts tick at the
+         // nominal frequency regardless of the current clock speed.
+         auto start = std::chrono::steady_clock::now();
+         unsigned long long start_ticks = _timestamp();
+
+         std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+         unsigned long long end_ticks = _timestamp();
+         std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+         return (end_ticks - start_ticks) / elapsed.count();
+      }
+
+   private: // Member Variables
+
+      int _m_perf_fd;
+
+      double _m_cpu_start;
+      double _m_cpu_seconds;
+      double _m_cycles;
+
+}; // end of class(cycle_counter)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __CYCLES_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of cycles.hpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: framing.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Length-prefixed messages over a TCP ev9::socket. Every frame is a four
+// byte big-endian payload length followed by the payload, so message
+// boundaries no longer depend on how the kernel happened to segment the
+// stream.
+//
+// frame_reader pulls the stream into one large receive buffer, a chunk per
+// read, and hands out views of the complete frames inside it. Many small
+// frames cost one read between them, and a frame is never copied out of
+// the buffer. frame_writer sends the prefix and the payload in one gathered
+// write.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __FRAMING_HPP__
+#define __FRAMING_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "socket.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Size of the length prefix in front of every frame
+const std::size_t frame_header_size = 4;
+
+// Which descriptor of an ev9::socket a reader or writer uses: the accepted
+// connection (read(), write_back()) or the connected one (read_back(),
+// write())
+enum frame_side
+{
+   side_accepted,
+   side_connected
+};
+
+inline void encode_frame_header(char* const header, std::uint32_t size)
+{
+   header[0] = (char)(size >> 24);
+   header[1] = (char)(size >> 16);
+   header[2] = (char)(size >> 8);
+   header[3] = (char)size;
+}
+
+inline std::uint32_t decode_frame_header(const char* const header)
+{
+   const unsigned char* bytes = (const unsigned char*)header;
+
+   return ((std::uint32_t)bytes[0] << 24) | ((std::uint32_t)bytes[1] << 16) | ((std::uint32_t)bytes[2] << 8) | (std::uint32_t)bytes[3];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class frame_reader
+{
+   public:  // Type definitions
+
+      // Points into the reader's buffer; valid until the next call to next()
+      class frame
+      {
+         public:
+
+            frame() : data(nullptr), size(0) { }
+
+            const char* data;
+            std::size_t size;
+
+            std::string str() const { return std::string(data, size); }
+
+      }; // end of class(frame)
+
+   public:  // Constructor | Destructor
+
+      // The buffer grows past capacity only for a frame that does not fit,
+      // and never past max_frame plus the header
+      frame_reader(socket& connection, frame_side side = side_accepted, std::size_t capacity = 256 * 1024, std::size_t max_frame = 16 * 1024 * 1024) { _ctor(connection, side, capacity, max_frame); }
+      ~frame_reader() { }
+
+   private: // Holds a reference to the socket, not copyable
+
+      frame_reader(const frame_reader&);
+      frame_reader& operator=(const frame_reader&);
+
+   public:  // Public Member Functions
+
+      // Blocks until a whole frame has arrived. Returns false when the peer
+      // closes the connection between frames and throws when it closes
+      // inside one, or when a header announces more than max_frame.
+      bool next(frame& current) { return _next(current); }
+
+      // Bytes received but not yet handed out
+      std::size_t buffered() const { return _m_end - _m_begin - _m_consumed; }
+      std::size_t capacity() const { return _m_buffer.size(); }
+
+      std::size_t frames() const { return _m_frames; }
+      std::size_t reads() const { return _m_reads; }
+
+   private: // Private Member Functions
+
+      void _ctor(socket& connection, frame_side side, std::size_t capacity, std::size_t max_frame)
+      {
+         if (capacity < frame_header_size)
+         {
+            throw std::runtime_error("Frame buffer must hold at least a frame header");
+         }
+
+         _m_socket = &connection;
+         _m_side = side;
+         _m_max_frame = max_frame;
+
+         _m_buffer.resize(capacity);
+
+         _m_begin = 0;
+         _m_end = 0;
+         _m_consumed = 0;
+
+         _m_frames = 0;
+         _m_reads = 0;
+      }
+
+      bool _next(frame& current)
+      {
+         // The previous frame's view expires here
+         _m_begin += _m_consumed;
+         _m_consumed = 0;
+
+         while (true)
+         {
+            std::size_t available = _m_end - _m_begin;
+            std::size_t needed = frame_header_size;
+
+            if (available >= frame_header_size)
+            {
+               std::size_t size = decode_frame_header(&_m_buffer[_m_begin]);
+
+               if (size > _m_max_frame)
+               {
+                  throw std::runtime_error("Frame of " + std::to_string(size) + " bytes exceeds the " + std::to_string(_m_max_frame) + " byte limit");
+               }
+
+               needed += size;
+
+               if (available >= needed)
+               {
+                  current.data = &_m_buffer[_m_begin + frame_header_size];
+                  current.size = size;
+
+                  _m_consumed = needed;
+
+                  ++_m_frames;
+
+                  return true;
+               }
+            }
+
+            _make_room(needed);
+
+            std::size_t amount_read = _read(&_m_buffer[_m_end], _m_buffer.size() - _m_end);
+
+            if (amount_read == 0)
+            {
+               if (available == 0)
+               {
+                  return false;
+               }
+
+               throw std::runtime_error("Connection closed in the middle of a frame");
+            }
+
+            _m_end += amount_read;
+         }
+      }
+
+      void _make_room(std::size_t needed)
+      {
+         std::size_t available = _m_end - _m_begin;
+
+         // Slide the partial frame to the front once the tail cannot hold
+         // the rest of it; an empty buffer just rewinds
+         if (available == 0)
+         {
+            _m_begin = 0;
+            _m_end = 0;
+         }
+
+         else if (_m_begin + needed > _m_buffer.size())
+         {
+            std::memmove(&_m_buffer[0], &_m_buffer[_m_begin], available);
+
+            _m_begin = 0;
+            _m_end = available;
+         }
+
+         if (needed > _m_buffer.size())
+         {
+            _m_buffer.resize(needed);
+         }
+      }
+
+      std::size_t _read(char* const buffer, std::size_t size)
+      {
+         ++_m_reads;
+
+         return _m_side == side_accepted ? _m_socket->read(buffer, size) : _m_socket->read_back(buffer, size);
+      }
+
+   private: // Member Variables
+
+      socket* _m_socket;
+      frame_side _m_side;
+
+      std::vector<char> _m_buffer;
+
+      // Unread bytes are [_m_begin, _m_end); the frame last handed out is
+      // the first _m_consumed of them
+      std::size_t _m_begin;
+      std::size_t _m_end;
+      std::size_t _m_consumed;
+
+      std::size_t _m_max_frame;
+
+      std::size_t _m_frames;
+      std::size_t _m_reads;
+
+}; // end of class(frame_reader)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class frame_writer
+{
+   public:  // Constructor | Destructor
+
+      frame_writer(socket& connection, frame_side side = side_connected) { _ctor(connection, side); }
+      ~frame_writer() { }
+
+   private: // Holds a reference to the socket, not copyable
+
+      frame_writer(const frame_writer&);
+      frame_writer& operator=(const frame_writer&);
+
+   public:  // Public Member Functions
+
+      // Sends the whole frame before returning
+      void write(const char* const payload, std::size_t size) { _write(payload, size); }
+      void write(const std::string& payload) { _write(payload.data(), payload.size()); }
+
+      std::size_t frames() const { return _m_frames; }
+
+   private: // Private Member Functions
+
+      void _ctor(socket& connection, frame_side side)
+      {
+         _m_socket = &connection;
+         _m_side = side;
+         _m_frames = 0;
+      }
+
+      void _write(const char* const payload, std::size_t size)
+      {
+         if (size > 0xFFFFFFFFULL)
+         {
+            throw std::runtime_error("Frame payload does not fit a 32 bit length");
+         }
+
+         char header[frame_header_size];
+
+         encode_frame_header(header, (std::uint32_t)size);
+
+         #if _WIN32
+            _write_all(header, sizeof(header));
+            _write_all(payload, size);
+         #else
+            socket::segment segments[2];
+
+            segments[0].iov_base = header;
+            segments[0].iov_len = sizeof(header);
+            segments[1].iov_base = (void*)payload;
+            segments[1].iov_len = size;
+
+            std::size_t count = size == 0 ? 1 : 2;
+
+            if (_m_side == side_connected)
+            {
+               _m_socket->write(segments, count);
+            }
+
+            else
+            {
+               _m_socket->write_back(segments, count);
+            }
+         #endif
+
+         ++_m_frames;
+      }
+
+      #if _WIN32
+         void _write_all(const char* const buffer, std::size_t size)
+         {
+            for (std::size_t offset = 0; offset < size; )
+            {
+               offset += _m_side == side_connected ? _m_socket->write(buffer + offset, size - offset) : _m_socket->write_back(buffer + offset, size - offset);
+            }
+         }
+      #endif
+
+   private: // Member Variables
+
+      socket* _m_socket;
+      frame_side _m_side;
+
+      std::size_t _m_frames;
+
+}; // end of class(frame_writer)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __FRAMING_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,306 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: histogram.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// High dynamic range histogram (the HdrHistogram layout). Values from 1 to
+// a configured maximum are kept to a fixed number of significant decimal
+// digits in one preallocated array, so recording is a couple of shifts and
+// an increment and memory does not grow with the sample count. Values above
+// the maximum are clamped to it and counted in overflow().
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __HISTOGRAM_HPP__
+#define __HISTOGRAM_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class histogram
+{
+   public:  // Constructor | Destructor
+
+      // Default range is 1 ns to one minute at three significant digits
+      histogram(std::uint64_t highest_value = 60000000000ULL, int significant_digits = 3) { _ctor(highest_value, significant_digits); }
+      ~histogram() { }
+
+   public:  // Public Member Functions
+
+      void record(std::uint64_t value) { _record(value, 1); }
+      void record(std::uint64_t value, std::uint64_t count) { _record(value, count); }
+      void merge(const histogram& other) { _merge(other); }
+      void reset() { _reset(); }
+
+      std::uint64_t count() const { return _m_total_count; }
+      std::uint64_t max() const { return _m_max; }
+      std::uint64_t min() const { return _m_total_count ? _m_min : 0; }
+      std::uint64_t overflow() const { return _m_overflow; }
+
+      double mean() const { return _mean(); }
+      double stddev() const { return _stddev(); }
+
+      // Smallest recorded value (to the histogram's precision) that at
+      // least percentile percent of the samples are less than or equal to
+      std::uint64_t percentile(double percentile) const { return _percentile(percentile); }
+
+      std::size_t memory_bytes() const { return _m_counts.size() * sizeof(std::uint64_t); }
+
+   private: // Private Member Functions
+
+      void _ctor(std::uint64_t highest_value, int significant_digits)
+      {
+         if (significant_digits < 1 || significant_digits > 5 || highest_value < 2)
+         {
+            throw std::runtime_error("Histogram needs 1 to 5 significant digits and a maximum of at least 2");
+         }
+
+         _m_highest_value = highest_value;
+
+         // Enough linear sub-buckets that 10^digits values are told apart
+         std::uint64_t single_unit_resolution = 2;
+
+         for (int digit = 0; digit < significant_digits; ++digit) single_unit_resolution *= 10;
+
+         _m_sub_bucket_count_magnitude = (int)std::ceil(std::log2((double)single_unit_resolution));
+         _m_sub_bucket_half_count_magnitude = _m_sub_bucket_count_magnitude - 1;
+         _m_sub_bucket_count = 1ULL << _m_sub_bucket_count_magnitude;
+         _m_sub_bucket_half_count = _m_sub_bucket_count / 2;
+         _m_sub_bucket_mask = _m_sub_bucket_count - 1;
+
+         // Each bucket doubles the covered range at the same resolution
+         int buckets = 1;
+
+         for (std::uint64_t smallest_untrackable = _m_sub_bucket_count; smallest_untrackable <= highest_value; smallest_untrackable <<= 1)
+         {
+            ++buckets;
+
+            if (smallest_untrackable > (UINT64_MAX >> 1)) break;
+         }
+
+         _m_bucket_count = buckets;
+
+         _m_counts.assign((std::size_t)(_m_bucket_count + 1) * _m_sub_bucket_half_count, 0);
+
+         _reset();
+      }
+
+      void _reset()
+      {
+         for (std::uint64_t& count : _m_counts) count = 0;
+
+         _m_total_count = 0;
+         _m_overflow = 0;
+         _m_max = 0;
+         _m_min = UINT64_MAX;
+         _m_sum = 0;
+         _m_sum_of_squares = 0;
+      }
+
+      void _record(std::uint64_t value, std::uint64_t count)
+      {
+         if (value > _m_highest_value)
+         {
+            value = _m_highest_value;
+
+            _m_overflow += count;
+         }
+
+         _m_counts[_counts_index(value)] += count;
+
+         _m_total_count += count;
+
+         if (value > _m_max) _m_max = value;
+         if (value < _m_min) _m_min = value;
+
+         _m_sum += (double)value * count;
+         _m_sum_of_squares += (double)value * value * count;
+      }
+
+      void _merge(const histogram& other)
+      {
+         if (other._m_counts.size() != _m_counts.size() || other._m_sub_bucket_count != _m_sub_bucket_count)
+         {
+            throw std::runtime_error("Only histograms with the same range and precision can be merged");
+         }
+
+         for (std::size_t index = 0; index < _m_counts.size(); ++index)
+         {
+            _m_counts[index] += other._m_counts[index];
+         }
+
+         _m_total_count += other._m_total_count;
+         _m_overflow += other._m_overflow;
+         _m_sum += other._m_sum;
+         _m_sum_of_squares += other._m_sum_of_squares;
+
+         if (other._m_total_count && other._m_max > _m_max) _m_max = other._m_max;
+         if (other._m_total_count && other._m_min < _m_min) _m_min = other._m_min;
+      }
+
+      double _mean() const
+      {
+         return _m_total_count ? _m_sum / _m_total_count : 0;
+      }
+
+      double _stddev() const
+      {
+         if (_m_total_count < 2) return 0;
+
+         double mean = _mean();
+         double variance = _m_sum_of_squares / _m_total_count - mean * mean;
+
+         return variance > 0 ? std::sqrt(variance) : 0;
+      }
+
+      std::uint64_t _percentile(double percentile) const
+      {
+         if (_m_total_count == 0) return 0;
+
+         if (percentile > 100) percentile = 100;
+
+         std::uint64_t wanted = (std::uint64_t)std::ceil(percentile / 100.0 * _m_total_count);
+
+         if (wanted == 0) wanted = 1;
+
+         std::uint64_t seen = 0;
+
+         for (std::size_t index = 0; index < _m_counts.size(); ++index)
+         {
+            seen += _m_counts[index];
+
+            if (seen >= wanted)
+            {
+               std::uint64_t value = _highest_equivalent(_value_at(index));
+
+               // Never report beyond what was actually recorded
+               return value < _m_max ? value : _m_max;
+            }
+         }
+
+         return _m_max;
+      }
+
+      int _bucket_index(std::uint64_t value) const
+      {
+         // Position of the highest set bit, with everything below the first
+         // bucket's range folded into bucket zero
+         int pow2_ceiling = 64 - _leading_zeros(value | _m_sub_bucket_mask);
+
+         return pow2_ceiling - (_m_sub_bucket_half_count_magnitude + 1);
+      }
+
+      std::size_t _counts_index(std::uint64_t value) const
+      {
+         int bucket = _bucket_index(value);
+
+         std::uint64_t sub_bucket = value >> bucket;
+
+         std::size_t bucket_base = (std::size_t)(bucket + 1) << _m_sub_bucket_half_count_magnitude;
+
+         return bucket_base + (std::size_t)(sub_bucket - _m_sub_bucket_half_count);
+      }
+
+      std::uint64_t _value_at(std::size_t index) const
+      {
+         int bucket = (int)(index >> _m_sub_bucket_half_count_magnitude) - 1;
+
+         std::uint64_t sub_bucket = (index & (_m_sub_bucket_half_count - 1)) + _m_sub_bucket_half_count;
+
+         if (bucket < 0)
+         {
+            sub_bucket -= _m_sub_bucket_half_count;
+            bucket = 0;
+         }
+
+         return sub_bucket << bucket;
+      }
+
+      std::uint64_t _highest_equivalent(std::uint64_t value) const
+      {
+         int bucket = _bucket_index(value);
+
+         std::uint64_t sub_bucket = value >> bucket;
+
+         int adjusted_bucket = sub_bucket >= _m_sub_bucket_count ? bucket + 1 : bucket;
+
+         std::uint64_t lowest = sub_bucket << bucket;
+
+         return lowest + (1ULL << adjusted_bucket) - 1;
+      }
+
+      static int _leading_zeros(std::uint64_t value)
+      {
+         #if defined(__GNUC__)
+            return value ? __builtin_clzll(value) : 64;
+         #else
+            int zeros = 0;
+
+            for (std::uint64_t bit = 1ULL << 63; bit && !(value & bit); bit >>= 1) ++zeros;
+
+            return zeros;
+         #endif
+      }
+
+   private: // Member Variables
+
+      std::uint64_t _m_highest_value;
+
+      int _m_bucket_count;
+      int _m_sub_bucket_count_magnitude;
+      int _m_sub_bucket_half_count_magnitude;
+
+      std::uint64_t _m_sub_bucket_count;
+      std::uint64_t _m_sub_bucket_half_count;
+      std::uint64_t _m_sub_bucket_mask;
+
+      std::vector<std::uint64_t> _m_counts;
+
+      std::uint64_t _m_total_count;
+      std::uint64_t _m_overflow;
+      std::uint64_t _m_max;
+      std::uint64_t _m_min;
+
+      double _m_sum;
+      double _m_sum_of_squares;
+
+}; // end of class(histogram)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __HISTOGRAM_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of histogram.hpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: integrity.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Chunks that let a receiver check a bulk stream as it arrives. Each one is
+// a 16 byte header and then its body:
+//
+//    0    sequence   64 bits, little endian, 0 for the first chunk
+//    8    length     32 bits, little endian, body bytes
+//    12   crc32c     32 bits, little endian, of bytes 0 to 11 and the body
+//
+// The sender stamps a chunk in place in its payload before writing it.
+// The receiver feeds chunk_verifier whatever each read returned, right
+// after the read while the bytes are still in cache; it follows the
+// chunks across read boundaries and checks each CRC as its last byte
+// arrives. A bad CRC or an out of order sequence number is counted and
+// checking carries on; a length no sender would use means the framing is
+// lost, and the rest of the stream is not checked.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __INTEGRITY_HPP__
+#define __INTEGRITY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "crc32c.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Bodies longer than this mean the receiver has lost the chunk boundaries
+#ifndef EV9_CHUNK_MAX_LENGTH
+#define EV9_CHUNK_MAX_LENGTH (1024 * 1024 * 1024)
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class chunk_verifier
+{
+   public:  // Constants
+
+      static const std::size_t header_size = 16;
+
+   public:  // Constructor | Destructor
+
+      chunk_verifier() { _reset(); }
+      ~chunk_verifier() { }
+
+   public:  // Public Member Functions
+
+      // Fills in the header of a chunk whose body of length bytes follows it
+      static void stamp(char* chunk, std::uint64_t sequence, std::size_t length) { _stamp(chunk, sequence, length); }
+
+      // Checks the next size bytes of the stream
+      void consume(const char* data, std::size_t size) { _consume(data, size); }
+
+      // End of stream: a chunk cut short counts as bad
+      void finish() { _finish(); }
+
+      void reset() { _reset(); }
+
+      std::size_t chunks() const { return _m_chunks; }
+      std::size_t bad_chunks() const { return _m_bad; }
+      bool framing_lost() const { return _m_lost; }
+
+   private: // Private Member Functions
+
+      void _reset()
+      {
+         _m_header_filled = 0;
+         _m_body_left = 0;
+         _m_expected = 0;
+         _m_chunks = 0;
+         _m_bad = 0;
+         _m_lost = false;
+      }
+
+      void _finish()
+      {
+         if (_m_lost || _m_header_filled == 0)
+         {
+            return;
+         }
+
+         ++_m_bad;
+
+         _m_lost = true;
+      }
+
+      static void _stamp(char* chunk, std::uint64_t sequence, std::size_t length)
+      {
+         _put(chunk, sequence, 8);
+         _put(chunk + 8, length, 4);
+
+         crc32c sum;
+
+         sum.update(chunk, 12);
+         sum.update(chunk + header_size, length);
+
+         _put(chunk + 12, sum.value(), 4);
+      }
+
+      void _consume(const char* data, std::size_t size)
+      {
+         while (size != 0 && !_m_lost)
+         {
+            if (_m_header_filled < header_size)
+            {
+               std::size_t amount = std::min(size, header_size - _m_header_filled);
+
+               std::memcpy(_m_header + _m_header_filled, data, amount);
+
+               _m_header_filled += amount;
+               data += amount;
+               size -= amount;
+
+               if (_m_header_filled == header_size)
+               {
+                  _start_body();
+               }
+
+               continue;
+            }
+
+            std::size_t amount = std::min<std::size_t>(size, _m_body_left);
+
+            _m_sum.update(data, amount);
+
+            _m_body_left -= amount;
+            data += amount;
+            size -= amount;
+
+            if (_m_body_left == 0)
+            {
+               _finish_chunk();
+            }
+         }
+      }
+
+      void _start_body()
+      {
+         std::uint64_t sequence = _get(_m_header, 8);
+
+         _m_body_left = _get(_m_header + 8, 4);
+
+         if (_m_body_left > EV9_CHUNK_MAX_LENGTH)
+         {
+            ++_m_bad;
+            _m_lost = true;
+
+            return;
+         }
+
+         // Carry on from whatever the sender says, so one gap is one error
+         if (sequence != _m_expected) ++_m_bad;
+
+         _m_expected = sequence;
+
+         _m_sum.reset();
+         _m_sum.update(_m_header, 12);
+
+         if (_m_body_left == 0)
+         {
+            _finish_chunk();
+         }
+      }
+
+      void _finish_chunk()
+      {
+         if (_m_sum.value() == (std::uint32_t)_get(_m_header + 12, 4)) ++_m_chunks;
+         else ++_m_bad;
+
+         ++_m_expected;
+
+         _m_header_filled = 0;
+      }
+
+      static void _put(char* destination, std::uint64_t value, std::size_t bytes)
+      {
+         for (std::size_t index = 0; index < bytes; ++index)
+         {
+            destination[index] = (char)(value >> (8 * index));
+         }
+      }
+
+      static std::uint64_t _get(const char* source, std::size_t bytes)
+      {
+         std::uint64_t value = 0;
+
+         for (std::size_t index = 0; index < bytes; ++index)
+         {
+            value |= (std::uint64_t)(unsigned char)source[index] << (8 * index);
+         }
+
+         return value;
+      }
+
+   private: // Member Variables
+
+      char _m_header[header_size];
+      std::size_t _m_header_filled;
+      std::size_t _m_body_left;
+
+      std::uint64_t _m_expected;
+      crc32c _m_sum;
+
+      std::size_t _m_chunks;
+      std::size_t _m_bad;
+      bool _m_lost;
+
+}; // end of class(chunk_verifier)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __INTEGRITY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of integrity.hpp
+////////////////////////////////////////////////////////////////////////////////
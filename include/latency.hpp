@@ -0,0 +1,366 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: latency.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Round-trip latency over ev9::socket. The client writes a message, the
+// server echoes it back with write_back, and every round trip after the
+// warmup is recorded into an ev9::histogram in nanoseconds. The client
+// announces the message size in an 8 byte header when it connects, so the
+// server needs no configuration.
+//
+// Both ends run with TCP_NODELAY unless the options given to
+// set_socket_options() turn it off (no_delay 0), since Nagle would hold
+// back the tail of every message above one MSS.
+//
+// set_transport() runs the same exchange over a local transport
+// (local.hpp) on this host, to compare it with TCP over loopback.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __LATENCY_HPP__
+#define __LATENCY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "histogram.hpp"
+#include "socket.hpp"
+#include "transport.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if __linux__
+   #include "local.hpp"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class latency
+{
+   public:  // Type definitions
+
+      typedef std::chrono::steady_clock clock;
+
+   public:  // Constructor | Destructor
+
+      latency(std::size_t port, std::size_t message_size = 64) { _ctor(port, message_size); }
+      ~latency() { _dtor(); }
+
+   public:  // Public Member Functions
+
+      void listen() { _listen(); }
+
+      // Echo messages for one client until it disconnects; returns the
+      // number of round trips served
+      std::size_t serve() { return _serve(); }
+
+      // Ping-pong against host and return the round trip histogram. A
+      // ping that throws drops its connection, so the server sees it end.
+      const histogram& ping(const std::string& host) { return _ping(host); }
+
+      // Server, from another thread: makes a serve() blocked in accept()
+      // fail, for when its client gave up before connecting
+      void interrupt() { if (_m_socket != nullptr) _m_socket->interrupt(); }
+
+      void set_duration(double seconds) { _m_duration = seconds; }
+      void set_iterations(std::size_t iterations) { _m_iterations = iterations; }
+      void set_warmup(std::size_t iterations) { _m_warmup = iterations; }
+
+      // How long ping() retries a server that is not listening yet
+      void set_connect_timeout(double seconds) { _m_connect_timeout = seconds; }
+      void set_socket_options(const socket::options& opts) { _set_socket_options(opts); }
+
+      // Socket options only apply to transport_tcp
+      void set_transport(transport_kind kind) { _m_transport = kind; }
+      transport_kind get_transport() const { return _m_transport; }
+
+      const histogram& samples() const { return _m_histogram; }
+
+      static void print(const char* const label, std::size_t message_size, const histogram& samples) { _print(label, message_size, samples); }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t port, std::size_t message_size)
+      {
+         if (message_size == 0)
+         {
+            throw std::runtime_error("Message size must be greater than zero");
+         }
+
+         _m_port = port;
+         _m_duration = 5;
+         _m_iterations = 0;
+         _m_warmup = 1000;
+         _m_connect_timeout = 5;
+         _m_socket = nullptr;
+         _m_transport = transport_tcp;
+
+         _m_socket_options.no_delay = 1;
+
+         _m_message.assign(message_size, 'p');
+      }
+
+      void _dtor()
+      {
+         if (_m_socket != nullptr) delete _m_socket;
+      }
+
+      void _set_socket_options(const socket::options& opts)
+      {
+         _m_socket_options = opts;
+
+         // Left unset, it keeps the latency default
+         if (opts.no_delay < 0) _m_socket_options.no_delay = 1;
+      }
+
+      void _listen()
+      {
+         if (_m_transport != transport_tcp)
+         {
+            _reset_socket(_make_local());
+         }
+
+         else
+         {
+            ev9::socket* listener = new ev9::socket(_m_port);
+
+            _reset_socket(listener);
+
+            // Accepted connections inherit these
+            listener->set_options(_m_socket_options);
+         }
+
+         _m_socket->bind();
+         _m_socket->listen(EV9_SOCKET_BACKLOG);
+      }
+
+      std::size_t _serve()
+      {
+         if (_m_socket == nullptr)
+         {
+            _listen();
+         }
+
+         _m_socket->accept();
+
+         std::uint64_t message_size = 0;
+
+         const std::uint64_t largest_message = 64 * 1024 * 1024;
+
+         if (_m_socket->read_all((char*)&message_size, sizeof(message_size)) != sizeof(message_size) || message_size == 0 || message_size > largest_message)
+         {
+            _m_socket->close_accepted();
+
+            return 0;
+         }
+
+         std::vector<char> message((std::size_t)message_size);
+
+         std::size_t round_trips = 0;
+
+         while (_m_socket->read_all(&message[0], message.size()) == message.size())
+         {
+            _write_all(true, &message[0], message.size());
+
+            ++round_trips;
+         }
+
+         _m_socket->close_accepted();
+
+         return round_trips;
+      }
+
+      const histogram& _ping(const std::string& host)
+      {
+         try
+         {
+            _round_trips(host);
+         }
+
+         catch (...)
+         {
+            _reset_socket(nullptr);
+
+            throw;
+         }
+
+         return _m_histogram;
+      }
+
+      void _round_trips(const std::string& host)
+      {
+         if (_m_transport != transport_tcp)
+         {
+            _reset_socket(_make_local());
+
+            _m_socket->connect(_m_connect_timeout);
+         }
+
+         else
+         {
+            ev9::socket* connection = new ev9::socket(host, _m_port);
+
+            _reset_socket(connection);
+
+            connection->set_options(_m_socket_options);
+            connection->connect(_m_connect_timeout);
+         }
+
+         std::uint64_t message_size = _m_message.size();
+
+         _write_all(false, (const char*)&message_size, sizeof(message_size));
+
+         std::vector<char> reply(_m_message.size());
+
+         _m_histogram.reset();
+
+         auto start = clock::now();
+
+         for (std::size_t iteration = 0; ; ++iteration)
+         {
+            if (iteration >= _m_warmup)
+            {
+               std::size_t measured = iteration - _m_warmup;
+
+               if (_m_iterations ? measured >= _m_iterations : _seconds_since(start) >= _m_duration) break;
+            }
+
+            auto sent = clock::now();
+
+            _write_all(false, &_m_message[0], _m_message.size());
+
+            if (_m_socket->read_back_all(&reply[0], reply.size()) != reply.size())
+            {
+               throw std::runtime_error("Connection closed during a round trip");
+            }
+
+            auto received = clock::now();
+
+            if (iteration < _m_warmup)
+            {
+               // Measured time starts after the warmup
+               start = received;
+
+               continue;
+            }
+
+            _m_histogram.record((std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(received - sent).count());
+         }
+
+         _reset_socket(nullptr);
+      }
+
+      void _write_all(bool back, const char* buffer, std::size_t size)
+      {
+         while (size)
+         {
+            std::size_t amount_written = back ? _m_socket->write_back(buffer, size) : _m_socket->write(buffer, size);
+
+            buffer += amount_written;
+            size -= amount_written;
+         }
+      }
+
+      void _reset_socket(ev9::transport* socket)
+      {
+         if (_m_socket != nullptr) delete _m_socket;
+
+         _m_socket = socket;
+      }
+
+      transport* _make_local()
+      {
+         #if __linux__
+            return make_local_transport(_m_transport, _m_port);
+         #else
+            throw std::runtime_error("Local transports need Linux");
+         #endif
+      }
+
+      static double _seconds_since(clock::time_point start)
+      {
+         std::chrono::duration<double> elapsed = clock::now() - start;
+
+         return elapsed.count();
+      }
+
+      static void _print(const char* const label, std::size_t message_size, const histogram& samples)
+      {
+         std::printf("[%s] %lu byte messages, %lu round trips, %lu KiB histogram\n",
+                     label,
+                     (unsigned long)message_size,
+                     (unsigned long)samples.count(),
+                     (unsigned long)(samples.memory_bytes() / 1024));
+
+         std::printf("[%s] min %.2f us, mean %.2f us, stddev %.2f us\n",
+                     label,
+                     samples.min() / 1e3,
+                     samples.mean() / 1e3,
+                     samples.stddev() / 1e3);
+
+         std::printf("[%s] p50 %.2f us, p90 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us\n",
+                     label,
+                     samples.percentile(50) / 1e3,
+                     samples.percentile(90) / 1e3,
+                     samples.percentile(99) / 1e3,
+                     samples.percentile(99.9) / 1e3,
+                     samples.max() / 1e3);
+      }
+
+   private: // Member Variables
+
+      // An ev9::socket unless the transport is a local one
+      ev9::transport* _m_socket;
+      transport_kind _m_transport;
+
+      std::size_t _m_port;
+      std::size_t _m_iterations;
+      std::size_t _m_warmup;
+
+      double _m_duration;
+      double _m_connect_timeout;
+
+      std::vector<char> _m_message;
+
+      socket::options _m_socket_options;
+
+      histogram _m_histogram;
+
+}; // end of class(latency)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __LATENCY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of latency.hpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,651 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: local.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Intra-host implementations of ev9::transport, to measure against TCP
+// over loopback:
+//
+//    local_socket    AF_UNIX, as a byte stream (SOCK_STREAM) or as
+//                    messages (SOCK_SEQPACKET: datagrams that keep their
+//                    boundaries, on a connection with an end)
+//    shm_transport   two spsc_rings (ring.hpp) in one memfd, one per
+//                    direction; no system call per message while both
+//                    sides are busy
+//
+// An address is a path, or a name in the abstract namespace when it
+// starts with '@'. make_local_transport() names endpoints after a port
+// number ("@ev9-5201"), so they can stand in for a TCP socket.
+//
+// The shared memory transport meets its peer over a local_socket: accept()
+// creates and maps the memfd and passes it over the new connection with
+// SCM_RIGHTS, connect() receives and maps it. That connection then only
+// tells each side when the other one has gone.
+//
+// Requirements: c++11, Linux (memfd, futex, abstract sockets)
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __LOCAL_HPP__
+#define __LOCAL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "ring.hpp"
+#include "socket.hpp"
+#include "transport.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Largest message a datagram local_socket sends; longer writes go out in
+// pieces of this size, like short writes on a stream
+#ifndef EV9_LOCAL_MESSAGE_SIZE
+#define EV9_LOCAL_MESSAGE_SIZE (64 * 1024)
+#endif
+
+// Bytes in each direction of a shm_transport; a power of two
+#ifndef EV9_SHM_RING_SIZE
+#define EV9_SHM_RING_SIZE (1024 * 1024)
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class local_socket final : public transport
+{
+   public:  // Constructor | Destructor
+
+      local_socket(const std::string& address, bool datagram = false) { _ctor(address, datagram); }
+      ~local_socket() { _dtor(); }
+
+   private: // Owns descriptors, not copyable
+
+      local_socket(const local_socket&);
+      local_socket& operator=(const local_socket&);
+
+   public:  // Public Member Functions
+
+      void accept() { _accept(); }
+      void bind() { _bind(); }
+      void close() { _close(); }
+      void close_accepted() { _close_accepted(); }
+      void connect(double timeout, double retry_delay = 0.001) { _connect(timeout, retry_delay); }
+      void interrupt() { _interrupt(); }
+      void listen() { _listen(EV9_SOCKET_BACKLOG); }
+      void listen(int backlog) { _listen(backlog); }
+
+      std::size_t read(char* const buffer, std::size_t size) { return _read(buffer, size); }
+      std::size_t read_back(char* const buffer, std::size_t size) { return _read_back(buffer, size); }
+      std::size_t write(const char* const buffer, std::size_t size) { return _write(buffer, size); }
+      std::size_t write_back(const char* const buffer, std::size_t size) { return _write_back(buffer, size); }
+
+      int accepted_handle() const { return _m_accepted_fd; }
+      int native_handle() const { return _m_socket_fd; }
+
+      bool datagram() const { return _m_datagram; }
+      const std::string& address() const { return _m_address; }
+
+   private: // Private Member Functions
+
+      void _ctor(const std::string& address, bool datagram)
+      {
+         _m_address = address;
+         _m_datagram = datagram;
+         _m_accepted_fd = -1;
+         _m_socket_fd = -1;
+
+         std::memset(&_m_socket_address, 0, sizeof(_m_socket_address));
+
+         _m_socket_address.sun_family = AF_UNIX;
+
+         bool abstract = !address.empty() && address[0] == '@';
+
+         if (address.size() < (abstract ? 2 : 1) || address.size() >= sizeof(_m_socket_address.sun_path))
+         {
+            throw std::runtime_error("Local socket address \"" + address + "\" is empty or too long");
+         }
+
+         std::memcpy(_m_socket_address.sun_path, address.data(), address.size());
+
+         // Abstract names start with a zero byte and are not terminated
+         if (abstract) _m_socket_address.sun_path[0] = '\0';
+
+         _m_socket_address_size = (socklen_t)(offsetof(sockaddr_un, sun_path) + address.size() + (abstract ? 0 : 1));
+
+         _open();
+      }
+
+      void _dtor()
+      {
+         _close_accepted();
+         _close();
+      }
+
+      void _open()
+      {
+         _m_socket_fd = ::socket(AF_UNIX, (_m_datagram ? SOCK_SEQPACKET : SOCK_STREAM) | SOCK_CLOEXEC, 0);
+
+         if (_m_socket_fd < 0)
+         {
+            throw std::runtime_error(std::string("Unable to create a local socket: ") + std::strerror(errno));
+         }
+      }
+
+      void _accept()
+      {
+         _close_accepted();
+
+         do
+         {
+            _m_accepted_fd = ::accept4(_m_socket_fd, nullptr, nullptr, SOCK_CLOEXEC);
+         }
+         while (_m_accepted_fd < 0 && errno == EINTR);
+
+         if (_m_accepted_fd < 0)
+         {
+            throw std::runtime_error(std::string("Unable to accept on ") + _m_address + ": " + std::strerror(errno));
+         }
+      }
+
+      void _bind()
+      {
+         // A path left behind by an earlier server would fail the bind
+         if (_m_address[0] != '@') ::unlink(_m_address.c_str());
+
+         if (::bind(_m_socket_fd, (const sockaddr*)&_m_socket_address, _m_socket_address_size) != 0)
+         {
+            throw std::runtime_error(std::string("Unable to bind to ") + _m_address + ": " + std::strerror(errno));
+         }
+      }
+
+      void _listen(int backlog)
+      {
+         if (::listen(_m_socket_fd, backlog) != 0)
+         {
+            throw std::runtime_error(std::string("Unable to listen on ") + _m_address + ": " + std::strerror(errno));
+         }
+      }
+
+      void _connect(double timeout, double retry_delay)
+      {
+         typedef std::chrono::steady_clock clock;
+
+         if (timeout < 0 || retry_delay < 0)
+         {
+            throw std::runtime_error("Connect timeout and retry delay cannot be negative");
+         }
+
+         clock::time_point deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout));
+         clock::duration delay = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(retry_delay));
+
+         while (::connect(_m_socket_fd, (const sockaddr*)&_m_socket_address, _m_socket_address_size) != 0)
+         {
+            int error = errno;
+
+            if (error == EINTR)
+            {
+               continue;
+            }
+
+            // Nothing bound to the name yet, or nobody listening on it
+            if ((error != ECONNREFUSED && error != ENOENT) || clock::now() + delay >= deadline)
+            {
+               throw std::runtime_error(std::string("Unable to connect to ") + _m_address + ": " + std::strerror(error));
+            }
+
+            std::this_thread::sleep_for(delay);
+
+            delay = std::min<clock::duration>(delay * 2, std::chrono::milliseconds(100));
+
+            _close();
+            _open();
+         }
+      }
+
+      void _close_accepted()
+      {
+         if (_m_accepted_fd >= 0) ::close(_m_accepted_fd);
+
+         _m_accepted_fd = -1;
+      }
+
+      void _close()
+      {
+         if (_m_socket_fd >= 0) ::close(_m_socket_fd);
+
+         _m_socket_fd = -1;
+      }
+
+      void _interrupt()
+      {
+         if (_m_socket_fd >= 0) ::shutdown(_m_socket_fd, SHUT_RDWR);
+      }
+
+      std::size_t _read(char* const buffer, std::size_t size) { return _read_fd(_m_accepted_fd, buffer, size); }
+      std::size_t _read_back(char* const buffer, std::size_t size) { return _read_fd(_m_socket_fd, buffer, size); }
+      std::size_t _write(const char* const buffer, std::size_t size) { return _write_fd(_m_socket_fd, buffer, size); }
+      std::size_t _write_back(const char* const buffer, std::size_t size) { return _write_fd(_m_accepted_fd, buffer, size); }
+
+      std::size_t _read_fd(int fd, char* const buffer, std::size_t size)
+      {
+         ssize_t amount_read;
+
+         // MSG_TRUNC makes a message read return its full length, so one
+         // that did not fit is reported instead of silently cut short
+         do
+         {
+            amount_read = ::recv(fd, buffer, size, _m_datagram ? MSG_TRUNC : 0);
+         }
+         while (amount_read < 0 && errno == EINTR);
+
+         if (amount_read < 0)
+         {
+            throw std::runtime_error(std::string("Error reading from ") + _m_address + ": " + std::strerror(errno));
+         }
+
+         if ((std::size_t)amount_read > size)
+         {
+            throw std::runtime_error("A " + std::to_string(amount_read) + " byte message did not fit a " + std::to_string(size) + " byte read");
+         }
+
+         return (std::size_t)amount_read;
+      }
+
+      std::size_t _write_fd(int fd, const char* const buffer, std::size_t size)
+      {
+         if (_m_datagram)
+         {
+            size = std::min<std::size_t>(size, EV9_LOCAL_MESSAGE_SIZE);
+         }
+
+         ssize_t amount_written;
+
+         do
+         {
+            amount_written = ::send(fd, buffer, size, MSG_NOSIGNAL);
+         }
+         while (amount_written < 0 && errno == EINTR);
+
+         if (amount_written < 0)
+         {
+            throw std::runtime_error(std::string("Error writing to ") + _m_address + ": " + std::strerror(errno));
+         }
+
+         return (std::size_t)amount_written;
+      }
+
+      const char* _transport_name() const
+      {
+         return _m_datagram ? "unix-datagram" : "unix";
+      }
+
+   private: // Member Variables
+
+      std::string _m_address;
+      bool _m_datagram;
+
+      int _m_accepted_fd;
+      int _m_socket_fd;
+
+      sockaddr_un _m_socket_address;
+      socklen_t _m_socket_address_size;
+
+}; // end of class(local_socket)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class shm_transport final : public transport
+{
+   public:  // Constructor | Destructor
+
+      // ring_size bytes each way, set by the side that accepts
+      shm_transport(const std::string& address, std::size_t ring_size = EV9_SHM_RING_SIZE) : _m_rendezvous(address) { _ctor(ring_size); }
+      ~shm_transport() { _dtor(); }
+
+   private: // Owns the mapping, not copyable
+
+      shm_transport(const shm_transport&);
+      shm_transport& operator=(const shm_transport&);
+
+   public:  // Public Member Functions
+
+      void accept() { _accept(); }
+      void bind() { _bind(); }
+      void close() { _close(); }
+      void close_accepted() { _close_accepted(); }
+      void connect(double timeout, double retry_delay = 0.001) { _connect(timeout, retry_delay); }
+      void interrupt() { _interrupt(); }
+      void listen() { _listen(EV9_SOCKET_BACKLOG); }
+      void listen(int backlog) { _listen(backlog); }
+
+      std::size_t read(char* const buffer, std::size_t size) { return _read(buffer, size); }
+      std::size_t read_back(char* const buffer, std::size_t size) { return _read_back(buffer, size); }
+      std::size_t write(const char* const buffer, std::size_t size) { return _write(buffer, size); }
+      std::size_t write_back(const char* const buffer, std::size_t size) { return _write_back(buffer, size); }
+
+      std::size_t ring_size() const { return _m_ring_size; }
+
+      // Futex sleeps of this side so far, reading and writing
+      std::size_t sleeps() const { return _m_inbound.sleeps() + _m_outbound.sleeps(); }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t ring_size)
+      {
+         if (ring_size < 4096 || (ring_size & (ring_size - 1)) != 0)
+         {
+            throw std::runtime_error("Shared memory ring size must be a power of two of at least 4096");
+         }
+
+         _m_ring_size = ring_size;
+         _m_mapping = nullptr;
+         _m_mapping_size = 0;
+      }
+
+      void _dtor()
+      {
+         _close_accepted();
+         _close();
+      }
+
+      void _bind() { _m_rendezvous.bind(); }
+      void _listen(int backlog) { _m_rendezvous.listen(backlog); }
+
+      void _accept()
+      {
+         _close_accepted();
+
+         _m_rendezvous.accept();
+
+         std::size_t ring_footprint = _align(spsc_ring::footprint(_m_ring_size));
+         std::size_t size = 2 * ring_footprint;
+
+         int memory_fd = ::memfd_create("ev9_shm_transport", MFD_CLOEXEC);
+
+         if (memory_fd < 0 || ::ftruncate(memory_fd, (off_t)size) != 0)
+         {
+            if (memory_fd >= 0) ::close(memory_fd);
+
+            throw std::runtime_error(std::string("Unable to create the shared memory rings: ") + std::strerror(errno));
+         }
+
+         try
+         {
+            _map(memory_fd, size);
+
+            spsc_ring::initialize(_m_mapping, _m_ring_size);
+            spsc_ring::initialize((char*)_m_mapping + ring_footprint, _m_ring_size);
+
+            _send_descriptor(_m_rendezvous.accepted_handle(), memory_fd);
+         }
+
+         catch (...)
+         {
+            ::close(memory_fd);
+
+            _unmap();
+
+            throw;
+         }
+
+         ::close(memory_fd);
+
+         // The first ring carries what the client writes
+         _m_inbound.attach(_m_mapping, _m_rendezvous.accepted_handle());
+         _m_outbound.attach((char*)_m_mapping + ring_footprint, _m_rendezvous.accepted_handle());
+      }
+
+      void _connect(double timeout, double retry_delay)
+      {
+         _m_rendezvous.connect(timeout, retry_delay);
+
+         int memory_fd = _receive_descriptor(_m_rendezvous.native_handle());
+
+         struct stat status;
+
+         if (::fstat(memory_fd, &status) != 0 || status.st_size <= 0)
+         {
+            ::close(memory_fd);
+
+            throw std::runtime_error("Shared memory rings from the server are unusable");
+         }
+
+         try
+         {
+            _map(memory_fd, (std::size_t)status.st_size);
+         }
+
+         catch (...)
+         {
+            ::close(memory_fd);
+
+            throw;
+         }
+
+         ::close(memory_fd);
+
+         std::size_t ring_footprint = _m_mapping_size / 2;
+
+         _m_outbound.attach(_m_mapping, _m_rendezvous.native_handle());
+         _m_inbound.attach((char*)_m_mapping + ring_footprint, _m_rendezvous.native_handle());
+      }
+
+      // The server's end of a connection
+      void _close_accepted()
+      {
+         _hang_up();
+
+         _m_rendezvous.close_accepted();
+      }
+
+      // The client's end of a connection, and the rendezvous socket
+      void _close()
+      {
+         _hang_up();
+
+         _m_rendezvous.close();
+      }
+
+      // Rings only exist once connected; the rendezvous does the waiting
+      void _interrupt() { _m_rendezvous.interrupt(); }
+
+      void _hang_up()
+      {
+         _m_inbound.close_reader();
+         _m_outbound.close_writer();
+
+         _unmap();
+      }
+
+      std::size_t _read(char* const buffer, std::size_t size) { return _m_inbound.read(buffer, size); }
+      std::size_t _read_back(char* const buffer, std::size_t size) { return _m_inbound.read(buffer, size); }
+      std::size_t _write(const char* const buffer, std::size_t size) { return _m_outbound.write(buffer, size); }
+      std::size_t _write_back(const char* const buffer, std::size_t size) { return _m_outbound.write(buffer, size); }
+
+      const char* _transport_name() const
+      {
+         return "shm";
+      }
+
+      void _map(int memory_fd, std::size_t size)
+      {
+         void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memory_fd, 0);
+
+         if (memory == MAP_FAILED)
+         {
+            throw std::runtime_error(std::string("Unable to map the shared memory rings: ") + std::strerror(errno));
+         }
+
+         _m_mapping = memory;
+         _m_mapping_size = size;
+      }
+
+      void _unmap()
+      {
+         if (_m_mapping != nullptr) ::munmap(_m_mapping, _m_mapping_size);
+
+         _m_mapping = nullptr;
+         _m_mapping_size = 0;
+      }
+
+      static std::size_t _align(std::size_t size)
+      {
+         std::size_t page = (std::size_t)::sysconf(_SC_PAGESIZE);
+
+         return (size + page - 1) / page * page;
+      }
+
+      static void _send_descriptor(int connection, int fd)
+      {
+         char byte = 0;
+
+         iovec data;
+
+         data.iov_base = &byte;
+         data.iov_len = 1;
+
+         char control[CMSG_SPACE(sizeof(int))];
+
+         std::memset(control, 0, sizeof(control));
+
+         msghdr message;
+
+         std::memset(&message, 0, sizeof(message));
+
+         message.msg_iov = &data;
+         message.msg_iovlen = 1;
+         message.msg_control = control;
+         message.msg_controllen = sizeof(control);
+
+         cmsghdr* header = CMSG_FIRSTHDR(&message);
+
+         header->cmsg_level = SOL_SOCKET;
+         header->cmsg_type = SCM_RIGHTS;
+         header->cmsg_len = CMSG_LEN(sizeof(int));
+
+         std::memcpy(CMSG_DATA(header), &fd, sizeof(int));
+
+         if (::sendmsg(connection, &message, MSG_NOSIGNAL) != 1)
+         {
+            throw std::runtime_error(std::string("Unable to pass the shared memory to the client: ") + std::strerror(errno));
+         }
+      }
+
+      static int _receive_descriptor(int connection)
+      {
+         char byte = 0;
+
+         iovec data;
+
+         data.iov_base = &byte;
+         data.iov_len = 1;
+
+         char control[CMSG_SPACE(sizeof(int))];
+
+         msghdr message;
+
+         std::memset(&message, 0, sizeof(message));
+
+         message.msg_iov = &data;
+         message.msg_iovlen = 1;
+         message.msg_control = control;
+         message.msg_controllen = sizeof(control);
+
+         ssize_t amount_read;
+
+         do
+         {
+            amount_read = ::recvmsg(connection, &message, MSG_CMSG_CLOEXEC);
+         }
+         while (amount_read < 0 && errno == EINTR);
+
+         cmsghdr* header = amount_read == 1 ? CMSG_FIRSTHDR(&message) : nullptr;
+
+         if (header == nullptr || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+         {
+            throw std::runtime_error("The server did not send its shared memory");
+         }
+
+         int fd;
+
+         std::memcpy(&fd, CMSG_DATA(header), sizeof(int));
+
+         return fd;
+      }
+
+   private: // Member Variables
+
+      local_socket _m_rendezvous;
+
+      std::size_t _m_ring_size;
+
+      void* _m_mapping;
+      std::size_t _m_mapping_size;
+
+      spsc_ring _m_inbound;
+      spsc_ring _m_outbound;
+
+}; // end of class(shm_transport)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// A local transport standing in for a TCP socket on this port
+inline transport* make_local_transport(transport_kind kind, std::size_t port)
+{
+   std::string address = "@ev9-" + std::to_string(port);
+
+   switch (kind)
+   {
+      case transport_unix: return new local_socket(address);
+      case transport_unix_datagram: return new local_socket(address, true);
+      case transport_shm: return new shm_transport(address);
+      default: throw std::runtime_error(std::string(transport_kind_name(kind)) + " is not a local transport");
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __LOCAL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
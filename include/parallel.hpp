@@ -0,0 +1,373 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: parallel.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Runs N ev9::bandwidth streams between the same two hosts, each on its own
+// thread and socket. Stream i uses port + i. Senders connect first and then
+// start together from one timestamp, so with a duration they also stop
+// together. Reports per-stream and aggregate throughput and Jain's fairness
+// index over the per-stream rates.
+//
+// With a placement (see topology.hpp) each stream thread pins itself to
+// its CPU set and moves its payload onto the node it runs on before the
+// stream starts. Every stream line shows the CPU and buffer node it used.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __PARALLEL_HPP__
+#define __PARALLEL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bandwidth.hpp"
+#include "topology.hpp"
+
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class parallel_bandwidth
+{
+   public:  // Type definitions
+
+      typedef std::vector<bandwidth::result> results;
+
+   public:  // Constructor | Destructor
+
+      parallel_bandwidth(std::size_t port, std::size_t streams, std::size_t payload_size = 128 * 1024) { _ctor(port, streams, payload_size); }
+      ~parallel_bandwidth() { _dtor(); }
+
+   private: // Owns its streams, not copyable
+
+      parallel_bandwidth(const parallel_bandwidth&);
+      parallel_bandwidth& operator=(const parallel_bandwidth&);
+
+   public:  // Public Member Functions
+
+      void listen() { _listen(); }
+      results receive() { return _receive(); }
+      results send(const std::string& host) { return _send(host); }
+
+      // Receiver, from another thread: makes every stream's receive()
+      // that is blocked in accept() fail
+      void interrupt() { for (bandwidth* stream : _m_streams) stream->interrupt(); }
+
+      // Applies to every stream; the byte count is per stream
+      void set_byte_count(std::size_t bytes) { for (bandwidth* stream : _m_streams) stream->set_byte_count(bytes); }
+      void set_duration(double seconds) { for (bandwidth* stream : _m_streams) stream->set_duration(seconds); }
+      void set_interval(double seconds) { for (bandwidth* stream : _m_streams) stream->set_interval(seconds); }
+      void set_send_file(const std::string& path) { for (bandwidth* stream : _m_streams) stream->set_send_file(path); }
+      void set_send_mode(bandwidth::send_mode mode) { for (bandwidth* stream : _m_streams) stream->set_send_mode(mode); }
+      void set_backend(bandwidth::backend kind) { for (bandwidth* stream : _m_streams) stream->set_backend(kind); }
+      void set_socket_options(const socket::options& opts) { for (bandwidth* stream : _m_streams) stream->set_socket_options(opts); }
+      void set_transport(transport_kind kind) { for (bandwidth* stream : _m_streams) stream->set_transport(kind); }
+      void set_verify(bool verify) { for (bandwidth* stream : _m_streams) stream->set_verify(verify); }
+
+      // Placed streams map their own payloads on their nodes instead
+      void set_buffer_pool(buffer_pool* pool) { for (bandwidth* stream : _m_streams) stream->set_buffer_pool(pool); }
+
+      // Where the stream threads run; placement_none leaves them to the
+      // scheduler and the payloads wherever they were first touched
+      void set_placement(placement policy) { _set_placement(policy); }
+
+      // e.g. "scatter cpus 0,4,1,5", for the report
+      const std::string& placement_description() const { return _m_placement_description; }
+
+      std::size_t streams() const { return _m_streams.size(); }
+
+      static bandwidth::result aggregate(const results& res) { return _aggregate(res); }
+      static double fairness(const results& res) { return _fairness(res); }
+      static void print(const char* const label, const results& res) { _print(label, res); }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t port, std::size_t streams, std::size_t payload_size)
+      {
+         if (streams == 0)
+         {
+            throw std::runtime_error("At least one stream is required");
+         }
+
+         for (std::size_t index = 0; index < streams; ++index)
+         {
+            _m_streams.push_back(new bandwidth(port + index, payload_size));
+         }
+
+         _m_placement_description = placement_name(placement_none);
+      }
+
+      void _set_placement(placement policy)
+      {
+         _m_plan = _m_topology.place(policy, _m_streams.size());
+         _m_placement_description = _m_topology.describe(policy, _m_plan);
+
+         if (policy == placement_none)
+         {
+            _m_plan.clear();
+         }
+      }
+
+      void _dtor()
+      {
+         for (bandwidth* stream : _m_streams)
+         {
+            delete stream;
+         }
+      }
+
+      void _listen()
+      {
+         for (bandwidth* stream : _m_streams)
+         {
+            stream->listen();
+         }
+      }
+
+      results _receive()
+      {
+         results res(_m_streams.size());
+
+         _run_all([&](std::size_t index)
+         {
+            res[index] = _m_streams[index]->receive();
+         });
+
+         return res;
+      }
+
+      results _send(const std::string& host)
+      {
+         results res(_m_streams.size());
+
+         std::mutex mutex;
+         std::condition_variable released;
+
+         std::size_t connected = 0;
+         bool failed = false;
+
+         bandwidth::clock::time_point start;
+
+         _run_all([&](std::size_t index)
+         {
+            bool connect_failed = false;
+
+            try
+            {
+               _m_streams[index]->connect(host);
+            }
+
+            catch (...)
+            {
+               connect_failed = true;
+            }
+
+            {
+               std::unique_lock<std::mutex> lock(mutex);
+
+               failed = failed || connect_failed;
+
+               // The last stream to connect fixes the shared start time
+               if (++connected == _m_streams.size())
+               {
+                  start = bandwidth::clock::now();
+
+                  released.notify_all();
+               }
+
+               else
+               {
+                  released.wait(lock, [&]() { return connected == _m_streams.size(); });
+               }
+            }
+
+            if (connect_failed)
+            {
+               throw std::runtime_error("Unable to connect stream " + std::to_string(index));
+            }
+
+            // Streams whose peers could not connect would skew the rest
+            if (failed)
+            {
+               _m_streams[index]->close();
+
+               return;
+            }
+
+            res[index] = _m_streams[index]->stream(start);
+         });
+
+         return res;
+      }
+
+      template <typename function_type> void _run_all(const function_type& function)
+      {
+         std::vector<std::thread> threads;
+         std::vector<std::exception_ptr> errors(_m_streams.size());
+
+         for (std::size_t index = 0; index < _m_streams.size(); ++index)
+         {
+            threads.push_back(std::thread([&, index]()
+            {
+               try
+               {
+                  if (!_m_plan.empty())
+                  {
+                     _place(index);
+                  }
+
+                  function(index);
+               }
+
+               catch (...)
+               {
+                  errors[index] = std::current_exception();
+               }
+            }));
+         }
+
+         for (std::thread& thread : threads)
+         {
+            thread.join();
+         }
+
+         for (std::exception_ptr& error : errors)
+         {
+            if (error) std::rethrow_exception(error);
+         }
+      }
+
+      // Runs on the stream's own thread, so the payload is first touched
+      // from where it will be used
+      void _place(std::size_t index)
+      {
+         const topology::cpu_set& set = _m_plan[index];
+
+         // Not fatal: a sender failing here would leave the others waiting
+         // for it to connect, and the result shows the CPU it really used
+         topology::pin_current(set);
+
+         if (!set.empty())
+         {
+            _m_streams[index]->set_buffer_node(_m_topology.node_of(set[0]));
+         }
+      }
+
+      static bandwidth::result _aggregate(const results& res)
+      {
+         bandwidth::result total;
+
+         for (const bandwidth::result& stream : res)
+         {
+            total.bytes += stream.bytes;
+            total.syscalls += stream.syscalls;
+            total.cpu_seconds += stream.cpu_seconds;
+            total.cycles += stream.cycles;
+            total.zerocopy_copied += stream.zerocopy_copied;
+            total.uring = total.uring || stream.uring;
+            total.verified = total.verified || stream.verified;
+            total.chunks += stream.chunks;
+            total.bad_chunks += stream.bad_chunks;
+            total.minor_faults += stream.minor_faults;
+            total.major_faults += stream.major_faults;
+
+            // Streams overlap, so wall time is the longest of them
+            if (stream.seconds > total.seconds) total.seconds = stream.seconds;
+
+            for (std::size_t index = 0; index < stream.intervals.size(); ++index)
+            {
+               if (total.intervals.size() <= index) total.intervals.push_back(0);
+
+               total.intervals[index] += stream.intervals[index];
+            }
+         }
+
+         return total;
+      }
+
+      static double _fairness(const results& res)
+      {
+         // Jain's index: (sum x)^2 / (n * sum x^2), 1 when all rates match
+         double sum = 0;
+         double sum_of_squares = 0;
+
+         for (const bandwidth::result& stream : res)
+         {
+            sum += stream.gbits();
+            sum_of_squares += stream.gbits() * stream.gbits();
+         }
+
+         return sum_of_squares > 0 ? (sum * sum) / (res.size() * sum_of_squares) : 0;
+      }
+
+      static void _print(const char* const label, const results& res)
+      {
+         for (std::size_t index = 0; index < res.size(); ++index)
+         {
+            std::printf("[%s] stream %3lu: %lu bytes, %.3f s, %.3f Gbit/s, cpu %d, buffer node %d\n",
+                        label,
+                        (unsigned long)index,
+                        (unsigned long)res[index].bytes,
+                        res[index].seconds,
+                        res[index].gbits(),
+                        res[index].cpu,
+                        res[index].buffer_node);
+         }
+
+         bandwidth::print(label, _aggregate(res));
+
+         std::printf("[%s] %lu streams on %u cores, fairness (Jain) %.4f\n",
+                     label,
+                     (unsigned long)res.size(),
+                     std::thread::hardware_concurrency(),
+                     _fairness(res));
+      }
+
+   private: // Member Variables
+
+      std::vector<bandwidth*> _m_streams;
+
+      topology _m_topology;
+      topology::plan _m_plan;
+      std::string _m_placement_description;
+
+}; // end of class(parallel_bandwidth)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __PARALLEL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of parallel.hpp
+////////////////////////////////////////////////////////////////////////////////
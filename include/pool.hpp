@@ -0,0 +1,306 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: pool.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Warm TCP connections, kept per host and port. acquire() hands out the
+// most recently returned idle connection to that endpoint, or connects a
+// new one with a deadline, so a run of short exchanges pays for one
+// handshake instead of one each.
+//
+// A lease gives its connection back only through release(). A lease that
+// is dropped closes its connection, so one left half way through an
+// exchange by an exception never goes back. Idle connections that the
+// peer has closed, or that have unread bytes waiting, are thrown away
+// when they are next picked. The pool must outlive its leases.
+//
+// bandwidth::set_connection_pool() runs repeated throughput probes over
+// one of these connections (bandwidth_test -R).
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __POOL_HPP__
+#define __POOL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "socket.hpp"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class connection_pool
+{
+   public:  // Inner Classes
+
+      class lease
+      {
+         public:  // Constructor | Destructor
+
+            lease() : _m_pool(nullptr) { }
+            lease(lease&& other) : _m_pool(other._m_pool), _m_key(std::move(other._m_key)), _m_socket(std::move(other._m_socket)) { other._m_pool = nullptr; }
+            ~lease() { }
+
+            lease& operator=(lease&& other)
+            {
+               _m_pool = other._m_pool;
+               _m_key = std::move(other._m_key);
+               _m_socket = std::move(other._m_socket);
+
+               other._m_pool = nullptr;
+
+               return *this;
+            }
+
+         private: // Owns the connection, not copyable
+
+            lease(const lease&);
+            lease& operator=(const lease&);
+
+         public:  // Public Member Functions
+
+            socket& operator*() const { return *_m_socket; }
+            socket* operator->() const { return _m_socket.get(); }
+            socket* get() const { return _m_socket.get(); }
+
+            explicit operator bool() const { return _m_socket != nullptr; }
+
+            // Hands the connection back for reuse; the lease is empty after
+            void release()
+            {
+               if (_m_pool != nullptr && _m_socket != nullptr) _m_pool->_release(_m_key, std::move(_m_socket));
+
+               _m_pool = nullptr;
+            }
+
+         private: // Private Member Functions
+
+            friend class connection_pool;
+
+            lease(connection_pool* pool, const std::string& key, std::unique_ptr<socket> connection) : _m_pool(pool), _m_key(key), _m_socket(std::move(connection)) { }
+
+         private: // Member Variables
+
+            connection_pool* _m_pool;
+            std::string _m_key;
+            std::unique_ptr<socket> _m_socket;
+
+      }; // end of class(lease)
+
+   public:  // Constructor | Destructor
+
+      // Keeps at most max_idle connections per endpoint; new connections
+      // give up after connect_timeout seconds
+      connection_pool(std::size_t max_idle = 8, double connect_timeout = 5) { _ctor(max_idle, connect_timeout); }
+      ~connection_pool() { }
+
+   private: // Holds the connections, not copyable
+
+      connection_pool(const connection_pool&);
+      connection_pool& operator=(const connection_pool&);
+
+   public:  // Public Member Functions
+
+      lease acquire(const std::string& host, std::size_t port) { return _acquire(host, port); }
+
+      // Closes every idle connection
+      void clear() { _clear(); }
+
+      // Applied to every new connection
+      void set_socket_options(const socket::options& opts) { _set_socket_options(opts); }
+
+      std::size_t idle() const { return _idle(); }
+
+      // Leases served warm, leases that had to connect, and idle
+      // connections thrown away as closed or unclean
+      std::size_t hits() const { return _m_hits; }
+      std::size_t misses() const { return _m_misses; }
+      std::size_t stale() const { return _m_stale; }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t max_idle, double connect_timeout)
+      {
+         _m_max_idle = max_idle;
+         _m_connect_timeout = connect_timeout;
+
+         _m_options_set = false;
+
+         _m_hits = 0;
+         _m_misses = 0;
+         _m_stale = 0;
+      }
+
+      lease _acquire(const std::string& host, std::size_t port)
+      {
+         std::string key = host + ":" + std::to_string(port);
+
+         {
+            std::lock_guard<std::mutex> lock(_m_lock);
+
+            std::vector<std::unique_ptr<socket> >& idle = _m_idle[key];
+
+            while (!idle.empty())
+            {
+               std::unique_ptr<socket> connection = std::move(idle.back());
+
+               idle.pop_back();
+
+               if (_clean(connection->native_handle()))
+               {
+                  ++_m_hits;
+
+                  return lease(this, key, std::move(connection));
+               }
+
+               ++_m_stale;
+            }
+
+            ++_m_misses;
+         }
+
+         // Connect outside the lock so other endpoints are not held up
+         std::unique_ptr<socket> connection(new socket(host, port));
+
+         socket::options opts;
+         bool options_set;
+
+         {
+            std::lock_guard<std::mutex> lock(_m_lock);
+
+            opts = _m_options;
+            options_set = _m_options_set;
+         }
+
+         if (options_set) connection->set_options(opts);
+
+         connection->connect(_m_connect_timeout);
+
+         return lease(this, key, std::move(connection));
+      }
+
+      void _release(const std::string& key, std::unique_ptr<socket> connection)
+      {
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         std::vector<std::unique_ptr<socket> >& idle = _m_idle[key];
+
+         if (idle.size() < _m_max_idle)
+         {
+            idle.push_back(std::move(connection));
+         }
+      }
+
+      void _clear()
+      {
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         _m_idle.clear();
+      }
+
+      void _set_socket_options(const socket::options& opts)
+      {
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         _m_options = opts;
+         _m_options_set = true;
+      }
+
+      std::size_t _idle() const
+      {
+         std::lock_guard<std::mutex> lock(_m_lock);
+
+         std::size_t count = 0;
+
+         for (const auto& entry : _m_idle)
+         {
+            count += entry.second.size();
+         }
+
+         return count;
+      }
+
+      // An idle connection should have nothing to read: readable means the
+      // peer closed it, reset it or sent bytes nobody asked for
+      static bool _clean(socket::descriptor fd)
+      {
+         #if _WIN32
+            fd_set readable;
+
+            FD_ZERO(&readable);
+            FD_SET(fd, &readable);
+
+            timeval wait;
+
+            wait.tv_sec = 0;
+            wait.tv_usec = 0;
+
+            return ::select(0, &readable, nullptr, nullptr, &wait) == 0;
+         #else
+            pollfd entry;
+
+            entry.fd = fd;
+            entry.events = POLLIN;
+            entry.revents = 0;
+
+            return ::poll(&entry, 1, 0) == 0;
+         #endif
+      }
+
+   private: // Member Variables
+
+      mutable std::mutex _m_lock;
+
+      std::map<std::string, std::vector<std::unique_ptr<socket> > > _m_idle;
+
+      std::size_t _m_max_idle;
+      double _m_connect_timeout;
+
+      socket::options _m_options;
+      bool _m_options_set;
+
+      // Read without the lock
+      std::atomic<std::size_t> _m_hits;
+      std::atomic<std::size_t> _m_misses;
+      std::atomic<std::size_t> _m_stale;
+
+}; // end of class(connection_pool)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __POOL_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
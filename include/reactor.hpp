@@ -0,0 +1,499 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: reactor.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Single threaded epoll event loop. Listening ev9::sockets and every
+// connection accepted from them are non-blocking and edge-triggered, so a
+// readable or writable handler must keep going until would_block() before
+// it returns. Connections that reach end of stream or fail are closed by the
+// reactor once their handler returns.
+//
+// Requirements: c++11, Linux (epoll)
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __REACTOR_HPP__
+#define __REACTOR_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "socket.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class reactor
+{
+   public:  // Inner Classes
+
+      class connection
+      {
+         public:  // Constructor | Destructor
+
+            connection(int fd) { _ctor(fd); }
+            ~connection() { _dtor(); }
+
+         private: // Owns the descriptor, not copyable
+
+            connection(const connection&);
+            connection& operator=(const connection&);
+
+         public:  // Public Member Functions
+
+            int fd() const { return _m_fd; }
+
+            // Both return the bytes moved. A zero means either that the
+            // kernel has nothing more for now (would_block()) or, for read,
+            // that the peer closed the connection (end_of_stream()).
+            std::size_t read(char* const buffer, std::size_t size) { return _read(buffer, size); }
+            std::size_t write(const char* const buffer, std::size_t size) { return _write(buffer, size); }
+
+            bool end_of_stream() const { return _m_end_of_stream; }
+            bool would_block() const { return _m_would_block; }
+
+            // Free for the owner of the handlers to use
+            void* context;
+
+         private: // Private Member Functions
+
+            void _ctor(int fd)
+            {
+               context = nullptr;
+
+               _m_fd = fd;
+               _m_end_of_stream = false;
+               _m_would_block = false;
+               _m_failed = false;
+               _m_closing = false;
+            }
+
+            void _dtor()
+            {
+               if (_m_fd >= 0) ::close(_m_fd);
+            }
+
+            std::size_t _read(char* const buffer, std::size_t size)
+            {
+               _m_would_block = false;
+
+               while (true)
+               {
+                  ssize_t amount_read = ::read(_m_fd, buffer, size);
+
+                  if (amount_read > 0)
+                  {
+                     return (std::size_t)amount_read;
+                  }
+
+                  if (amount_read == 0)
+                  {
+                     _m_end_of_stream = true;
+                  }
+
+                  else if (errno == EINTR)
+                  {
+                     continue;
+                  }
+
+                  else if (errno == EAGAIN || errno == EWOULDBLOCK)
+                  {
+                     _m_would_block = true;
+                  }
+
+                  else
+                  {
+                     _m_failed = true;
+                  }
+
+                  return 0;
+               }
+            }
+
+            std::size_t _write(const char* const buffer, std::size_t size)
+            {
+               _m_would_block = false;
+
+               while (true)
+               {
+                  ssize_t amount_written = ::send(_m_fd, buffer, size, MSG_NOSIGNAL);
+
+                  if (amount_written >= 0)
+                  {
+                     return (std::size_t)amount_written;
+                  }
+
+                  if (errno == EINTR)
+                  {
+                     continue;
+                  }
+
+                  if (errno == EAGAIN || errno == EWOULDBLOCK)
+                  {
+                     _m_would_block = true;
+                  }
+
+                  else
+                  {
+                     _m_failed = true;
+                  }
+
+                  return 0;
+               }
+            }
+
+         private: // Member Variables
+
+            friend class reactor;
+
+            int _m_fd;
+
+            bool _m_end_of_stream;
+            bool _m_would_block;
+            bool _m_failed;
+            bool _m_closing;
+
+      }; // end of class(connection)
+
+   public:  // Type definitions
+
+      typedef std::function<void(connection&)> handler;
+
+   private: // Private Inner Class
+
+      // What an epoll event's data pointer refers to
+      class entry
+      {
+         public:  // Constructor
+
+            entry() : listener_fd(-1), connection(nullptr) { }
+
+         public:  // Member Variables
+
+            int listener_fd;
+
+            reactor::connection* connection;
+
+            handler on_accept;
+            handler on_readable;
+            handler on_writable;
+
+      }; // end of class(entry)
+
+   public:  // Constructor | Destructor
+
+      reactor(std::size_t max_events = 256) { _ctor(max_events); }
+      ~reactor() { _dtor(); }
+
+   private: // Owns the epoll descriptor, not copyable
+
+      reactor(const reactor&);
+      reactor& operator=(const reactor&);
+
+   public:  // Public Member Functions
+
+      // listener must already be bound and listening. on_accept runs for each
+      // new connection before its first readable or writable callback.
+      void listen(ev9::socket& listener, const handler& on_accept, const handler& on_readable, const handler& on_writable = handler()) { _listen(listener, on_accept, on_readable, on_writable); }
+
+      void close(connection& conn) { _close(conn); }
+
+      std::size_t run_once(int timeout_milliseconds = -1) { return _run_once(timeout_milliseconds); }
+      void run() { _run(); }
+      void stop() { _stop(); }
+
+      std::size_t connections() const { return _m_connections.load(); }
+      std::size_t wakeups() const { return _m_wakeups; }
+      std::size_t events() const { return _m_events; }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t max_events)
+      {
+         _m_stopped = false;
+         _m_connections = 0;
+         _m_wakeups = 0;
+         _m_events = 0;
+
+         _m_ready.resize(max_events ? max_events : 1);
+
+         _m_epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+
+         if (_m_epoll_fd < 0)
+         {
+            throw std::runtime_error("Unable to create the epoll instance");
+         }
+
+         // stop() writes here so a blocked epoll_wait returns
+         _m_wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+         if (_m_wake_fd < 0)
+         {
+            ::close(_m_epoll_fd);
+
+            throw std::runtime_error("Unable to create the reactor's eventfd");
+         }
+
+         _register(_m_wake_fd, EPOLLIN, nullptr);
+      }
+
+      void _dtor()
+      {
+         for (entry* current : _m_entries)
+         {
+            if (current->connection != nullptr) delete current->connection;
+
+            delete current;
+         }
+
+         ::close(_m_wake_fd);
+         ::close(_m_epoll_fd);
+      }
+
+      void _listen(ev9::socket& listener, const handler& on_accept, const handler& on_readable, const handler& on_writable)
+      {
+         listener.set_non_blocking(true);
+
+         entry* current = new entry();
+
+         current->listener_fd = listener.native_handle();
+         current->on_accept = on_accept;
+         current->on_readable = on_readable;
+         current->on_writable = on_writable;
+
+         _m_entries.push_back(current);
+
+         _register(current->listener_fd, EPOLLIN | EPOLLET, current);
+      }
+
+      void _accept(entry& listener)
+      {
+         // Edge-triggered: take everything that is queued
+         while (true)
+         {
+            int fd = ::accept4(listener.listener_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+            if (fd < 0)
+            {
+               if (errno == EINTR || errno == ECONNABORTED) continue;
+
+               if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+
+               throw std::runtime_error("Unable to accept a connection");
+            }
+
+            entry* current = new entry();
+
+            current->connection = new connection(fd);
+            current->on_readable = listener.on_readable;
+            current->on_writable = listener.on_writable;
+
+            _m_entries.push_back(current);
+
+            ++_m_connections;
+
+            if (listener.on_accept) listener.on_accept(*current->connection);
+
+            if (current->connection->_m_closing) continue;
+
+            // Data that arrived before registration still raises an edge
+            _register(fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, current);
+         }
+      }
+
+      void _close(connection& conn)
+      {
+         if (conn._m_closing) return;
+
+         conn._m_closing = true;
+
+         ::epoll_ctl(_m_epoll_fd, EPOLL_CTL_DEL, conn._m_fd, nullptr);
+
+         // Deleted after the current batch; later events in it may still
+         // point at this connection.
+         _m_closed.push_back(conn._m_fd);
+
+         --_m_connections;
+      }
+
+      void _collect_closed()
+      {
+         if (_m_closed.empty()) return;
+
+         std::size_t kept = 0;
+
+         for (std::size_t index = 0; index < _m_entries.size(); ++index)
+         {
+            entry* current = _m_entries[index];
+
+            if (current->connection != nullptr && current->connection->_m_closing)
+            {
+               delete current->connection;
+               delete current;
+
+               continue;
+            }
+
+            _m_entries[kept++] = current;
+         }
+
+         _m_entries.resize(kept);
+         _m_closed.clear();
+      }
+
+      void _dispatch(entry& current, unsigned int events)
+      {
+         if (current.connection == nullptr)
+         {
+            _accept(current);
+
+            return;
+         }
+
+         connection& conn = *current.connection;
+
+         if (conn._m_closing) return;
+
+         if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && current.on_readable)
+         {
+            current.on_readable(conn);
+         }
+
+         if ((events & EPOLLOUT) && current.on_writable && !conn._m_closing)
+         {
+            current.on_writable(conn);
+         }
+
+         if (conn._m_end_of_stream || conn._m_failed || (events & EPOLLERR))
+         {
+            _close(conn);
+         }
+      }
+
+      void _register(int fd, unsigned int events, entry* current)
+      {
+         epoll_event event;
+
+         event.events = events;
+         event.data.ptr = current;
+
+         if (::epoll_ctl(_m_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+         {
+            throw std::runtime_error("Unable to register the descriptor with epoll");
+         }
+      }
+
+      std::size_t _run_once(int timeout_milliseconds)
+      {
+         int count = ::epoll_wait(_m_epoll_fd, &_m_ready[0], (int)_m_ready.size(), timeout_milliseconds);
+
+         if (count < 0)
+         {
+            if (errno == EINTR) return 0;
+
+            throw std::runtime_error("Error waiting on epoll");
+         }
+
+         ++_m_wakeups;
+
+         _m_events += (std::size_t)count;
+
+         for (int index = 0; index < count; ++index)
+         {
+            entry* current = (entry*)_m_ready[index].data.ptr;
+
+            if (current == nullptr)
+            {
+               unsigned long long value;
+
+               while (::read(_m_wake_fd, &value, sizeof(value)) > 0) { }
+
+               continue;
+            }
+
+            _dispatch(*current, _m_ready[index].events);
+         }
+
+         _collect_closed();
+
+         return (std::size_t)count;
+      }
+
+      void _run()
+      {
+         while (!_m_stopped.load())
+         {
+            _run_once(-1);
+         }
+
+         _m_stopped = false;
+      }
+
+      void _stop()
+      {
+         _m_stopped = true;
+
+         unsigned long long value = 1;
+
+         if (::write(_m_wake_fd, &value, sizeof(value)) < 0)
+         {
+            // Counter saturated; a wakeup is already pending
+         }
+      }
+
+   private: // Member Variables
+
+      int _m_epoll_fd;
+      int _m_wake_fd;
+
+      std::atomic<bool> _m_stopped;
+
+      std::atomic<std::size_t> _m_connections;
+      std::size_t _m_wakeups;
+      std::size_t _m_events;
+
+      std::vector<epoll_event> _m_ready;
+      std::vector<entry*> _m_entries;
+      std::vector<int> _m_closed;
+
+}; // end of class(reactor)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __REACTOR_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of reactor.hpp
+////////////////////////////////////////////////////////////////////////////////
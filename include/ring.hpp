@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: ring.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Single producer, single consumer byte ring for memory shared between two
+// threads or processes. Control words sit in front of the data, each side's
+// counters on a cache line of their own. head and tail count every byte
+// ever written and read, so the ring is full when they differ by the
+// capacity and the data offset is the count masked by capacity - 1.
+//
+// Neither side takes a lock. A side with nothing to do spins briefly, then
+// raises its waiting flag and sleeps on a futex; the other side bumps the
+// futex word and wakes it only when that flag is up, so a busy stream makes
+// no system calls at all.
+//
+// The futexes are process-shared. A peer that dies without closing its end
+// is noticed through an optional descriptor (its end of a socket pair, say)
+// that the sleeping side polls for hang-up every few milliseconds.
+//
+// Requirements: c++11, Linux (futex)
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __RING_HPP__
+#define __RING_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Empty polls of the ring before a side goes to sleep on the futex
+#ifndef EV9_RING_SPIN
+#define EV9_RING_SPIN 1000
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class spsc_ring
+{
+   private: // Shared control block, at the start of the ring's memory
+
+      class control
+      {
+         public:
+
+            // Written by the producer
+            alignas(64) std::atomic<std::uint64_t> head;
+            std::atomic<std::uint32_t> writer_closed;
+
+            // Written by the consumer
+            alignas(64) std::atomic<std::uint64_t> tail;
+            std::atomic<std::uint32_t> reader_closed;
+
+            // Futex words and the flags that say someone sleeps on them
+            alignas(64) std::atomic<std::uint32_t> data_signal;
+            std::atomic<std::uint32_t> reader_waiting;
+            alignas(64) std::atomic<std::uint32_t> space_signal;
+            std::atomic<std::uint32_t> writer_waiting;
+
+            alignas(64) std::uint64_t capacity;
+
+      }; // end of class(control)
+
+   public:  // Constructor | Destructor
+
+      spsc_ring() : _m_control(nullptr), _m_data(nullptr), _m_mask(0), _m_peer_fd(-1), _m_sleeps(0) { }
+      ~spsc_ring() { }
+
+   public:  // Public Member Functions
+
+      // Bytes of shared memory a ring of this capacity needs
+      static std::size_t footprint(std::size_t capacity) { return sizeof(control) + capacity; }
+
+      // One side formats the memory, which must be zeroed and 64 byte
+      // aligned; capacity must be a power of two. Both sides then attach.
+      static void initialize(void* memory, std::size_t capacity) { _initialize(memory, capacity); }
+      void attach(void* memory, int peer_fd = -1) { _attach(memory, peer_fd); }
+
+      // Blocks until at least one byte fits and returns how many went in;
+      // throws once the reader has closed
+      std::size_t write(const char* const buffer, std::size_t size) { return _write(buffer, size); }
+
+      // Blocks until at least one byte is there; 0 once the writer has
+      // closed and everything it wrote has been read
+      std::size_t read(char* const buffer, std::size_t size) { return _read(buffer, size); }
+
+      void close_writer() { _close(true); }
+      void close_reader() { _close(false); }
+
+      std::size_t capacity() const { return _m_mask + 1; }
+      std::size_t buffered() const { return _m_control != nullptr ? (std::size_t)(_m_control->head - _m_control->tail) : 0; }
+
+      // Times this side slept on the futex
+      std::size_t sleeps() const { return _m_sleeps; }
+
+   private: // Private Member Functions
+
+      static void _initialize(void* memory, std::size_t capacity)
+      {
+         if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+         {
+            throw std::runtime_error("Ring capacity must be a power of two");
+         }
+
+         static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "Shared rings need lock-free atomics");
+
+         control* block = new (memory) control();
+
+         block->head = 0;
+         block->tail = 0;
+         block->writer_closed = 0;
+         block->reader_closed = 0;
+         block->data_signal = 0;
+         block->reader_waiting = 0;
+         block->space_signal = 0;
+         block->writer_waiting = 0;
+         block->capacity = capacity;
+      }
+
+      void _attach(void* memory, int peer_fd)
+      {
+         _m_control = (control*)memory;
+         _m_data = (char*)memory + sizeof(control);
+         _m_mask = (std::size_t)_m_control->capacity - 1;
+         _m_peer_fd = peer_fd;
+      }
+
+      std::size_t _write(const char* const buffer, std::size_t size)
+      {
+         control& block = *_m_control;
+
+         std::uint64_t head = block.head.load(std::memory_order_relaxed);
+         std::uint64_t tail = block.tail.load(std::memory_order_acquire);
+
+         while (head - tail > _m_mask)
+         {
+            if (block.reader_closed.load(std::memory_order_acquire))
+            {
+               break;
+            }
+
+            _wait(block.space_signal, block.writer_waiting, [&]() { return block.tail.load() != tail || block.reader_closed.load() != 0; });
+
+            tail = block.tail.load(std::memory_order_acquire);
+         }
+
+         if (block.reader_closed.load(std::memory_order_acquire))
+         {
+            throw std::runtime_error("Shared memory ring closed by the reader");
+         }
+
+         std::size_t amount = std::min<std::size_t>(size, _m_mask + 1 - (head - tail));
+         std::size_t offset = (std::size_t)head & _m_mask;
+         std::size_t first = std::min(amount, _m_mask + 1 - offset);
+
+         std::memcpy(_m_data + offset, buffer, first);
+         std::memcpy(_m_data, buffer + first, amount - first);
+
+         // Sequentially consistent, so either the reader sees the new head
+         // or we see its waiting flag
+         block.head.store(head + amount);
+
+         _wake(block.data_signal, block.reader_waiting);
+
+         return amount;
+      }
+
+      std::size_t _read(char* const buffer, std::size_t size)
+      {
+         control& block = *_m_control;
+
+         std::uint64_t tail = block.tail.load(std::memory_order_relaxed);
+         std::uint64_t head = block.head.load(std::memory_order_acquire);
+
+         while (head == tail)
+         {
+            if (block.writer_closed.load(std::memory_order_acquire))
+            {
+               // Bytes written just before the close still count
+               head = block.head.load(std::memory_order_acquire);
+
+               if (head == tail) return 0;
+
+               break;
+            }
+
+            _wait(block.data_signal, block.reader_waiting, [&]() { return block.head.load() != tail || block.writer_closed.load() != 0; });
+
+            head = block.head.load(std::memory_order_acquire);
+         }
+
+         std::size_t amount = std::min<std::size_t>(size, head - tail);
+         std::size_t offset = (std::size_t)tail & _m_mask;
+         std::size_t first = std::min(amount, _m_mask + 1 - offset);
+
+         std::memcpy(buffer, _m_data + offset, first);
+         std::memcpy(buffer + first, _m_data, amount - first);
+
+         block.tail.store(tail + amount);
+
+         _wake(block.space_signal, block.writer_waiting);
+
+         return amount;
+      }
+
+      void _close(bool writer)
+      {
+         if (_m_control == nullptr)
+         {
+            return;
+         }
+
+         if (writer)
+         {
+            _m_control->writer_closed.store(1);
+
+            _wake(_m_control->data_signal, _m_control->reader_waiting);
+         }
+
+         else
+         {
+            _m_control->reader_closed.store(1);
+
+            _wake(_m_control->space_signal, _m_control->writer_waiting);
+         }
+
+         _m_control = nullptr;
+      }
+
+      template <typename condition> void _wait(std::atomic<std::uint32_t>& signal, std::atomic<std::uint32_t>& waiting, const condition& ready)
+      {
+         for (int spin = 0; spin < EV9_RING_SPIN; ++spin)
+         {
+            if (ready()) return;
+         }
+
+         std::uint32_t seen = signal.load();
+
+         waiting.store(1);
+
+         // The other side checks the flag after publishing, so a change it
+         // made before seeing the flag is caught here
+         if (!ready())
+         {
+            ++_m_sleeps;
+
+            timespec timeout;
+
+            timeout.tv_sec = 0;
+            timeout.tv_nsec = 10 * 1000 * 1000;
+
+            ::syscall(SYS_futex, (std::uint32_t*)&signal, FUTEX_WAIT, seen, _m_peer_fd >= 0 ? &timeout : nullptr, nullptr, 0);
+
+            if (_m_peer_fd >= 0 && !ready() && _peer_gone())
+            {
+               // Treat a dead peer as a closed one
+               (&waiting == &_m_control->reader_waiting ? _m_control->writer_closed : _m_control->reader_closed).store(1);
+            }
+         }
+
+         waiting.store(0);
+      }
+
+      static void _wake(std::atomic<std::uint32_t>& signal, std::atomic<std::uint32_t>& waiting)
+      {
+         if (waiting.load() == 0)
+         {
+            return;
+         }
+
+         waiting.store(0);
+
+         signal.fetch_add(1);
+
+         ::syscall(SYS_futex, (std::uint32_t*)&signal, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+      }
+
+      bool _peer_gone() const
+      {
+         pollfd entry;
+
+         entry.fd = _m_peer_fd;
+         entry.events = POLLIN | POLLRDHUP;
+         entry.revents = 0;
+
+         return ::poll(&entry, 1, 0) > 0 && (entry.revents & (POLLHUP | POLLRDHUP | POLLERR)) != 0;
+      }
+
+   private: // Member Variables
+
+      control* _m_control;
+      char* _m_data;
+
+      std::size_t _m_mask;
+
+      int _m_peer_fd;
+
+      std::size_t _m_sleeps;
+
+}; // end of class(spsc_ring)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __RING_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: server.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Multi-threaded TCP server with one SO_REUSEPORT listener per worker.
+// The kernel spreads incoming connections over the listeners, so there is
+// no shared accept queue or lock, and each worker accepts and serves its
+// own connections one at a time on the thread that accepted them. At most
+// one connection per worker is served at a time: the kernel picks the
+// listener by hash (or by CPU), not by load, so a connection can wait in a
+// busy worker's accept queue while another worker is idle.
+//
+// Worker i is pinned to the i-th CPU the process may run on and marks its
+// listener with SO_INCOMING_CPU. With one worker per CPU, and those CPUs
+// numbered 0 to n-1, a classic BPF program also tells the kernel to pick
+// the listener of the CPU the connection arrived on, so a connection is
+// accepted and served on the core that took its packets.
+//
+// Requirements: c++11, Linux (SO_REUSEPORT balancing)
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __SERVER_HPP__
+#define __SERVER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "socket.hpp"
+#include "topology.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <linux/filter.h>
+#include <sys/socket.h>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class sharded_server
+{
+   public:  // Type definitions
+
+      // Called once per accepted connection on the worker that accepted it.
+      // The connection is the worker's listener: read() and write_back()
+      // reach the client. It is closed when the handler returns.
+      typedef std::function<void(socket& connection, std::size_t worker)> handler;
+
+   public:  // Constructor | Destructor
+
+      // Zero workers means one per CPU the process may run on
+      sharded_server(std::size_t port, std::size_t workers = 0, int backlog = EV9_SOCKET_BACKLOG) { _ctor(port, workers, backlog); }
+      ~sharded_server() { _dtor(); }
+
+   private: // Owns threads and listeners, not copyable
+
+      sharded_server(const sharded_server&);
+      sharded_server& operator=(const sharded_server&);
+
+   public:  // Public Member Functions
+
+      // Applied to every listener, and so to every accepted connection
+      void set_socket_options(const socket::options& opts) { _m_options = opts; _m_options_set = true; }
+
+      // Binds and listens on every shard before returning, so clients can
+      // connect straight away, then starts the workers
+      void start(const handler& serve) { _start(serve); }
+
+      // Wakes blocked accepts and joins the workers; a handler that is
+      // still busy with a client is waited for
+      void stop() { _stop(); }
+
+      std::size_t workers() const { return _m_worker_count; }
+      int backlog() const { return _m_backlog; }
+
+      // CPU worker i is pinned to, or -1 if pinning failed
+      int worker_cpu(std::size_t worker) const { return _m_cpus.at(worker); }
+
+      // Whether connections are steered to the listener of their CPU
+      bool steered() const { return _m_steered; }
+
+      std::size_t accepted() const { return _accepted(); }
+      std::size_t accepted(std::size_t worker) const { return *_m_accepted.at(worker); }
+
+      // Handlers that threw; the server carries on with the next client
+      std::size_t failed() const { return _m_failed; }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t port, std::size_t workers, int backlog)
+      {
+         if (backlog <= 0)
+         {
+            throw std::runtime_error("Listen backlog must be greater than zero");
+         }
+
+         _m_port = port;
+         _m_backlog = backlog;
+
+         _m_options_set = false;
+         _m_running = false;
+         _m_stopping = false;
+         _m_steered = false;
+         _m_failed = 0;
+
+         // Allowed CPUs in id order, so worker i lands on the i-th of them
+         topology layout;
+
+         std::vector<int> allowed;
+
+         for (const topology::cpu& cpu : layout.cpus())
+         {
+            allowed.push_back(cpu.id);
+         }
+
+         _m_worker_count = workers > 0 ? workers : allowed.size();
+
+         for (std::size_t worker = 0; worker < _m_worker_count; ++worker)
+         {
+            _m_cpus.push_back(allowed[worker % allowed.size()]);
+            _m_accepted.push_back(std::unique_ptr<std::atomic<std::size_t> >(new std::atomic<std::size_t>(0)));
+         }
+
+         // The steering program maps CPU c to listener c % n, which only
+         // lines up with the pinning when worker i runs on CPU i
+         _m_steerable = _m_worker_count == allowed.size();
+
+         for (std::size_t worker = 0; worker < _m_worker_count; ++worker)
+         {
+            _m_steerable = _m_steerable && _m_cpus[worker] == (int)worker;
+         }
+      }
+
+      void _dtor()
+      {
+         _stop();
+      }
+
+      void _start(const handler& serve)
+      {
+         if (_m_running)
+         {
+            throw std::runtime_error("sharded_server::start() called twice");
+         }
+
+         _m_serve = serve;
+         _m_stopping = false;
+
+         // Left over from a start() whose bind failed
+         _m_listeners.clear();
+
+         for (std::size_t worker = 0; worker < _m_worker_count; ++worker)
+         {
+            std::unique_ptr<socket> listener(new socket(_m_port));
+
+            if (_m_options_set) listener->set_options(_m_options);
+
+            listener->set_reuse_port(true);
+
+            // A hint only; kernels without it still balance by hash
+            int cpu = _m_cpus[worker];
+
+            ::setsockopt(listener->native_handle(), SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu));
+
+            listener->bind();
+            listener->listen(_m_backlog);
+
+            _m_listeners.push_back(std::move(listener));
+         }
+
+         _m_steered = _m_steerable && _steer(_m_listeners[0]->native_handle());
+
+         _m_running = true;
+
+         for (std::size_t worker = 0; worker < _m_worker_count; ++worker)
+         {
+            _m_threads.push_back(std::thread(&sharded_server::_work, this, worker));
+
+            if (!topology::pin(_m_threads.back(), topology::cpu_set(1, _m_cpus[worker])))
+            {
+               _m_cpus[worker] = -1;
+            }
+         }
+      }
+
+      void _stop()
+      {
+         if (!_m_running)
+         {
+            return;
+         }
+
+         _m_stopping = true;
+
+         // A blocked accept() returns with EINVAL once its listener is shut
+         for (std::unique_ptr<socket>& listener : _m_listeners)
+         {
+            ::shutdown(listener->native_handle(), SHUT_RDWR);
+         }
+
+         for (std::thread& thread : _m_threads)
+         {
+            thread.join();
+         }
+
+         _m_threads.clear();
+         _m_listeners.clear();
+
+         _m_running = false;
+      }
+
+      void _work(std::size_t worker)
+      {
+         socket& listener = *_m_listeners[worker];
+
+         while (!_m_stopping)
+         {
+            try
+            {
+               listener.accept();
+            }
+
+            catch (std::runtime_error&)
+            {
+               if (_m_stopping)
+               {
+                  break;
+               }
+
+               // Out of descriptors or an aborted handshake; try again
+               std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+               continue;
+            }
+
+            ++*_m_accepted[worker];
+
+            try
+            {
+               _m_serve(listener, worker);
+            }
+
+            catch (std::exception&)
+            {
+               ++_m_failed;
+            }
+
+            listener.close_accepted();
+         }
+      }
+
+      std::size_t _accepted() const
+      {
+         std::size_t total = 0;
+
+         for (const std::unique_ptr<std::atomic<std::size_t> >& count : _m_accepted)
+         {
+            total += *count;
+         }
+
+         return total;
+      }
+
+      // Attaches "return this CPU's listener" to the reuseport group
+      bool _steer(socket::descriptor fd)
+      {
+         #ifdef SO_ATTACH_REUSEPORT_CBPF
+            sock_filter code[] =
+            {
+               { BPF_LD | BPF_W | BPF_ABS, 0, 0, (std::uint32_t)(SKF_AD_OFF + SKF_AD_CPU) },
+               { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (std::uint32_t)_m_worker_count },
+               { BPF_RET | BPF_A, 0, 0, 0 }
+            };
+
+            sock_fprog program;
+
+            program.len = sizeof(code) / sizeof(code[0]);
+            program.filter = code;
+
+            return ::setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) == 0;
+         #else
+            (void)fd;
+
+            return false;
+         #endif
+      }
+
+   private: // Member Variables
+
+      std::size_t _m_port;
+      std::size_t _m_worker_count;
+      int _m_backlog;
+
+      socket::options _m_options;
+      bool _m_options_set;
+
+      handler _m_serve;
+
+      std::vector<std::unique_ptr<socket> > _m_listeners;
+      std::vector<std::thread> _m_threads;
+
+      std::vector<int> _m_cpus;
+      std::vector<std::unique_ptr<std::atomic<std::size_t> > > _m_accepted;
+
+      bool _m_running;
+      std::atomic<bool> _m_stopping;
+
+      bool _m_steerable;
+      bool _m_steered;
+
+      std::atomic<std::size_t> _m_failed;
+
+}; // end of class(sharded_server)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __SERVER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -12,6 +12,10 @@
 //
 // Notes:
 //
+// TCP and UDP over IPv4. The socket is the tcp implementation of
+// ev9::transport (transport.hpp); it is final, so its own calls are never
+// dispatched through the virtual table.
+//
 // Requirements: POSIX threads
 //
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,11 +32,20 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
 #if _WIN32
 
 #include <windows.h>
@@ -44,10 +57,28 @@
 
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
+#include <poll.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+
+#endif
+
+#include "transport.hpp"
+
+#if __linux__
+
+#include "uring.hpp"
+
+#include <deque>
+
+#include <linux/errqueue.h>
+#include <sys/sendfile.h>
 
 #endif
 
@@ -59,18 +90,79 @@ namespace ev9 {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-#define BUFFER_SIZE 256
+// Default size of the per-socket receive buffer used by the std::vector
+// reads. Override at compile time or per socket with set_buffer_size().
+#ifndef EV9_SOCKET_BUFFER_SIZE
+#define EV9_SOCKET_BUFFER_SIZE (64 * 1024)
+#endif
+
+// Pending connection queue for listen() without an argument. The kernel
+// caps it at net.core.somaxconn.
+#ifndef EV9_SOCKET_BACKLOG
+#define EV9_SOCKET_BACKLOG SOMAXCONN
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-class socket
+class socket final : public transport
 {
+   public:  // Type definitions
+
+      #if _WIN32
+         typedef SOCKET descriptor;
+      #else
+         typedef int descriptor;
+
+         // One buffer of a scatter-gather batch
+         typedef iovec segment;
+      #endif
+
+      enum protocol
+      {
+         protocol_tcp,
+         protocol_udp
+      };
+
+      // Kernel tuning for set_options(). Zero, false, empty and unset (-1)
+      // fields leave the kernel default.
+      class options
+      {
+         public:  // Constructor
+
+            options() : send_buffer(0), receive_buffer(0), no_delay(-1), cork(false), quick_ack(false), busy_poll(0) { }
+
+         public:  // Member Variables
+
+            // SO_SNDBUF and SO_RCVBUF in bytes. Linux doubles the value and
+            // stops autotuning that direction. Set them before connect() or
+            // listen() so the window scale is chosen with them.
+            std::size_t send_buffer;
+            std::size_t receive_buffer;
+
+            // TCP_NODELAY: 1 on, 0 off, -1 unset, which leaves the kernel
+            // default or lets the caller pick its own (latency turns it on)
+            int no_delay;
+
+            // TCP_CORK and TCP_QUICKACK (Linux). The kernel can drop out of
+            // quick ack mode again; it is only set on each new connection.
+            bool cork;
+            bool quick_ack;
+
+            // SO_BUSY_POLL in microseconds (Linux, raising it may need
+            // CAP_NET_ADMIN)
+            unsigned int busy_poll;
+
+            // TCP_CONGESTION algorithm name (Linux)
+            std::string congestion;
+
+      }; // end of class(options)
+
    public:  // Constructor | Destructor
 
-      socket(std::size_t port) { _ctor(port); }
-      socket(const char* const ip, std::size_t port) { _ctor(port, ip); }
-      socket(const std::string& host_name, std::size_t port) { _ctor(port, host_name); }
+      socket(std::size_t port, protocol type = protocol_tcp) { _ctor(port, nullptr, type); }
+      socket(const char* const ip, std::size_t port, protocol type = protocol_tcp) { _ctor(port, ip, type); }
+      socket(const std::string& host_name, std::size_t port, protocol type = protocol_tcp) { _ctor(port, host_name, type); }
       ~socket() { _dtor(); }
 
    public:  // Public member functions
@@ -78,14 +170,157 @@ class socket
       void accept() { _accept(); }
       void bind() { _bind(); }
       void close() { _close(); }
+      void close_accepted() { _close_accepted(); }
       void connect() { _connect(); }
-      void listen() { _listen(); }
+
+      // From another thread: shuts the socket down, so a blocked accept()
+      // fails and a blocked UDP read returns nothing. Only close() is left
+      // after it.
+      void interrupt() { _interrupt(); }
+
+      // Gives up with an exception once timeout seconds have passed. A
+      // refused attempt (nothing listening yet) is retried on a fresh
+      // descriptor after retry_delay, doubling up to 100 ms. Options from
+      // set_options() carry over to the new descriptor; a receive timeout
+      // or non-blocking mode set before connect() does not.
+      void connect(double timeout, double retry_delay = 0.001) { _connect(timeout, retry_delay); }
+
+      // For event loops (async.hpp): makes the socket non-blocking, starts
+      // the connect and returns at once with 0 when connected, EINPROGRESS
+      // while the handshake runs, or the error. Once the socket turns
+      // writable connect_error() says how the handshake ended.
+      int connect_non_blocking() { return _connect_non_blocking(); }
+      int connect_error() const { return _connect_error(); }
+      void listen() { _listen(EV9_SOCKET_BACKLOG); }
+      void listen(int backlog) { _listen(backlog); }
       void read(std::vector<char>& buffer) { _read(buffer); }
+      std::size_t read(char* const buffer, std::size_t size) { return _read(buffer, size); }
+      std::size_t read_all(char* const buffer, std::size_t size) { return _read_all(_m_accepted_fd, buffer, size); }
       void read_back(std::vector<char>& buffer) { _read_back(buffer); }
+      std::size_t read_back(char* const buffer, std::size_t size) { return _read_back(buffer, size); }
+      std::size_t read_back_all(char* const buffer, std::size_t size) { return _read_all(_m_socket_fd, buffer, size); }
+
+      #if __cplusplus >= 202002L
+         std::size_t read(std::span<char> buffer) { return _read(buffer.data(), buffer.size()); }
+         std::size_t read_back(std::span<char> buffer) { return _read_fd(_m_socket_fd, buffer.data(), buffer.size()); }
+      #endif
+
+      std::size_t buffer_size() const { return _m_buffer.size(); }
+      void set_buffer_size(std::size_t size) { _set_buffer_size(size); }
+
+      // Raw descriptors for event loops; the socket keeps ownership
+      descriptor accepted_handle() const { return _m_accepted_fd; }
+      descriptor native_handle() const { return _m_socket_fd; }
+
+      void set_non_blocking(bool non_blocking) { _set_non_blocking(_m_socket_fd, non_blocking); }
+
+      // SO_REUSEPORT, before bind(): every socket bound to the port with it
+      // set shares the incoming connections (Linux balances them)
+      void set_reuse_port(bool reuse) { _set_reuse_port(reuse); }
+
       void write(const char* const message) { _write(message); }
       void write(const std::string& message) { _write(message); }
+      std::size_t write(const char* const buffer, std::size_t size) { return _write(buffer, size); }
       void write_back(const char* const message) { _write_back(message); }
       void write_back(const std::string& message) { _write_back(message); }
+      std::size_t write_back(const char* const buffer, std::size_t size) { return _write_back(buffer, size); }
+
+      // Zero-copy transmit (Linux). send_file() moves file pages straight
+      // into the socket. write_zerocopy() pins the caller's pages instead of
+      // copying them; the buffer must stay untouched until reap_zerocopy()
+      // has accounted for the send.
+      std::size_t send_file(int file_fd, std::size_t offset, std::size_t size) { return _send_file(file_fd, offset, size); }
+      void enable_zerocopy() { _enable_zerocopy(); }
+      std::size_t write_zerocopy(const char* const buffer, std::size_t size) { return _write_zerocopy(buffer, size); }
+      std::size_t reap_zerocopy(bool wait) { return _reap_zerocopy(wait); }
+      std::size_t zerocopy_pending() const { return _m_zerocopy_sent - _m_zerocopy_completed; }
+      std::size_t zerocopy_copied() const { return _m_zerocopy_copied; }
+
+      #if !_WIN32
+         // Scatter-gather I/O. Each call moves every byte of every segment
+         // (reads stop early only at end of stream) using as few readv or
+         // writev calls as the kernel allows, and returns the byte count.
+         std::size_t read(const segment* const segments, std::size_t count) { return _transfer_vector(_m_accepted_fd, segments, count, false); }
+         std::size_t read_back(const segment* const segments, std::size_t count) { return _transfer_vector(_m_socket_fd, segments, count, false); }
+         std::size_t write(const segment* const segments, std::size_t count) { return _transfer_vector(_m_socket_fd, segments, count, true); }
+         std::size_t write(const std::vector<segment>& segments) { return _transfer_vector(_m_socket_fd, segments.data(), segments.size(), true); }
+         std::size_t write_back(const segment* const segments, std::size_t count) { return _transfer_vector(_m_accepted_fd, segments, count, true); }
+         std::size_t write_back(const std::vector<segment>& segments) { return _transfer_vector(_m_accepted_fd, segments.data(), segments.size(), true); }
+
+         // Number of readv/writev calls made so far
+         std::size_t vector_calls() const { return _m_vector_calls; }
+
+         // Datagram batches (UDP). The server binds and reads, the client
+         // connects and writes, both on this socket. Each segment is one
+         // datagram, or with GSO enabled up to 64 datagrams of the GSO size
+         // that the kernel splits. Returns how many segments went or
+         // arrived; reads fill sizes[] and, for GRO-coalesced buffers,
+         // segment_sizes[] with the size of the datagrams inside (0 when
+         // not coalesced), and return 0 when the receive timeout expires.
+         // With enable_timestamps() on, arrivals[] gets the time the kernel
+         // received each datagram, in nanoseconds since the epoch (0 when it
+         // carried none; a GRO buffer carries its first datagram's).
+         std::size_t write_datagrams(const segment* const datagrams, std::size_t count) { return _write_datagrams(datagrams, count); }
+         std::size_t read_datagrams(const segment* const buffers, std::size_t count, std::size_t* sizes, std::size_t* segment_sizes = nullptr, std::int64_t* arrivals = nullptr) { return _read_datagrams(buffers, count, sizes, segment_sizes, arrivals); }
+
+         // Number of sendmmsg/recvmmsg (or per-datagram) calls made so far
+         std::size_t datagram_calls() const { return _m_datagram_calls; }
+      #endif
+
+      protocol type() const { return _m_protocol; }
+
+      // UDP segmentation and receive offload (Linux 4.18/5.0+); false when
+      // the kernel does not support them
+      bool enable_gso(std::size_t segment_size) { return _enable_udp_offload(true, (int)segment_size); }
+      bool enable_gro() { return _enable_udp_offload(false, 1); }
+
+      // Kernel receive timestamps (SO_TIMESTAMPNS) for read_datagrams;
+      // false when the platform has none
+      bool enable_timestamps() { return _enable_timestamps(); }
+
+      // 0 blocks forever; otherwise reads give up after this long
+      void set_receive_timeout(double seconds) { _set_receive_timeout(seconds); }
+
+      // Applies to this socket, the accepted connection and every later
+      // one; throws naming the option the kernel refused
+      void set_options(const options& opts) { _set_options(opts); }
+      const options& get_options() const { return _m_options; }
+
+      // What the kernel reports for the connection (the accepted one on a
+      // server), including doubled buffer sizes
+      options effective_options() const { return _effective_options(); }
+
+      // Congestion control algorithms the kernel lets TCP_CONGESTION pick
+      static std::vector<std::string> congestion_controls() { return _congestion_controls(); }
+
+      // Optional io_uring backend (Linux). Once enabled, reads, writes and
+      // accept() go through a ring on registered descriptors: accept and
+      // receive are multishot (receives land in provided buffers and are
+      // copied out), vectored writes go in as one linked batch, and writes
+      // from register_buffer() memory use WRITE_FIXED. Returns false and
+      // keeps the classic calls when io_uring is not available.
+      bool use_uring(unsigned int depth = 64) { return _use_uring(depth); }
+      bool register_buffer(const char* const buffer, std::size_t size) { return _register_buffer(buffer, size); }
+
+      #if __linux__
+         bool uring_enabled() const { return _m_uring != nullptr; }
+         std::size_t ring_enters() const { return _m_uring != nullptr ? _m_uring->enters() : 0; }
+      #else
+         bool uring_enabled() const { return false; }
+         std::size_t ring_enters() const { return 0; }
+      #endif
+
+   private: // io_uring completion tags, the low byte of user_data
+
+      #if __linux__
+         enum ring_tag
+         {
+            tag_operation = 1,
+            tag_receive = 2,     // + slot
+            tag_accept = 4,
+            tag_ignore = 5
+         };
+      #endif
 
    private: // Private member functions
 
@@ -97,6 +332,19 @@ class socket
             socklen_t client_length = sizeof(sockaddr_in);
          #endif
 
+         // Only one accepted connection is tracked; release the previous one
+         // rather than leaking it.
+         _close_accepted();
+
+         #if __linux__
+            if (_m_uring != nullptr && _m_uring_multishot_accept && _uring_accept())
+            {
+               if (_m_options_set) _apply_options(_m_accepted_fd);
+
+               return;
+            }
+         #endif
+
          _m_accepted_fd = ::accept(_m_socket_fd, (sockaddr *)&_m_client_address, &client_length);
 
          // -1 on failure
@@ -104,7 +352,7 @@ class socket
          {
             std::string err = "Unable to connect to socket - error number: ";
             
-            err += errno;
+            err += std::to_string(errno);
             
             err += " -- ";
             
@@ -118,10 +366,18 @@ class socket
             
             throw std::runtime_error(err);
          }
+
+         // Most options are inherited from the listener, but not all
+         if (_m_options_set) _apply_options(_m_accepted_fd);
       }
 
       void _bind()
       {
+         // Allow the port to be rebound while an earlier run is in TIME_WAIT
+         int reuse = 1;
+
+         ::setsockopt(_m_socket_fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
          auto return_value = ::bind(_m_socket_fd, (const sockaddr*)&_m_server_address, sizeof(_m_server_address));
          
          if (return_value != 0)
@@ -130,16 +386,49 @@ class socket
          }
       }
    
-      void _ctor(std::size_t port, const std::string& host_name)
+      void _ctor(std::size_t port, const std::string& host_name, protocol type)
       {
-         hostent* host_ent;
-         
-         host_ent = ::gethostbyname(host_name.c_str());
-         
-         _ctor(port, host_ent->h_name);
+         #if _WIN32
+            hostent* host_ent;
+
+            host_ent = ::gethostbyname(host_name.c_str());
+
+            if (host_ent == nullptr || host_ent->h_addr_list[0] == nullptr)
+            {
+               throw std::runtime_error("Unable to resolve host name: " + host_name);
+            }
+
+            in_addr address;
+
+            memcpy(&address, host_ent->h_addr_list[0], sizeof(in_addr));
+
+            _ctor(port, ::inet_ntoa(address), type);
+         #else
+            // getaddrinfo is reentrant, gethostbyname shares one static
+            // result between threads
+            addrinfo hints;
+            addrinfo* found = nullptr;
+
+            memset(&hints, 0, sizeof(hints));
+
+            hints.ai_family = AF_INET;
+
+            if (::getaddrinfo(host_name.c_str(), nullptr, &hints, &found) != 0 || found == nullptr)
+            {
+               throw std::runtime_error("Unable to resolve host name: " + host_name);
+            }
+
+            char address[INET_ADDRSTRLEN];
+
+            ::inet_ntop(AF_INET, &((sockaddr_in*)found->ai_addr)->sin_addr, address, sizeof(address));
+
+            ::freeaddrinfo(found);
+
+            _ctor(port, address, type);
+         #endif
       }
 
-      void _ctor(std::size_t port, const char* const ip = nullptr)
+      void _ctor(std::size_t port, const char* const ip, protocol type)
       {
          #if _WIN32
             WSADATA w;
@@ -178,14 +467,15 @@ class socket
             #if _WIN32
                strcpy_s(_m_ip_address, std::strlen(loopback) + 1, loopback);
             #else
-               std::strcpy(_m_ip_address, ip);
+               std::strcpy(_m_ip_address, loopback);
             #endif
          }
 
          // AF_INET: Internet domain of the computer
-         // SOCK_STREAM: TCP as opposed to UDP
-         // 0: Choose TCP for the transfer protocol
-         _m_socket_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+         // SOCK_STREAM: TCP, SOCK_DGRAM: UDP
+         // 0: The default protocol for the socket type
+         _m_protocol = type;
+         _m_socket_fd = ::socket(AF_INET, type == protocol_udp ? SOCK_DGRAM : SOCK_STREAM, 0);
 
          // -1 if failed
          if (_m_socket_fd < 0)
@@ -198,191 +488,1614 @@ class socket
 
          _m_server_address.sin_family = AF_INET;
          _m_server_address.sin_addr.s_addr = INADDR_ANY;
-         _m_server_address.sin_port = _m_port_number;
+         _m_server_address.sin_port = htons((unsigned short)_m_port_number);
 
          _m_accepted_fd = 0;
          _m_amount_read = 0;
+
+         _m_options_set = false;
+
+         _m_zerocopy_sent = 0;
+         _m_zerocopy_completed = 0;
+         _m_zerocopy_copied = 0;
+
+         #if !_WIN32
+            _m_vector_calls = 0;
+            _m_datagram_calls = 0;
+         #endif
+
+         #if __linux__
+            _m_uring = nullptr;
+            _m_uring_multishot = false;
+            _m_uring_multishot_accept = false;
+            _m_uring_accept_armed = false;
+
+            for (int slot = 0; slot < 2; ++slot)
+            {
+               _m_uring_armed[slot] = false;
+               _m_uring_generation[slot] = 0;
+               _m_uring_partial_id[slot] = 0;
+               _m_uring_partial_offset[slot] = 0;
+               _m_uring_partial_size[slot] = 0;
+            }
+         #endif
+
+         _m_buffer.resize(EV9_SOCKET_BUFFER_SIZE);
       }
    
+      void _close_accepted()
+      {
+         #if __linux__
+            // The ring holds its own reference through the registered slot
+            if (_m_uring != nullptr) _uring_release(1);
+         #endif
+
+         if (_m_accepted_fd > 0)
+         {
+            #if _WIN32
+               ::closesocket(_m_accepted_fd);
+            #else
+               ::close(_m_accepted_fd);
+            #endif
+         }
+
+         _m_accepted_fd = 0;
+      }
+
       void _close()
       {
+         #if __linux__
+            if (_m_uring != nullptr) _uring_release(0);
+         #endif
+
          #if _WIN32
             ::closesocket(_m_socket_fd);
          #else
             ::close(_m_socket_fd);
          #endif
+
+         _m_socket_fd = -1;
+      }
+
+      void _interrupt()
+      {
+         #if _WIN32
+            ::shutdown(_m_socket_fd, SD_BOTH);
+         #else
+            ::shutdown(_m_socket_fd, SHUT_RDWR);
+         #endif
       }
    
       void _connect()
       {
-         // IPv4
-         _m_server_address.sin_family = AF_INET;
-         _m_server_address.sin_port = _m_port_number;
-         
-         if (_m_ip_address != nullptr)
-         {
-            #if _WIN32
-               int status = _m_server_address.sin_addr.s_addr = ::inet_addr(_m_ip_address);
-            #else
-               int status = ::inet_pton(AF_INET, _m_ip_address, &_m_server_address.sin_addr);
-            #endif
+         _resolve_server_address();
 
-            if (status < 0)
-            {
-               throw std::runtime_error("Error cannot convert the ip address");
-            }
-         }
-         
          auto return_value = ::connect(_m_socket_fd, (struct sockaddr *) &_m_server_address, sizeof(_m_server_address));
          
          if (return_value < 0)
          {
-            std::cout << WSAGetLastError() << std::endl;
+            #if _WIN32
+               std::cout << WSAGetLastError() << std::endl;
+            #endif
 
             throw std::runtime_error("Error cannot connect to the address");
          }
-
       }
 
-      void _dtor()
+      void _connect(double timeout, double retry_delay)
       {
-         if (_m_accepted_fd) close();
-         if (_m_socket_fd) close();
-         if (_m_ip_address) delete [] _m_ip_address;
-      }
+         typedef std::chrono::steady_clock clock;
 
-      void _listen()
-      {
-         // 5 is the max amount of waiting connections
-         ::listen(_m_socket_fd, 5);
-      }
-   
-      void _read(std::vector<char>& buffer)
-      {
-         do
+         if (timeout < 0 || retry_delay < 0)
          {
-            memset(_m_buffer, 0, sizeof(char) * BUFFER_SIZE);
-            
+            throw std::runtime_error("Connect timeout and retry delay cannot be negative");
+         }
+
+         _resolve_server_address();
+
+         clock::time_point deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout));
+         clock::duration delay = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(retry_delay));
+
+         while (true)
+         {
+            int error = _connect_until(deadline);
+
+            if (error == 0)
+            {
+               return;
+            }
+
             #if _WIN32
-               _m_amount_read = (int)::recv(_m_accepted_fd, _m_buffer, BUFFER_SIZE - 1, 0);
+               bool refused = error == WSAECONNREFUSED;
             #else
-               _m_amount_read = (int)::read(_m_accepted_fd, _m_buffer, BUFFER_SIZE - 1);
+               bool refused = error == ECONNREFUSED;
             #endif
 
-            if (_m_amount_read < 0)
+            if (!refused)
             {
-               throw std::runtime_error("Error reading from the connection");
+               throw std::runtime_error(std::string("Error cannot connect to the address: ") + std::strerror(error));
             }
 
-            for(int index = 0; index < _m_amount_read; ++index)
+            clock::time_point now = clock::now();
+
+            if (now + delay >= deadline)
             {
-               buffer.push_back(_m_buffer[index]);
+               throw std::runtime_error("Timed out connecting to " + std::string(_m_ip_address) + ":" + std::to_string(_m_port_number));
             }
 
-         } while (_m_amount_read == BUFFER_SIZE - 1);
+            std::this_thread::sleep_for(delay);
+
+            delay = std::min<clock::duration>(delay * 2, std::chrono::milliseconds(100));
+
+            _reopen();
+         }
       }
-   
-      void _read_back(std::vector<char>& buffer)
+
+      // One non-blocking attempt; returns 0 or the error it failed with.
+      // The descriptor's blocking mode is put back however it ends.
+      int _connect_until(std::chrono::steady_clock::time_point deadline)
       {
-         do
+         bool non_blocking = _is_non_blocking(_m_socket_fd);
+
+         _set_non_blocking(_m_socket_fd, true);
+
+         int error = 0;
+
+         try
          {
-            memset(_m_buffer, 0, sizeof(char) * BUFFER_SIZE);
-            
-            #if _WIN32
-               _m_amount_read = (int)::recv(_m_socket_fd, _m_buffer, BUFFER_SIZE - 1, 0);
-            #else
-               _m_amount_read = (int)::read(_m_accepted_fd, _m_buffer, BUFFER_SIZE - 1);
-            #endif
-            
-            if (_m_amount_read < 0)
-            {
-               throw std::runtime_error("Error reading from the connection");
-            }
-            
-            for(int index = 0; index < _m_amount_read; ++index)
-            {
-               buffer.push_back(_m_buffer[index]);
-            }
-            
-         } while (_m_amount_read == BUFFER_SIZE - 1);
+            error = _connect_attempt(deadline);
+         }
+
+         catch (...)
+         {
+            _set_non_blocking(_m_socket_fd, non_blocking);
+
+            throw;
+         }
+
+         _set_non_blocking(_m_socket_fd, non_blocking);
+
+         return error;
       }
-   
-      void _write(const char* const message)
+
+      int _connect_attempt(std::chrono::steady_clock::time_point deadline)
       {
+         int status = ::connect(_m_socket_fd, (struct sockaddr *) &_m_server_address, sizeof(_m_server_address));
+
          #if _WIN32
-            auto error_code = ::send(_m_socket_fd, message, (std::size_t)strlen(message), 0);
+            int error = status == 0 ? 0 : WSAGetLastError();
+            bool in_progress = error == WSAEWOULDBLOCK;
          #else
-            auto error_code = ::write(_m_socket_fd, message, (std::size_t)strlen(message));
+            int error = status == 0 ? 0 : errno;
+            bool in_progress = error == EINPROGRESS;
          #endif
-      
-         if (error_code < 0)
+
+         while (in_progress)
          {
-            throw std::runtime_error("Error writing to the connection");
+            std::chrono::milliseconds remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+
+            if (remaining.count() <= 0)
+            {
+               throw std::runtime_error("Timed out connecting to " + std::string(_m_ip_address) + ":" + std::to_string(_m_port_number));
+            }
+
+            if (!_wait_writable(_m_socket_fd, (int)remaining.count()))
+            {
+               continue;
+            }
+
+            error = _connect_error();
+
+            in_progress = false;
          }
+
+         return error;
       }
 
-      void _write(const std::string& message)
+      int _connect_non_blocking()
       {
+         _resolve_server_address();
+
+         _set_non_blocking(_m_socket_fd, true);
+
+         int status = ::connect(_m_socket_fd, (struct sockaddr *) &_m_server_address, sizeof(_m_server_address));
+
          #if _WIN32
-            auto error_code = ::send(_m_socket_fd, message.c_str(), message.size(), 0);
+            int error = status == 0 ? 0 : WSAGetLastError();
+
+            return error == WSAEWOULDBLOCK ? EINPROGRESS : error;
          #else
-            auto error_code = ::write(_m_socket_fd, message.c_str(), message.size());
+            return status == 0 ? 0 : errno;
          #endif
-
-         if (error_code < 0)
-         {
-            throw std::runtime_error("Error writing to the connection");
-         }
       }
 
-      void _write_back(const char* const message)
+      int _connect_error() const
       {
+         int error = 0;
+
          #if _WIN32
-            auto error_code = ::send(_m_accepted_fd, message, (std::size_t)strlen(message), 0);
+            int length = sizeof(error);
          #else
-            auto error_code = ::write(_m_accepted_fd, message, (std::size_t)strlen(message));
+            socklen_t length = sizeof(error);
          #endif
 
-         if (error_code < 0)
+         if (::getsockopt(_m_socket_fd, SOL_SOCKET, SO_ERROR, (char*)&error, &length) != 0)
          {
-            throw std::runtime_error("Error writing to the connection");
+            throw std::runtime_error("Unable to read the connect result");
          }
+
+         return error;
       }
-   
-      void _write_back(const std::string& message)
+
+      static bool _wait_writable(descriptor fd, int milliseconds)
       {
          #if _WIN32
-            auto error_code = ::send(_m_accepted_fd, message.c_str(), message.size(), 0);
+            fd_set writable;
+            fd_set failed;
+
+            FD_ZERO(&writable);
+            FD_ZERO(&failed);
+            FD_SET(fd, &writable);
+            FD_SET(fd, &failed);
+
+            timeval wait;
+
+            wait.tv_sec = milliseconds / 1000;
+            wait.tv_usec = (milliseconds % 1000) * 1000;
+
+            // A failed connect shows up in the exception set on Windows
+            return ::select(0, nullptr, &writable, &failed, &wait) > 0;
          #else
-            auto error_code = ::write(_m_accepted_fd, message.c_str(), message.size());
+            pollfd entry;
+
+            entry.fd = fd;
+            entry.events = POLLOUT;
+            entry.revents = 0;
+
+            int ready = ::poll(&entry, 1, milliseconds);
+
+            if (ready < 0 && errno != EINTR)
+            {
+               throw std::runtime_error("Error waiting for the connection");
+            }
+
+            return ready > 0;
          #endif
-         
-         if (error_code < 0)
-         {
-            throw std::runtime_error("Error writing to the connection");
-         }
       }
-   
-   private: // Member Variables
-
-      char _m_buffer[BUFFER_SIZE];
-      char* _m_ip_address;
 
-      #if _WIN32
-         SOCKET _m_accepted_fd;
-         SOCKET _m_socket_fd;
-      #else
-         int _m_accepted_fd;
-         int _m_socket_fd;
+      // A descriptor whose connect failed cannot portably try again
+      void _reopen()
+      {
+         #if __linux__
+            if (_m_uring != nullptr)
+            {
+               throw std::runtime_error("Enable io_uring after connect(), not before");
+            }
+         #endif
+
+         _close();
+
+         _m_socket_fd = ::socket(AF_INET, _m_protocol == protocol_udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+
+         if (_m_socket_fd < 0)
+         {
+            throw std::runtime_error("Unable to open socket.");
+         }
+
+         if (_m_options_set) _apply_options(_m_socket_fd);
+      }
+
+      void _resolve_server_address()
+      {
+         // IPv4
+         _m_server_address.sin_family = AF_INET;
+         _m_server_address.sin_port = htons((unsigned short)_m_port_number);
+         
+         if (_m_ip_address != nullptr)
+         {
+            #if _WIN32
+               int status = _m_server_address.sin_addr.s_addr = ::inet_addr(_m_ip_address);
+            #else
+               int status = ::inet_pton(AF_INET, _m_ip_address, &_m_server_address.sin_addr);
+            #endif
+
+            if (status < 0)
+            {
+               throw std::runtime_error("Error cannot convert the ip address");
+            }
+         }
+      }
+
+      void _dtor()
+      {
+         _close_accepted();
+
+         if (_m_socket_fd > 0) close();
+         if (_m_ip_address) delete [] _m_ip_address;
+
+         #if __linux__
+            if (_m_uring != nullptr) delete _m_uring;
+         #endif
+      }
+
+      void _listen(int backlog)
+      {
+         // backlog is the max amount of waiting connections
+         if (::listen(_m_socket_fd, backlog) != 0)
+         {
+            throw std::runtime_error("Unable to listen on the socket");
+         }
+      }
+   
+      void _read(std::vector<char>& buffer)
+      {
+         _read_vector(_m_accepted_fd, buffer);
+      }
+
+      std::size_t _read(char* const buffer, std::size_t size)
+      {
+         return _read_fd(_m_accepted_fd, buffer, size);
+      }
+
+      std::size_t _read_all(descriptor fd, char* const buffer, std::size_t size)
+      {
+         std::size_t total = 0;
+
+         // Keep reading until the caller's buffer is full; a short result
+         // means the peer closed the connection first.
+         while (total < size)
+         {
+            std::size_t amount_read = _read_fd(fd, buffer + total, size - total);
+
+            if (amount_read == 0)
+            {
+               break;
+            }
+
+            total += amount_read;
+         }
+
+         return total;
+      }
+   
+      void _read_back(std::vector<char>& buffer)
+      {
+         _read_vector(_m_socket_fd, buffer);
+      }
+
+      std::size_t _read_back(char* const buffer, std::size_t size)
+      {
+         return _read_fd(_m_socket_fd, buffer, size);
+      }
+
+      std::size_t _read_fd(descriptor fd, char* const buffer, std::size_t size)
+      {
+         #if __linux__
+            if (_m_uring != nullptr) return _uring_read(fd, buffer, size);
+         #endif
+
+         // Single call into the kernel, no intermediate copy. Returns 0 once
+         // the peer has closed the connection.
+         #if _WIN32
+            auto amount_read = ::recv(fd, buffer, (int)size, 0);
+         #else
+            auto amount_read = ::read(fd, buffer, size);
+         #endif
+
+         if (amount_read < 0)
+         {
+            throw std::runtime_error("Error reading from the connection");
+         }
+
+         return (std::size_t)amount_read;
+      }
+
+      void _read_vector(descriptor fd, std::vector<char>& buffer)
+      {
+         // A read that fills the whole socket buffer means more is probably
+         // waiting, so keep going until a short read.
+         do
+         {
+            _m_amount_read = (int)_read_fd(fd, &_m_buffer[0], _m_buffer.size());
+
+            buffer.insert(buffer.end(), _m_buffer.begin(), _m_buffer.begin() + _m_amount_read);
+
+         } while ((std::size_t)_m_amount_read == _m_buffer.size());
+      }
+
+      static bool _is_non_blocking(descriptor fd)
+      {
+         #if _WIN32
+            // Windows cannot report it; sockets start out blocking
+            (void)fd;
+
+            return false;
+         #else
+            int flags = ::fcntl(fd, F_GETFL, 0);
+
+            return flags >= 0 && (flags & O_NONBLOCK) != 0;
+         #endif
+      }
+
+      static void _set_non_blocking(descriptor fd, bool non_blocking)
+      {
+         #if _WIN32
+            u_long mode = non_blocking ? 1 : 0;
+
+            int status = ::ioctlsocket(fd, FIONBIO, &mode);
+         #else
+            int flags = ::fcntl(fd, F_GETFL, 0);
+
+            int status = flags < 0 ? flags : ::fcntl(fd, F_SETFL, non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+         #endif
+
+         if (status != 0)
+         {
+            throw std::runtime_error("Unable to change the socket's blocking mode");
+         }
+      }
+
+      void _set_buffer_size(std::size_t size)
+      {
+         if (size == 0)
+         {
+            throw std::runtime_error("Socket buffer size must be greater than zero");
+         }
+
+         _m_buffer.resize(size);
+      }
+   
+      void _write(const char* const message)
+      {
+         #if _WIN32
+            auto error_code = ::send(_m_socket_fd, message, (std::size_t)strlen(message), 0);
+         #else
+            auto error_code = ::write(_m_socket_fd, message, (std::size_t)strlen(message));
+         #endif
+      
+         if (error_code < 0)
+         {
+            throw std::runtime_error("Error writing to the connection");
+         }
+      }
+
+      void _write(const std::string& message)
+      {
+         #if _WIN32
+            auto error_code = ::send(_m_socket_fd, message.c_str(), message.size(), 0);
+         #else
+            auto error_code = ::write(_m_socket_fd, message.c_str(), message.size());
+         #endif
+
+         if (error_code < 0)
+         {
+            throw std::runtime_error("Error writing to the connection");
+         }
+      }
+
+      std::size_t _write(const char* const buffer, std::size_t size)
+      {
+         return _write_fd(_m_socket_fd, buffer, size);
+      }
+
+      std::size_t _write_fd(descriptor fd, const char* const buffer, std::size_t size)
+      {
+         #if __linux__
+            if (_m_uring != nullptr) return _uring_write(fd, buffer, size);
+         #endif
+
+         // Single call into the kernel; the amount written may be short.
+         #if _WIN32
+            auto amount_written = ::send(fd, buffer, (int)size, 0);
+         #else
+            auto amount_written = ::write(fd, buffer, size);
+         #endif
+
+         if (amount_written < 0)
+         {
+            throw std::runtime_error("Error writing to the connection");
+         }
+
+         return (std::size_t)amount_written;
+      }
+
+      std::size_t _send_file(int file_fd, std::size_t offset, std::size_t size)
+      {
+         #if __linux__
+            off_t file_offset = (off_t)offset;
+
+            auto amount_written = ::sendfile(_m_socket_fd, file_fd, &file_offset, size);
+
+            if (amount_written < 0)
+            {
+               throw std::runtime_error("Error sending the file to the connection");
+            }
+
+            return (std::size_t)amount_written;
+         #else
+            throw std::runtime_error("sendfile is not supported on this platform");
+         #endif
+      }
+
+      void _enable_zerocopy()
+      {
+         #if __linux__ && defined(SO_ZEROCOPY)
+            int enable = 1;
+
+            if (::setsockopt(_m_socket_fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) != 0)
+            {
+               throw std::runtime_error("Unable to enable SO_ZEROCOPY on the socket");
+            }
+         #else
+            throw std::runtime_error("MSG_ZEROCOPY is not supported on this platform");
+         #endif
+      }
+
+      std::size_t _write_zerocopy(const char* const buffer, std::size_t size)
+      {
+         #if __linux__ && defined(MSG_ZEROCOPY)
+            while (true)
+            {
+               auto amount_written = ::send(_m_socket_fd, buffer, size, MSG_ZEROCOPY);
+
+               if (amount_written >= 0)
+               {
+                  // Every successful send is one notification sequence number
+                  ++_m_zerocopy_sent;
+
+                  return (std::size_t)amount_written;
+               }
+
+               // The socket's option memory is full of unreaped
+               // notifications; drain them and try again.
+               if (errno == ENOBUFS && zerocopy_pending())
+               {
+                  _reap_zerocopy(true);
+
+                  continue;
+               }
+
+               throw std::runtime_error("Error writing to the connection");
+            }
+         #else
+            throw std::runtime_error("MSG_ZEROCOPY is not supported on this platform");
+         #endif
+      }
+
+      std::size_t _reap_zerocopy(bool wait)
+      {
+         std::size_t reaped = 0;
+
+         #if __linux__ && defined(MSG_ZEROCOPY)
+            while (zerocopy_pending())
+            {
+               char control[128];
+
+               msghdr message;
+
+               memset(&message, 0, sizeof(message));
+
+               message.msg_control = control;
+               message.msg_controllen = sizeof(control);
+
+               // The error queue never blocks, poll for POLLERR to wait
+               if (::recvmsg(_m_socket_fd, &message, MSG_ERRQUEUE) < 0)
+               {
+                  if (errno != EAGAIN && errno != EWOULDBLOCK)
+                  {
+                     throw std::runtime_error("Error reading the socket error queue");
+                  }
+
+                  if (!wait)
+                  {
+                     break;
+                  }
+
+                  pollfd poll_fd;
+
+                  poll_fd.fd = _m_socket_fd;
+                  poll_fd.events = 0;
+                  poll_fd.revents = 0;
+
+                  ::poll(&poll_fd, 1, -1);
+
+                  continue;
+               }
+
+               for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header))
+               {
+                  sock_extended_err* error = (sock_extended_err*)CMSG_DATA(header);
+
+                  if (error->ee_errno != 0 || error->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                  {
+                     continue;
+                  }
+
+                  // [ee_info, ee_data] is an inclusive range of completed sends
+                  std::size_t completed = error->ee_data - error->ee_info + 1;
+
+                  if (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+                  {
+                     _m_zerocopy_copied += completed;
+                  }
+
+                  _m_zerocopy_completed += completed;
+
+                  reaped += completed;
+               }
+            }
+         #else
+            (void)wait;
+         #endif
+
+         return reaped;
+      }
+
+      #if !_WIN32
+      std::size_t _transfer_vector(descriptor fd, const segment* const segments, std::size_t count, bool write)
+      {
+         #ifdef IOV_MAX
+            const std::size_t max_segments = IOV_MAX;
+         #else
+            const std::size_t max_segments = 1024;
+         #endif
+
+         std::size_t total = 0;
+         std::size_t index = 0;
+         std::size_t offset = 0;
+
+         while (true)
+         {
+            // Empty segments would make a zero byte result look like EOF
+            while (index < count && offset == segments[index].iov_len)
+            {
+               ++index;
+               offset = 0;
+            }
+
+            if (index == count)
+            {
+               break;
+            }
+
+            // The caller's array is left alone; a partial transfer resumes
+            // from a copy whose first entry is trimmed by what already went.
+            std::size_t window = count - index < max_segments ? count - index : max_segments;
+
+            _m_segments.assign(segments + index, segments + index + window);
+
+            _m_segments[0].iov_base = (char*)_m_segments[0].iov_base + offset;
+            _m_segments[0].iov_len -= offset;
+
+            ssize_t amount = _vector_call(fd, window, write);
+
+            ++_m_vector_calls;
+
+            if (amount < 0)
+            {
+               if (errno == EINTR) continue;
+
+               throw std::runtime_error(write ? "Error writing to the connection" : "Error reading from the connection");
+            }
+
+            if (amount == 0 && !write)
+            {
+               break;
+            }
+
+            total += (std::size_t)amount;
+
+            std::size_t remaining = (std::size_t)amount;
+
+            while (remaining)
+            {
+               std::size_t left = segments[index].iov_len - offset;
+
+               if (remaining >= left)
+               {
+                  remaining -= left;
+
+                  ++index;
+                  offset = 0;
+               }
+
+               else
+               {
+                  offset += remaining;
+                  remaining = 0;
+               }
+            }
+         }
+
+         return total;
+      }
+
+      ssize_t _vector_call(descriptor fd, std::size_t window, bool write)
+      {
+         #if __linux__
+            if (_m_uring != nullptr && write) return _uring_write_vector(fd, window);
+
+            // Reads keep going through the ring's receive stream
+            if (_m_uring != nullptr) return (ssize_t)_uring_read(fd, (char*)_m_segments[0].iov_base, _m_segments[0].iov_len);
+         #endif
+
+         return write ? ::writev(fd, _m_segments.data(), (int)window) : ::readv(fd, _m_segments.data(), (int)window);
+      }
+      #endif
+
+      #if !_WIN32
+      std::size_t _write_datagrams(const segment* const datagrams, std::size_t count)
+      {
+         std::size_t sent = 0;
+
+         while (sent < count)
+         {
+            #if __linux__
+               // One call for the whole batch; it may stop short when the
+               // send buffer fills, so carry on from there.
+               std::size_t batch = count - sent < 1024 ? count - sent : 1024;
+
+               _m_messages.assign(batch, mmsghdr());
+
+               for (std::size_t index = 0; index < batch; ++index)
+               {
+                  _m_messages[index].msg_hdr.msg_iov = (iovec*)&datagrams[sent + index];
+                  _m_messages[index].msg_hdr.msg_iovlen = 1;
+               }
+
+               int amount = ::sendmmsg(_m_socket_fd, _m_messages.data(), (unsigned int)batch, 0);
+            #else
+               int amount = ::send(_m_socket_fd, (const char*)datagrams[sent].iov_base, datagrams[sent].iov_len, 0) < 0 ? -1 : 1;
+            #endif
+
+            ++_m_datagram_calls;
+
+            if (amount < 0)
+            {
+               if (errno == EINTR) continue;
+
+               // A receiver that is not there yet only refuses the batch
+               if (errno == ECONNREFUSED) return sent;
+
+               throw std::runtime_error("Error writing to the connection");
+            }
+
+            sent += (std::size_t)amount;
+         }
+
+         return sent;
+      }
+
+      std::size_t _read_datagrams(const segment* const buffers, std::size_t count, std::size_t* sizes, std::size_t* segment_sizes, std::int64_t* arrivals)
+      {
+         #if __linux__
+            // Room for a UDP_GRO and a timestamp control message per datagram
+            const std::size_t control_size = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(timespec));
+
+            if (count > 1024) count = 1024;
+
+            _m_messages.assign(count, mmsghdr());
+            _m_control.assign(count * control_size, 0);
+
+            for (std::size_t index = 0; index < count; ++index)
+            {
+               _m_messages[index].msg_hdr.msg_iov = (iovec*)&buffers[index];
+               _m_messages[index].msg_hdr.msg_iovlen = 1;
+               _m_messages[index].msg_hdr.msg_control = &_m_control[index * control_size];
+               _m_messages[index].msg_hdr.msg_controllen = control_size;
+            }
+
+            // Block for the first datagram, then take whatever else is
+            // already queued without waiting for the batch to fill.
+            int amount;
+
+            do
+            {
+               amount = ::recvmmsg(_m_socket_fd, _m_messages.data(), (unsigned int)count, MSG_WAITFORONE, nullptr);
+
+               ++_m_datagram_calls;
+
+            } while (amount < 0 && errno == EINTR);
+         #else
+            int amount = (int)::recv(_m_socket_fd, (char*)buffers[0].iov_base, buffers[0].iov_len, 0);
+
+            ++_m_datagram_calls;
+
+            if (amount >= 0) sizes[0] = (std::size_t)amount;
+            if (amount >= 0 && segment_sizes != nullptr) segment_sizes[0] = 0;
+            if (amount >= 0 && arrivals != nullptr) arrivals[0] = 0;
+
+            amount = amount < 0 ? amount : 1;
+         #endif
+
+         if (amount < 0)
+         {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+               return 0;
+            }
+
+            throw std::runtime_error("Error reading from the connection");
+         }
+
+         #if __linux__
+            for (int index = 0; index < amount; ++index)
+            {
+               sizes[index] = _m_messages[index].msg_len;
+
+               if (segment_sizes != nullptr) segment_sizes[index] = 0;
+               if (arrivals != nullptr) arrivals[index] = 0;
+
+               msghdr& header = _m_messages[index].msg_hdr;
+
+               for (cmsghdr* control = CMSG_FIRSTHDR(&header); control != nullptr; control = CMSG_NXTHDR(&header, control))
+               {
+                  #if defined(UDP_GRO)
+                  if (segment_sizes != nullptr && control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO)
+                  {
+                     int segment_size;
+
+                     memcpy(&segment_size, CMSG_DATA(control), sizeof(segment_size));
+
+                     segment_sizes[index] = (std::size_t)segment_size;
+                  }
+                  #endif
+
+                  if (arrivals != nullptr && control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS)
+                  {
+                     timespec stamp;
+
+                     memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+
+                     arrivals[index] = (std::int64_t)stamp.tv_sec * 1000000000 + stamp.tv_nsec;
+                  }
+               }
+            }
+         #endif
+
+         return (std::size_t)amount;
+      }
+      #endif
+
+      bool _enable_timestamps()
+      {
+         #if __linux__
+            int value = 1;
+
+            return ::setsockopt(_m_socket_fd, SOL_SOCKET, SO_TIMESTAMPNS, &value, sizeof(value)) == 0;
+         #else
+            return false;
+         #endif
+      }
+
+      bool _enable_udp_offload(bool segmentation, int value)
+      {
+         #if __linux__ && defined(UDP_SEGMENT) && defined(UDP_GRO)
+            int option = segmentation ? UDP_SEGMENT : UDP_GRO;
+
+            return _m_protocol == protocol_udp && ::setsockopt(_m_socket_fd, SOL_UDP, option, &value, sizeof(value)) == 0;
+         #else
+            (void)segmentation;
+            (void)value;
+
+            return false;
+         #endif
+      }
+
+      void _set_reuse_port(bool reuse)
+      {
+         #ifdef SO_REUSEPORT
+            int value = reuse ? 1 : 0;
+
+            if (::setsockopt(_m_socket_fd, SOL_SOCKET, SO_REUSEPORT, (const char*)&value, sizeof(value)) != 0)
+            {
+               throw std::runtime_error("Unable to set SO_REUSEPORT on the socket");
+            }
+         #else
+            if (reuse)
+            {
+               throw std::runtime_error("SO_REUSEPORT is not supported on this platform");
+            }
+         #endif
+      }
+
+      void _set_receive_timeout(double seconds)
+      {
+         #if _WIN32
+            DWORD timeout = (DWORD)(seconds * 1000);
+         #else
+            timeval timeout;
+
+            timeout.tv_sec = (time_t)seconds;
+            timeout.tv_usec = (suseconds_t)((seconds - (double)timeout.tv_sec) * 1e6);
+         #endif
+
+         if (::setsockopt(_m_socket_fd, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout)) != 0)
+         {
+            throw std::runtime_error("Unable to set the receive timeout");
+         }
+      }
+
+      void _set_options(const options& opts)
+      {
+         _m_options = opts;
+         _m_options_set = true;
+
+         _apply_options(_m_socket_fd);
+
+         if (_m_accepted_fd > 0) _apply_options(_m_accepted_fd);
+      }
+
+      void _apply_options(descriptor fd)
+      {
+         if (_m_options.send_buffer) _set_option(fd, SOL_SOCKET, SO_SNDBUF, (int)_m_options.send_buffer, "SO_SNDBUF");
+         if (_m_options.receive_buffer) _set_option(fd, SOL_SOCKET, SO_RCVBUF, (int)_m_options.receive_buffer, "SO_RCVBUF");
+
+         if (_m_protocol == protocol_tcp)
+         {
+            if (_m_options.no_delay >= 0) _set_option(fd, IPPROTO_TCP, TCP_NODELAY, _m_options.no_delay ? 1 : 0, "TCP_NODELAY");
+         }
+
+         #if __linux__
+            if (_m_protocol == protocol_tcp)
+            {
+               _set_option(fd, IPPROTO_TCP, TCP_CORK, _m_options.cork ? 1 : 0, "TCP_CORK");
+
+               // Writing 0 would turn off the quick acks a new connection
+               // starts with, which is not the default
+               if (_m_options.quick_ack) _set_option(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+
+               if (!_m_options.congestion.empty() && ::setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, _m_options.congestion.c_str(), (socklen_t)_m_options.congestion.size()) != 0)
+               {
+                  throw std::runtime_error("Unable to set TCP_CONGESTION to " + _m_options.congestion + " on the socket");
+               }
+            }
+
+            if (_m_options.busy_poll) _set_option(fd, SOL_SOCKET, SO_BUSY_POLL, (int)_m_options.busy_poll, "SO_BUSY_POLL");
+         #else
+            if (_m_options.cork || _m_options.quick_ack || _m_options.busy_poll || !_m_options.congestion.empty())
+            {
+               throw std::runtime_error("TCP_CORK, TCP_QUICKACK, SO_BUSY_POLL and TCP_CONGESTION are not supported on this platform");
+            }
+         #endif
+      }
+
+      static void _set_option(descriptor fd, int level, int name, int value, const char* const label)
+      {
+         if (::setsockopt(fd, level, name, (const char*)&value, sizeof(value)) != 0)
+         {
+            throw std::runtime_error(std::string("Unable to set ") + label + " on the socket");
+         }
+      }
+
+      static int _get_option(descriptor fd, int level, int name)
+      {
+         int value = 0;
+
+         #if _WIN32
+            int size = sizeof(value);
+         #else
+            socklen_t size = sizeof(value);
+         #endif
+
+         ::getsockopt(fd, level, name, (char*)&value, &size);
+
+         return value;
+      }
+
+      options _effective_options() const
+      {
+         descriptor fd = _m_accepted_fd > 0 ? _m_accepted_fd : _m_socket_fd;
+
+         options opts;
+
+         opts.send_buffer = (std::size_t)_get_option(fd, SOL_SOCKET, SO_SNDBUF);
+         opts.receive_buffer = (std::size_t)_get_option(fd, SOL_SOCKET, SO_RCVBUF);
+
+         if (_m_protocol == protocol_tcp)
+         {
+            opts.no_delay = _get_option(fd, IPPROTO_TCP, TCP_NODELAY) != 0 ? 1 : 0;
+         }
+
+         #if __linux__
+            if (_m_protocol == protocol_tcp)
+            {
+               opts.cork = _get_option(fd, IPPROTO_TCP, TCP_CORK) != 0;
+               opts.quick_ack = _get_option(fd, IPPROTO_TCP, TCP_QUICKACK) != 0;
+
+               // TCP_CA_NAME_MAX in the kernel
+               char name[16] = { 0 };
+
+               socklen_t size = sizeof(name);
+
+               if (::getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &size) == 0)
+               {
+                  opts.congestion.assign(name, ::strnlen(name, size));
+               }
+            }
+
+            opts.busy_poll = (unsigned int)_get_option(fd, SOL_SOCKET, SO_BUSY_POLL);
+         #endif
+
+         return opts;
+      }
+
+      static std::vector<std::string> _congestion_controls()
+      {
+         std::vector<std::string> names;
+
+         #if __linux__
+            std::FILE* file = std::fopen("/proc/sys/net/ipv4/tcp_available_congestion_control", "r");
+
+            if (file == nullptr)
+            {
+               return names;
+            }
+
+            char name[64];
+
+            while (std::fscanf(file, "%63s", name) == 1)
+            {
+               names.push_back(name);
+            }
+
+            std::fclose(file);
+         #endif
+
+         return names;
+      }
+
+      bool _use_uring(unsigned int depth)
+      {
+         #if __linux__
+            if (_m_uring != nullptr)
+            {
+               return true;
+            }
+
+            if (!uring::available())
+            {
+               return false;
+            }
+
+            try
+            {
+               _m_uring = new uring(depth);
+            }
+
+            catch (std::exception&)
+            {
+               return false;
+            }
+
+            // Slot 0 is this socket, slot 1 the accepted connection
+            int fds[2] = { _m_socket_fd, _m_accepted_fd > 0 ? _m_accepted_fd : -1 };
+
+            bool supported = _m_uring->supports(IORING_OP_RECV) &&
+                             _m_uring->supports(IORING_OP_SEND) &&
+                             _m_uring->supports(IORING_OP_ASYNC_CANCEL);
+
+            if (!supported || !_m_uring->register_files(fds, 2))
+            {
+               delete _m_uring;
+
+               _m_uring = nullptr;
+
+               return false;
+            }
+
+            // Without provided buffers every read is a single RECV instead
+            _m_uring_multishot = _m_uring->setup_buffer_group(0, 16, _m_buffer.size());
+            _m_uring_multishot_accept = _m_uring->supports(IORING_OP_ACCEPT);
+
+            return true;
+         #else
+            (void)depth;
+
+            return false;
+         #endif
+      }
+
+      bool _register_buffer(const char* const buffer, std::size_t size)
+      {
+         #if __linux__
+            return _m_uring != nullptr && _m_uring->register_buffer(buffer, size);
+         #else
+            (void)buffer;
+            (void)size;
+
+            return false;
+         #endif
+      }
+
+      #if __linux__
+      int _slot(descriptor fd) const
+      {
+         return fd == _m_socket_fd ? 0 : 1;
+      }
+
+      void _uring_prepare(io_uring_sqe* sqe, unsigned char opcode, int slot, const void* address, std::size_t size)
+      {
+         sqe->opcode = opcode;
+         sqe->flags = IOSQE_FIXED_FILE;
+         sqe->fd = slot;
+         sqe->addr = (std::uint64_t)(std::uintptr_t)address;
+         sqe->len = size > (1U << 30) ? (1U << 30) : (unsigned int)size;
+      }
+
+      void _uring_cancel(std::uint64_t user_data)
+      {
+         io_uring_sqe* sqe = _m_uring->next();
+
+         sqe->opcode = IORING_OP_ASYNC_CANCEL;
+         sqe->fd = -1;
+         sqe->addr = user_data;
+         sqe->user_data = tag_ignore;
+      }
+
+      std::uint64_t _uring_tag(int tag, std::uint64_t value) const
+      {
+         return (value << 8) | (std::uint64_t)tag;
+      }
+
+      uring::completion _uring_operation()
+      {
+         // Synchronous operations are the only tag_operation completions in
+         // flight; anything else that turns up meanwhile is kept for later.
+         uring::completion completion;
+
+         while (true)
+         {
+            _m_uring->wait(completion);
+
+            if ((completion.user_data & 0xff) == tag_operation)
+            {
+               return completion;
+            }
+
+            _uring_stash(completion);
+         }
+      }
+
+      void _uring_stash(const uring::completion& completion)
+      {
+         int tag = (int)(completion.user_data & 0xff);
+
+         std::uint64_t generation = completion.user_data >> 8;
+
+         if (tag == tag_receive || tag == tag_receive + 1)
+         {
+            int slot = tag - tag_receive;
+
+            if (generation == _m_uring_generation[slot])
+            {
+               _m_uring_received[slot].push_back(completion);
+
+               return;
+            }
+
+            // Left over from a connection that has since been closed
+            if (completion.flags & IORING_CQE_F_BUFFER)
+            {
+               _m_uring->recycle((unsigned short)(completion.flags >> IORING_CQE_BUFFER_SHIFT));
+            }
+         }
+
+         else if (tag == tag_accept)
+         {
+            if (generation == _m_uring_generation[0]) _m_uring_accepted.push_back(completion);
+            else if (completion.result >= 0) ::close(completion.result);
+         }
+      }
+
+      static bool _uring_finished(const std::deque<uring::completion>& completions)
+      {
+         for (const uring::completion& completion : completions)
+         {
+            if (!(completion.flags & IORING_CQE_F_MORE)) return true;
+         }
+
+         return false;
+      }
+
+      void _uring_release(int slot)
+      {
+         // Cancel the multishot requests on the slot, drop whatever they
+         // already delivered and empty the registered slot, so closing the
+         // descriptor really closes the connection.
+         std::uint64_t receive_tag = _uring_tag(tag_receive + slot, _m_uring_generation[slot]);
+         std::uint64_t accept_tag = _uring_tag(tag_accept, _m_uring_generation[0]);
+
+         bool cancel_receive = _m_uring_armed[slot] && !_uring_finished(_m_uring_received[slot]);
+         bool cancel_accept = slot == 0 && _m_uring_accept_armed && !_uring_finished(_m_uring_accepted);
+
+         if (cancel_receive) _uring_cancel(receive_tag);
+         if (cancel_accept) _uring_cancel(accept_tag);
+
+         // A request keeps its file alive until its last completion, which
+         // can come late if the thread that armed it has exited.
+         while (cancel_receive || cancel_accept)
+         {
+            uring::completion completion;
+
+            _m_uring->wait(completion);
+
+            bool last = !(completion.flags & IORING_CQE_F_MORE);
+
+            if (last && completion.user_data == receive_tag) cancel_receive = false;
+            if (last && completion.user_data == accept_tag) cancel_accept = false;
+
+            _uring_stash(completion);
+         }
+
+         ++_m_uring_generation[slot];
+
+         _m_uring_armed[slot] = false;
+
+         if (_m_uring_partial_size[slot])
+         {
+            _m_uring->recycle(_m_uring_partial_id[slot]);
+
+            _m_uring_partial_size[slot] = 0;
+         }
+
+         for (const uring::completion& completion : _m_uring_received[slot])
+         {
+            if (completion.flags & IORING_CQE_F_BUFFER)
+            {
+               _m_uring->recycle((unsigned short)(completion.flags >> IORING_CQE_BUFFER_SHIFT));
+            }
+         }
+
+         _m_uring_received[slot].clear();
+
+         if (slot == 0)
+         {
+            for (const uring::completion& completion : _m_uring_accepted)
+            {
+               if (completion.result >= 0) ::close(completion.result);
+            }
+
+            _m_uring_accepted.clear();
+            _m_uring_accept_armed = false;
+         }
+
+         _m_uring->update_file((unsigned int)slot, -1);
+      }
+
+      bool _uring_accept()
+      {
+         if (!_m_uring_accept_armed)
+         {
+            io_uring_sqe* sqe = _m_uring->next();
+
+            _uring_prepare(sqe, IORING_OP_ACCEPT, 0, nullptr, 0);
+
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->user_data = _uring_tag(tag_accept, _m_uring_generation[0]);
+
+            _m_uring_accept_armed = true;
+         }
+
+         // One request keeps accepting; later connections queue up here
+         while (_m_uring_accepted.empty())
+         {
+            uring::completion completion;
+
+            _m_uring->wait(completion);
+
+            _uring_stash(completion);
+         }
+
+         uring::completion completion = _m_uring_accepted.front();
+
+         _m_uring_accepted.pop_front();
+
+         if (!(completion.flags & IORING_CQE_F_MORE)) _m_uring_accept_armed = false;
+
+         // Kernel without multishot accept: the caller falls back to accept()
+         if (completion.result == -EINVAL)
+         {
+            _m_uring_multishot_accept = false;
+
+            return false;
+         }
+
+         if (completion.result < 0)
+         {
+            throw std::runtime_error("Unable to connect to socket - error number: " + std::to_string(-completion.result));
+         }
+
+         _m_accepted_fd = completion.result;
+
+         _m_uring->update_file(1, _m_accepted_fd);
+
+         return true;
+      }
+
+      std::size_t _uring_read(descriptor fd, char* const buffer, std::size_t size)
+      {
+         int slot = _slot(fd);
+
+         if (size == 0)
+         {
+            return 0;
+         }
+
+         if (!_m_uring_multishot)
+         {
+            io_uring_sqe* sqe = _m_uring->next();
+
+            _uring_prepare(sqe, IORING_OP_RECV, slot, buffer, size);
+
+            sqe->user_data = tag_operation;
+
+            int result = _uring_operation().result;
+
+            if (result < 0)
+            {
+               throw std::runtime_error("Error reading from the connection");
+            }
+
+            return (std::size_t)result;
+         }
+
+         while (!_m_uring_partial_size[slot])
+         {
+            while (_m_uring_received[slot].empty())
+            {
+               if (!_m_uring_armed[slot])
+               {
+                  io_uring_sqe* sqe = _m_uring->next();
+
+                  _uring_prepare(sqe, IORING_OP_RECV, slot, nullptr, 0);
+
+                  sqe->ioprio = IORING_RECV_MULTISHOT;
+                  sqe->flags |= IOSQE_BUFFER_SELECT;
+                  sqe->buf_group = _m_uring->buffer_group();
+                  sqe->user_data = _uring_tag(tag_receive + slot, _m_uring_generation[slot]);
+
+                  _m_uring_armed[slot] = true;
+               }
+
+               uring::completion completion;
+
+               _m_uring->wait(completion);
+
+               _uring_stash(completion);
+            }
+
+            uring::completion completion = _m_uring_received[slot].front();
+
+            _m_uring_received[slot].pop_front();
+
+            if (!(completion.flags & IORING_CQE_F_MORE)) _m_uring_armed[slot] = false;
+
+            // Every provided buffer was in use; rearming picks up from here
+            if (completion.result == -ENOBUFS)
+            {
+               continue;
+            }
+
+            // Kernel without multishot receive: use single RECVs from now on
+            if (completion.result == -EINVAL)
+            {
+               _m_uring_multishot = false;
+
+               return _uring_read(fd, buffer, size);
+            }
+
+            if (completion.result < 0)
+            {
+               throw std::runtime_error("Error reading from the connection");
+            }
+
+            if (completion.result == 0)
+            {
+               return 0;
+            }
+
+            _m_uring_partial_id[slot] = (unsigned short)(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+            _m_uring_partial_offset[slot] = 0;
+            _m_uring_partial_size[slot] = (std::size_t)completion.result;
+         }
+
+         // Copy out of the provided buffer and hand it back once it is empty
+         std::size_t amount = size < _m_uring_partial_size[slot] ? size : _m_uring_partial_size[slot];
+
+         memcpy(buffer, _m_uring->group_buffer(_m_uring_partial_id[slot]) + _m_uring_partial_offset[slot], amount);
+
+         _m_uring_partial_offset[slot] += amount;
+         _m_uring_partial_size[slot] -= amount;
+
+         if (_m_uring_partial_size[slot] == 0)
+         {
+            _m_uring->recycle(_m_uring_partial_id[slot]);
+         }
+
+         return amount;
+      }
+
+      std::size_t _uring_write(descriptor fd, const char* const buffer, std::size_t size)
+      {
+         bool fixed = _m_uring->contains_registered(buffer, size);
+
+         io_uring_sqe* sqe = _m_uring->next();
+
+         _uring_prepare(sqe, fixed ? IORING_OP_WRITE_FIXED : IORING_OP_SEND, _slot(fd), buffer, size);
+
+         sqe->user_data = tag_operation;
+
+         int result = _uring_operation().result;
+
+         if (result < 0)
+         {
+            throw std::runtime_error("Error writing to the connection");
+         }
+
+         return (std::size_t)result;
+      }
+
+      ssize_t _uring_write_vector(descriptor fd, std::size_t window)
+      {
+         // A link chain has to go in with a single submit. Anything already
+         // queued (a cancel) goes first, or next() would submit it together
+         // with half the chain, and the chain keeps to the free slots.
+         if (_m_uring->queued() != 0) _m_uring->submit();
+
+         std::size_t space = _m_uring->space();
+
+         if (window > space) window = space != 0 ? space : 1;
+
+         for (std::size_t index = 0; index < window; ++index)
+         {
+            io_uring_sqe* sqe = _m_uring->next();
+
+            _uring_prepare(sqe, IORING_OP_SEND, _slot(fd), _m_segments[index].iov_base, _m_segments[index].iov_len);
+
+            // A short send fails the link, which cancels the rest in order
+            sqe->msg_flags = MSG_WAITALL;
+            sqe->user_data = _uring_tag(tag_operation, index);
+
+            if (index + 1 < window) sqe->flags |= IOSQE_IO_LINK;
+         }
+
+         _m_uring_results.assign(window, 0);
+
+         for (std::size_t index = 0; index < window; ++index)
+         {
+            uring::completion completion = _uring_operation();
+
+            _m_uring_results[(std::size_t)(completion.user_data >> 8)] = completion.result;
+         }
+
+         ssize_t total = 0;
+
+         for (std::size_t index = 0; index < window; ++index)
+         {
+            int result = _m_uring_results[index];
+
+            if (result < 0)
+            {
+               if (total == 0)
+               {
+                  errno = -result;
+
+                  return -1;
+               }
+
+               break;
+            }
+
+            total += result;
+
+            if ((std::size_t)result < _m_segments[index].iov_len)
+            {
+               break;
+            }
+         }
+
+         return total;
+      }
       #endif
-         int _m_amount_read;
+
+      void _write_back(const char* const message)
+      {
+         #if _WIN32
+            auto error_code = ::send(_m_accepted_fd, message, (std::size_t)strlen(message), 0);
+         #else
+            auto error_code = ::write(_m_accepted_fd, message, (std::size_t)strlen(message));
+         #endif
+
+         if (error_code < 0)
+         {
+            throw std::runtime_error("Error writing to the connection");
+         }
+      }
+   
+      std::size_t _write_back(const char* const buffer, std::size_t size)
+      {
+         return _write_fd(_m_accepted_fd, buffer, size);
+      }
+
+      const char* _transport_name() const
+      {
+         return _m_protocol == protocol_udp ? "udp" : "tcp";
+      }
+
+      void _write_back(const std::string& message)
+      {
+         #if _WIN32
+            auto error_code = ::send(_m_accepted_fd, message.c_str(), message.size(), 0);
+         #else
+            auto error_code = ::write(_m_accepted_fd, message.c_str(), message.size());
+         #endif
+         
+         if (error_code < 0)
+         {
+            throw std::runtime_error("Error writing to the connection");
+         }
+      }
+   
+   private: // Member Variables
+
+      std::vector<char> _m_buffer;
+      char* _m_ip_address;
+
+      descriptor _m_accepted_fd;
+      descriptor _m_socket_fd;
+
+      int _m_amount_read;
       std::size_t _m_port_number;
 
+      protocol _m_protocol;
+
+      // Reapplied to every accepted connection once set
+      options _m_options;
+      bool _m_options_set;
+
+      std::size_t _m_zerocopy_sent;
+      std::size_t _m_zerocopy_completed;
+      std::size_t _m_zerocopy_copied;
+
+      #if !_WIN32
+         std::vector<segment> _m_segments;
+         std::size_t _m_vector_calls;
+         std::size_t _m_datagram_calls;
+      #endif
+
+      #if __linux__
+         std::vector<mmsghdr> _m_messages;
+         std::vector<char> _m_control;
+      #endif
+
+      #if __linux__
+         uring* _m_uring;
+
+         bool _m_uring_multishot;
+         bool _m_uring_multishot_accept;
+         bool _m_uring_accept_armed;
+
+         // Per registered slot: 0 is this socket, 1 the accepted connection.
+         // The generation tells completions of a closed connection apart.
+         bool _m_uring_armed[2];
+         std::uint64_t _m_uring_generation[2];
+         std::deque<uring::completion> _m_uring_received[2];
+
+         // Provided buffer the last receive completion has not used up yet
+         unsigned short _m_uring_partial_id[2];
+         std::size_t _m_uring_partial_offset[2];
+         std::size_t _m_uring_partial_size[2];
+
+         std::deque<uring::completion> _m_uring_accepted;
+         std::vector<int> _m_uring_results;
+      #endif
+
       #if _WIN32
          SOCKADDR_IN _m_server_address;
          SOCKADDR_IN _m_client_address;
       #else
-         sockaddr_in _m_server_addres;
+         sockaddr_in _m_server_address;
          sockaddr_in _m_client_address;
       #endif 
 };
@@ -0,0 +1,619 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: topology.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// CPU and NUMA layout of the machine, read from /sys and limited to the
+// CPUs this process may run on, plus thread placement and node-local
+// memory built on it.
+//
+// A placement turns a thread count into one CPU set per thread:
+//
+//    compact  fill a core's hardware threads, then the next core, then the
+//             next node, so threads share caches
+//    scatter  one thread per node in turn, each on a core of its own
+//             before any core gets a second thread
+//    node     thread i may run on any CPU of node i % nodes
+//
+// describe() prints the result, so a report can record exactly where its
+// threads ran. node_buffer is memory bound to a NUMA node with mbind().
+// Elsewhere than Linux every CPU is its own core on node 0, pinning does
+// nothing and buffers are ordinary heap memory.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __TOPOLOGY_HPP__
+#define __TOPOLOGY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __linux__
+   #include <linux/mempolicy.h>
+   #include <pthread.h>
+   #include <sched.h>
+   #include <sys/mman.h>
+   #include <sys/syscall.h>
+   #include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+enum placement
+{
+   placement_none,
+   placement_compact,
+   placement_scatter,
+   placement_node
+};
+
+inline const char* placement_name(placement policy)
+{
+   switch (policy)
+   {
+      case placement_compact: return "compact";
+      case placement_scatter: return "scatter";
+      case placement_node: return "node";
+      default: return "none";
+   }
+}
+
+inline bool parse_placement(const std::string& name, placement& policy)
+{
+   if (name == "none") policy = placement_none;
+   else if (name == "compact") policy = placement_compact;
+   else if (name == "scatter") policy = placement_scatter;
+   else if (name == "node") policy = placement_node;
+   else return false;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class topology
+{
+   public:  // Type definitions
+
+      class cpu
+      {
+         public:
+
+            cpu() : id(0), core(0), package(0), node(0), sibling(0) { }
+
+            int id;
+            int core;
+            int package;
+            int node;
+
+            // 0 for a core's first hardware thread, 1 for its second...
+            int sibling;
+
+      }; // end of class(cpu)
+
+      // CPUs one thread may run on; empty means leave it unpinned
+      typedef std::vector<int> cpu_set;
+      typedef std::vector<cpu_set> plan;
+
+   public:  // Constructor | Destructor
+
+      topology() { _ctor(); }
+      ~topology() { }
+
+   public:  // Public Member Functions
+
+      // Allowed CPUs, ordered by id
+      const std::vector<cpu>& cpus() const { return _m_cpus; }
+
+      // Nodes with at least one allowed CPU, ordered by id
+      const std::vector<int>& nodes() const { return _m_nodes; }
+
+      std::size_t cores() const { return _m_cores; }
+
+      // -1 for a CPU outside the allowed set
+      int node_of(int cpu_id) const { return _node_of(cpu_id); }
+
+      plan place(placement policy, std::size_t threads) const { return _place(policy, threads); }
+
+      // "compact cpus 0,1,2,3", "node nodes 0,1" or "none"
+      std::string describe(placement policy, const plan& threads) const { return _describe(policy, threads); }
+
+      // Both return false when the kernel refused, or off Linux. An empty
+      // set always succeeds and leaves the thread where it is.
+      static bool pin(std::thread& thread, const cpu_set& set) { return _pin(thread.native_handle(), set); }
+      static bool pin_current(const cpu_set& set);
+
+      // CPU the calling thread is on right now, -1 if unknown
+      static int current_cpu();
+
+   private: // Private Member Functions
+
+      void _ctor()
+      {
+         std::vector<int> allowed = _allowed_cpus();
+
+         for (int id : allowed)
+         {
+            cpu current;
+
+            current.id = id;
+
+            std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+
+            current.core = _read_int(base + "core_id", id);
+            current.package = _read_int(base + "physical_package_id", 0);
+            current.node = -1;
+
+            _m_cpus.push_back(current);
+         }
+
+         // A CPU belongs to the node whose cpulist names it
+         for (int node : _parse_list(_read_line("/sys/devices/system/node/online")))
+         {
+            bool used = false;
+
+            for (int id : _parse_list(_read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")))
+            {
+               for (cpu& current : _m_cpus)
+               {
+                  if (current.id == id)
+                  {
+                     current.node = node;
+                     used = true;
+                  }
+               }
+            }
+
+            if (used) _m_nodes.push_back(node);
+         }
+
+         // No NUMA information: everything is node 0
+         for (cpu& current : _m_cpus)
+         {
+            if (current.node < 0)
+            {
+               current.node = 0;
+
+               if (std::find(_m_nodes.begin(), _m_nodes.end(), 0) == _m_nodes.end()) _m_nodes.insert(_m_nodes.begin(), 0);
+            }
+         }
+
+         // Number the hardware threads of each core
+         std::map<std::pair<int, int>, int> seen;
+
+         for (cpu& current : _m_cpus)
+         {
+            current.sibling = seen[std::make_pair(current.package, current.core)]++;
+         }
+
+         _m_cores = seen.size();
+      }
+
+      int _node_of(int cpu_id) const
+      {
+         for (const cpu& current : _m_cpus)
+         {
+            if (current.id == cpu_id) return current.node;
+         }
+
+         return -1;
+      }
+
+      plan _place(placement policy, std::size_t threads) const
+      {
+         plan result(threads);
+
+         if (policy == placement_none || _m_cpus.empty())
+         {
+            return result;
+         }
+
+         if (policy == placement_node)
+         {
+            for (std::size_t thread = 0; thread < threads; ++thread)
+            {
+               int node = _m_nodes[thread % _m_nodes.size()];
+
+               for (const cpu& current : _m_cpus)
+               {
+                  if (current.node == node) result[thread].push_back(current.id);
+               }
+            }
+
+            return result;
+         }
+
+         std::vector<cpu> order = _m_cpus;
+
+         if (policy == placement_compact)
+         {
+            std::sort(order.begin(), order.end(), [](const cpu& left, const cpu& right)
+            {
+               if (left.node != right.node) return left.node < right.node;
+               if (left.package != right.package) return left.package < right.package;
+               if (left.core != right.core) return left.core < right.core;
+
+               return left.id < right.id;
+            });
+         }
+
+         else
+         {
+            // Rank within the node first, then deal the nodes out in turn
+            std::sort(order.begin(), order.end(), [](const cpu& left, const cpu& right)
+            {
+               if (left.sibling != right.sibling) return left.sibling < right.sibling;
+               if (left.package != right.package) return left.package < right.package;
+               if (left.core != right.core) return left.core < right.core;
+
+               return left.id < right.id;
+            });
+
+            std::vector<std::vector<cpu> > per_node(_m_nodes.size());
+
+            for (const cpu& current : order)
+            {
+               per_node[std::find(_m_nodes.begin(), _m_nodes.end(), current.node) - _m_nodes.begin()].push_back(current);
+            }
+
+            order.clear();
+
+            for (std::size_t rank = 0; order.size() < _m_cpus.size(); ++rank)
+            {
+               for (const std::vector<cpu>& node : per_node)
+               {
+                  if (rank < node.size()) order.push_back(node[rank]);
+               }
+            }
+         }
+
+         for (std::size_t thread = 0; thread < threads; ++thread)
+         {
+            result[thread].push_back(order[thread % order.size()].id);
+         }
+
+         return result;
+      }
+
+      std::string _describe(placement policy, const plan& threads) const
+      {
+         std::string text = placement_name(policy);
+
+         if (policy == placement_none)
+         {
+            return text;
+         }
+
+         text += policy == placement_node ? " nodes " : " cpus ";
+
+         for (std::size_t thread = 0; thread < threads.size(); ++thread)
+         {
+            if (thread > 0) text += ",";
+
+            if (threads[thread].empty()) text += "-";
+            else text += std::to_string(policy == placement_node ? _node_of(threads[thread][0]) : threads[thread][0]);
+         }
+
+         return text;
+      }
+
+      #if __linux__
+         static bool _pin(pthread_t thread, const cpu_set& set)
+         {
+            if (set.empty())
+            {
+               return true;
+            }
+
+            cpu_set_t mask;
+
+            CPU_ZERO(&mask);
+
+            for (int id : set)
+            {
+               CPU_SET(id, &mask);
+            }
+
+            return ::pthread_setaffinity_np(thread, sizeof(mask), &mask) == 0;
+         }
+      #else
+         template <typename handle> static bool _pin(handle, const cpu_set& set)
+         {
+            return set.empty();
+         }
+      #endif
+
+      static std::vector<int> _allowed_cpus()
+      {
+         std::vector<int> cpus;
+
+         #if __linux__
+            cpu_set_t set;
+
+            CPU_ZERO(&set);
+
+            if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+            {
+               for (int id = 0; id < CPU_SETSIZE; ++id)
+               {
+                  if (CPU_ISSET(id, &set)) cpus.push_back(id);
+               }
+            }
+         #endif
+
+         if (cpus.empty())
+         {
+            unsigned int count = std::thread::hardware_concurrency();
+
+            for (unsigned int id = 0; id < (count > 0 ? count : 1); ++id)
+            {
+               cpus.push_back((int)id);
+            }
+         }
+
+         return cpus;
+      }
+
+      // "0-3,8,10-11" as used by cpulist files
+      static std::vector<int> _parse_list(const std::string& text)
+      {
+         std::vector<int> ids;
+
+         const char* cursor = text.c_str();
+
+         while (*cursor != '\0')
+         {
+            char* end = nullptr;
+
+            long first = std::strtol(cursor, &end, 10);
+
+            if (end == cursor) break;
+
+            long last = first;
+
+            cursor = end;
+
+            if (*cursor == '-')
+            {
+               last = std::strtol(cursor + 1, &end, 10);
+
+               cursor = end;
+            }
+
+            for (long id = first; id <= last; ++id)
+            {
+               ids.push_back((int)id);
+            }
+
+            if (*cursor == ',') ++cursor;
+            else break;
+         }
+
+         return ids;
+      }
+
+      static std::string _read_line(const std::string& path)
+      {
+         std::ifstream file(path);
+
+         std::string line;
+
+         std::getline(file, line);
+
+         return line;
+      }
+
+      static int _read_int(const std::string& path, int fallback)
+      {
+         std::ifstream file(path);
+
+         int value;
+
+         return file >> value ? value : fallback;
+      }
+
+   private: // Member Variables
+
+      std::vector<cpu> _m_cpus;
+      std::vector<int> _m_nodes;
+      std::size_t _m_cores;
+
+}; // end of class(topology)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+inline bool topology::pin_current(const cpu_set& set)
+{
+   #if __linux__
+      return _pin(::pthread_self(), set);
+   #else
+      return set.empty();
+   #endif
+}
+
+inline int topology::current_cpu()
+{
+   #if __linux__
+      return ::sched_getcpu();
+   #else
+      return -1;
+   #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Zeroed memory, optionally bound to one NUMA node. The pages are touched
+// when allocated, so they are placed (and faulted in) before any timing.
+class node_buffer
+{
+   public:  // Constructor | Destructor
+
+      node_buffer() : _m_data(nullptr), _m_size(0), _m_node(-1), _m_bound(false) { }
+      node_buffer(std::size_t size, int node = -1) : _m_data(nullptr), _m_size(0), _m_node(-1), _m_bound(false) { _allocate(size, node); }
+      ~node_buffer() { _release(); }
+
+   private: // Owns its memory, not copyable
+
+      node_buffer(const node_buffer&);
+      node_buffer& operator=(const node_buffer&);
+
+   public:  // Public Member Functions
+
+      // Replaces the contents with size zero bytes; node -1 lets the
+      // kernel choose as usual
+      void allocate(std::size_t size, int node = -1) { _allocate(size, node); }
+
+      char* data() { return _m_data; }
+      const char* data() const { return _m_data; }
+      std::size_t size() const { return _m_size; }
+
+      char& operator[](std::size_t index) { return _m_data[index]; }
+      const char& operator[](std::size_t index) const { return _m_data[index]; }
+
+      // The node asked for, and whether the kernel agreed to bind to it
+      int node() const { return _m_node; }
+      bool bound() const { return _m_bound; }
+
+      // Node the first page actually sits on, -1 if unknown
+      int resident_node() const { return _node_of(_m_data); }
+
+      // The same for any mapped address
+      static int node_of(const void* address) { return _node_of(address); }
+
+   private: // Private Member Functions
+
+      void _allocate(std::size_t size, int node)
+      {
+         _release();
+
+         _m_node = node;
+
+         if (size == 0)
+         {
+            return;
+         }
+
+         #if __linux__
+            void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (memory == MAP_FAILED)
+            {
+               throw std::runtime_error("Unable to map a " + std::to_string(size) + " byte buffer");
+            }
+
+            _m_data = (char*)memory;
+            _m_size = size;
+
+            if (node >= 0 && node < 1024)
+            {
+               unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+
+               mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+
+               // MPOL_PREFERRED falls back to other nodes instead of failing
+               // the page fault when the node runs out of memory
+               _m_bound = ::syscall(SYS_mbind, memory, size, MPOL_PREFERRED, mask, (unsigned long)1024, 0) == 0;
+            }
+         #else
+            _m_data = new char[size];
+            _m_size = size;
+         #endif
+
+         // First touch places every page
+         std::memset(_m_data, 0, _m_size);
+      }
+
+      void _release()
+      {
+         if (_m_data == nullptr)
+         {
+            return;
+         }
+
+         #if __linux__
+            ::munmap(_m_data, _m_size);
+         #else
+            delete [] _m_data;
+         #endif
+
+         _m_data = nullptr;
+         _m_size = 0;
+         _m_bound = false;
+      }
+
+      static int _node_of(const void* address)
+      {
+         #if __linux__
+            if (address == nullptr)
+            {
+               return -1;
+            }
+
+            int node = -1;
+
+            if (::syscall(SYS_get_mempolicy, &node, nullptr, 0UL, address, (unsigned long)(MPOL_F_NODE | MPOL_F_ADDR)) != 0)
+            {
+               return -1;
+            }
+
+            return node;
+         #else
+            (void)address;
+
+            return -1;
+         #endif
+      }
+
+   private: // Member Variables
+
+      char* _m_data;
+      std::size_t _m_size;
+
+      int _m_node;
+      bool _m_bound;
+
+}; // end of class(node_buffer)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __TOPOLOGY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: transport.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// The connection surface ev9::socket shares with the intra-host transports
+// in local.hpp: a server binds, listens and accepts one connection at a
+// time, reading it with read() and answering with write_back(); a client
+// connects, writes with write() and reads the answers with read_back().
+// Reads return 0 once the peer has closed, writes may be short.
+//
+// Code that only moves bytes (bandwidth copy mode, latency) holds a
+// transport and can run over any of them, picked by transport_kind. Calls
+// on an ev9::socket itself do not go through the virtual table.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __TRANSPORT_HPP__
+#define __TRANSPORT_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+enum transport_kind
+{
+   transport_tcp,
+   transport_unix,
+   transport_unix_datagram,
+   transport_shm
+};
+
+inline const char* transport_kind_name(transport_kind kind)
+{
+   switch (kind)
+   {
+      case transport_unix: return "unix";
+      case transport_unix_datagram: return "unix-datagram";
+      case transport_shm: return "shm";
+      default: return "tcp";
+   }
+}
+
+inline bool parse_transport_kind(const std::string& name, transport_kind& kind)
+{
+   if (name == "tcp") kind = transport_tcp;
+   else if (name == "unix") kind = transport_unix;
+   else if (name == "unix-datagram") kind = transport_unix_datagram;
+   else if (name == "shm") kind = transport_shm;
+   else return false;
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class transport
+{
+   public:  // Constructor | Destructor
+
+      virtual ~transport() { }
+
+   public:  // Public Member Functions
+
+      void accept() { _accept(); }
+      void bind() { _bind(); }
+      void close() { _close(); }
+      void close_accepted() { _close_accepted(); }
+
+      // From another thread: shuts the listening socket down, so a blocked
+      // accept() fails with an exception. Only close() is left after it.
+      void interrupt() { _interrupt(); }
+
+      // Retries a peer that is not listening yet until timeout seconds
+      // have passed; 0 tries once
+      void connect(double timeout, double retry_delay = 0.001) { _connect(timeout, retry_delay); }
+      void listen(int backlog) { _listen(backlog); }
+
+      std::size_t read(char* const buffer, std::size_t size) { return _read(buffer, size); }
+      std::size_t read_back(char* const buffer, std::size_t size) { return _read_back(buffer, size); }
+      std::size_t write(const char* const buffer, std::size_t size) { return _write(buffer, size); }
+      std::size_t write_back(const char* const buffer, std::size_t size) { return _write_back(buffer, size); }
+
+      // Short only when the peer closes first
+      std::size_t read_all(char* const buffer, std::size_t size) { return _fill(false, buffer, size); }
+      std::size_t read_back_all(char* const buffer, std::size_t size) { return _fill(true, buffer, size); }
+
+      // "tcp", "unix", "shm"...
+      const char* transport_name() const { return _transport_name(); }
+
+   private: // Implemented by each transport
+
+      virtual void _accept() = 0;
+      virtual void _bind() = 0;
+      virtual void _close() = 0;
+      virtual void _close_accepted() = 0;
+      virtual void _interrupt() = 0;
+      virtual void _connect(double timeout, double retry_delay) = 0;
+      virtual void _listen(int backlog) = 0;
+
+      virtual std::size_t _read(char* const buffer, std::size_t size) = 0;
+      virtual std::size_t _read_back(char* const buffer, std::size_t size) = 0;
+      virtual std::size_t _write(const char* const buffer, std::size_t size) = 0;
+      virtual std::size_t _write_back(const char* const buffer, std::size_t size) = 0;
+
+      virtual const char* _transport_name() const = 0;
+
+   private: // Private Member Functions
+
+      std::size_t _fill(bool back, char* const buffer, std::size_t size)
+      {
+         std::size_t total = 0;
+
+         while (total < size)
+         {
+            std::size_t amount_read = back ? _read_back(buffer + total, size - total) : _read(buffer + total, size - total);
+
+            if (amount_read == 0)
+            {
+               break;
+            }
+
+            total += amount_read;
+         }
+
+         return total;
+      }
+
+}; // end of class(transport)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __TRANSPORT_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
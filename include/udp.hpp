@@ -0,0 +1,541 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: udp.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Datagram throughput over a UDP ev9::socket. Every packet starts with a
+// sequence number and a send timestamp; the receiver counts loss and
+// reordering from the sequence numbers and keeps the RFC 3550 interarrival
+// jitter from the timestamps. Both sides move packets in batches with
+// sendmmsg/recvmmsg, optionally with UDP GSO/GRO so one buffer carries up
+// to 64 packets. The sender stamps each batch once, as the kernel sends it
+// back to back. The receiver takes each datagram's kernel receive time
+// (SO_TIMESTAMPNS); a GRO buffer has one for all its packets, so only its
+// first packet feeds the jitter. Without kernel timestamps only the first
+// packet of each receive batch does, against one clock read per batch,
+// and the jitter is reported as per batch. The sender ends a run with a
+// few end markers that carry the number of packets sent.
+//
+// Requirements: c++11, POSIX sockets
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __UDP_HPP__
+#define __UDP_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "socket.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class udp_bandwidth
+{
+   public:  // Type definitions
+
+      typedef std::chrono::steady_clock clock;
+
+      class result
+      {
+         public:  // Constructor
+
+            result() : packets(0), bytes(0), syscalls(0), seconds(0), lost(0), reordered(0), jitter(0), kernel_timestamps(false), offload(false) { }
+
+         public:  // Public Member Functions
+
+            double gbits() const { return seconds > 0 ? (bytes * 8.0) / seconds / 1e9 : 0; }
+            double packets_per_second() const { return seconds > 0 ? packets / seconds : 0; }
+            double packets_per_syscall() const { return syscalls ? (double)packets / syscalls : 0; }
+            double loss_percent() const { return packets + lost ? lost * 100.0 / (packets + lost) : 0; }
+
+         public:  // Member Variables
+
+            std::size_t packets;
+            std::size_t bytes;
+            std::size_t syscalls;
+            double seconds;
+
+            // Receiver only: packets that never arrived, packets that
+            // arrived after a later one, and RFC 3550 jitter in seconds
+            std::size_t lost;
+            std::size_t reordered;
+            double jitter;
+
+            // Jitter from per-datagram kernel receive times rather than
+            // from one clock read per receive batch
+            bool kernel_timestamps;
+
+            // GSO on the sender, GRO on the receiver
+            bool offload;
+
+      }; // end of class(result)
+
+   public:  // Constructor | Destructor
+
+      udp_bandwidth(std::size_t port, std::size_t packet_size = 1472) { _ctor(port, packet_size); }
+      ~udp_bandwidth() { _dtor(); }
+
+   private: // Owns its socket, not copyable
+
+      udp_bandwidth(const udp_bandwidth&);
+      udp_bandwidth& operator=(const udp_bandwidth&);
+
+   public:  // Public Member Functions
+
+      void listen() { _listen(); }
+
+      // Counts packets until the sender's end marker, or until nothing has
+      // arrived for the idle timeout once the first packet is in
+      result receive() { return _receive(); }
+      result send(const std::string& host) { return _send(host); }
+
+      // Receiver, from another thread: makes a receive() still waiting for
+      // its first packet return empty, for when the sender gave up
+      void interrupt() { _interrupt(); }
+
+      void set_byte_count(std::size_t bytes) { _m_byte_count = bytes; }
+      void set_duration(double seconds) { _m_duration = seconds; }
+      void set_idle_timeout(double seconds) { _m_idle_timeout = seconds; }
+
+      // Packets per sendmmsg/recvmmsg call, and an optional send rate in
+      // bits per second (0 sends as fast as the socket takes them)
+      void set_batch(std::size_t packets) { _m_batch = packets ? packets : 1; }
+      void set_rate(double bits_per_second) { _m_rate = bits_per_second; }
+      void set_offload(bool offload) { _m_offload = offload; }
+
+      static void print(const char* const label, const result& res) { _print(label, res); }
+
+   private: // Private Member Functions
+
+      void _ctor(std::size_t port, std::size_t packet_size)
+      {
+         if (packet_size < sizeof(header) || packet_size > largest_packet)
+         {
+            throw std::runtime_error("UDP packets must hold the 16 byte header and fit in one datagram");
+         }
+
+         _m_port = port;
+         _m_packet_size = packet_size;
+         _m_byte_count = 0;
+         _m_duration = 10;
+         _m_idle_timeout = 2;
+         _m_batch = 64;
+         _m_rate = 0;
+         _m_offload = false;
+         _m_receive_offload = false;
+         _m_receive_timestamps = false;
+         _m_socket = nullptr;
+         _m_interrupted = false;
+      }
+
+      void _dtor()
+      {
+         if (_m_socket != nullptr) delete _m_socket;
+      }
+
+      void _interrupt()
+      {
+         _m_interrupted = true;
+
+         // A shut down UDP socket reads as empty datagrams, which the flag
+         // tells apart from real ones
+         if (_m_socket != nullptr) _m_socket->interrupt();
+      }
+
+      void _listen()
+      {
+         _reset_socket(new ev9::socket(_m_port, ev9::socket::protocol_udp));
+
+         _m_socket->bind();
+
+         _m_receive_offload = _m_offload && _m_socket->enable_gro();
+         _m_receive_timestamps = _m_socket->enable_timestamps();
+      }
+
+      result _receive()
+      {
+         if (_m_socket == nullptr)
+         {
+            _listen();
+         }
+
+         // Any datagram fits, and a GRO buffer holds up to 64 packets
+         const std::size_t buffer_size = 64 * 1024;
+
+         std::vector<char> memory(_m_batch * buffer_size);
+         std::vector<ev9::socket::segment> buffers(_m_batch);
+         std::vector<std::size_t> sizes(_m_batch);
+         std::vector<std::size_t> segment_sizes(_m_batch);
+         std::vector<std::int64_t> arrivals(_m_batch);
+
+         for (std::size_t index = 0; index < _m_batch; ++index)
+         {
+            buffers[index].iov_base = &memory[index * buffer_size];
+            buffers[index].iov_len = buffer_size;
+         }
+
+         result res;
+
+         res.offload = _m_receive_offload;
+         res.kernel_timestamps = _m_receive_timestamps;
+
+         std::size_t calls = _m_socket->datagram_calls();
+
+         std::uint64_t expected = 0;
+         std::uint64_t next_sequence = 0;
+
+         bool have_transit = false;
+         std::int64_t last_transit = 0;
+
+         clock::time_point first;
+         clock::time_point last;
+
+         bool finished = false;
+
+         _m_socket->set_receive_timeout(0);
+
+         while (!finished)
+         {
+            std::size_t count = _m_socket->read_datagrams(buffers.data(), buffers.size(), sizes.data(), segment_sizes.data(), arrivals.data());
+
+            // Idle timeout: the sender is gone and its end markers were lost
+            if (count == 0 || _m_interrupted)
+            {
+               break;
+            }
+
+            clock::time_point arrival = clock::now();
+
+            for (std::size_t index = 0; index < count && !finished; ++index)
+            {
+               const char* data = (const char*)buffers[index].iov_base;
+
+               // Packets sharing an arrival time say nothing about jitter:
+               // one sample per datagram buffer, or per batch without
+               // kernel timestamps
+               bool sample = res.kernel_timestamps ? arrivals[index] != 0 : index == 0;
+
+               std::int64_t arrival_ns = res.kernel_timestamps ? arrivals[index] : _nanoseconds(arrival);
+
+               std::size_t step = segment_sizes[index] ? segment_sizes[index] : sizes[index];
+
+               for (std::size_t offset = 0; offset < sizes[index] && !finished; offset += step)
+               {
+                  std::size_t size = sizes[index] - offset < step ? sizes[index] - offset : step;
+
+                  if (size < sizeof(header))
+                  {
+                     continue;
+                  }
+
+                  header packet;
+
+                  memcpy(&packet, data + offset, sizeof(packet));
+
+                  if (packet.sequence == end_marker)
+                  {
+                     // Markers left over from an earlier run are skipped
+                     if (res.packets)
+                     {
+                        expected = packet.timestamp;
+                        finished = true;
+                     }
+
+                     continue;
+                  }
+
+                  if (res.packets == 0)
+                  {
+                     first = arrival;
+
+                     _m_socket->set_receive_timeout(_m_idle_timeout);
+                  }
+
+                  ++res.packets;
+
+                  res.bytes += size;
+
+                  last = arrival;
+
+                  if (packet.sequence >= next_sequence) next_sequence = packet.sequence + 1;
+                  else ++res.reordered;
+
+                  if (!sample)
+                  {
+                     continue;
+                  }
+
+                  sample = false;
+
+                  // RFC 3550 6.4.1: J += (|D(i-1, i)| - J) / 16. A clock offset
+                  // between the hosts cancels out of D.
+                  std::int64_t transit = arrival_ns - (std::int64_t)packet.timestamp;
+
+                  if (have_transit)
+                  {
+                     std::int64_t difference = transit - last_transit;
+
+                     if (difference < 0) difference = -difference;
+
+                     res.jitter += ((double)difference / 1e9 - res.jitter) / 16.0;
+                  }
+
+                  have_transit = true;
+                  last_transit = transit;
+               }
+            }
+         }
+
+         _m_socket->set_receive_timeout(0);
+
+         if (expected == 0) expected = next_sequence;
+
+         res.lost = expected > res.packets ? (std::size_t)(expected - res.packets) : 0;
+         res.seconds = res.packets ? std::chrono::duration<double>(last - first).count() : 0;
+         res.syscalls = _m_socket->datagram_calls() - calls;
+
+         return res;
+      }
+
+      result _send(const std::string& host)
+      {
+         _reset_socket(new ev9::socket(host, _m_port, ev9::socket::protocol_udp));
+
+         _m_socket->connect();
+
+         result res;
+
+         res.offload = _m_offload && _m_socket->enable_gso(_m_packet_size);
+
+         // With GSO each buffer carries as many packets as fit in 64 KiB
+         std::size_t per_message = 1;
+
+         if (res.offload)
+         {
+            per_message = largest_packet / _m_packet_size;
+
+            if (per_message > 64) per_message = 64;
+         }
+
+         std::vector<char> memory(_m_batch * per_message * _m_packet_size);
+         std::vector<ev9::socket::segment> messages(_m_batch);
+
+         for (std::size_t index = 0; index < memory.size(); ++index)
+         {
+            memory[index] = (char)(index * 31 + 7);
+         }
+
+         std::size_t total_packets = _m_byte_count ? (_m_byte_count + _m_packet_size - 1) / _m_packet_size : 0;
+
+         std::size_t calls = _m_socket->datagram_calls();
+
+         std::uint64_t sequence = 0;
+
+         auto start = clock::now();
+
+         while (true)
+         {
+            std::size_t packets = _m_batch * per_message;
+
+            if (total_packets)
+            {
+               if (sequence >= total_packets) break;
+
+               if (total_packets - sequence < packets) packets = total_packets - sequence;
+            }
+
+            else if (_seconds_since(start) >= _m_duration)
+            {
+               break;
+            }
+
+            std::int64_t now = _nanoseconds(clock::now());
+
+            for (std::size_t index = 0; index < packets; ++index)
+            {
+               header packet;
+
+               packet.sequence = sequence + index;
+               packet.timestamp = (std::uint64_t)now;
+
+               memcpy(&memory[index * _m_packet_size], &packet, sizeof(packet));
+            }
+
+            std::size_t message_count = (packets + per_message - 1) / per_message;
+
+            for (std::size_t index = 0; index < message_count; ++index)
+            {
+               std::size_t in_message = packets - index * per_message < per_message ? packets - index * per_message : per_message;
+
+               messages[index].iov_base = &memory[index * per_message * _m_packet_size];
+               messages[index].iov_len = in_message * _m_packet_size;
+            }
+
+            std::size_t sent = _m_socket->write_datagrams(messages.data(), message_count);
+
+            // Packets that did not go are stamped again for the next batch
+            std::size_t sent_packets = sent == message_count ? packets : sent * per_message;
+
+            sequence += sent_packets;
+
+            res.packets += sent_packets;
+            res.bytes += sent_packets * _m_packet_size;
+
+            if (_m_rate > 0)
+            {
+               auto due = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(res.bytes * 8.0 / _m_rate));
+
+               if (due > clock::now()) std::this_thread::sleep_until(due);
+            }
+         }
+
+         res.seconds = _seconds_since(start);
+
+         // Let the receiver drain before it hears how many packets to expect
+         std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+         header marker;
+
+         marker.sequence = end_marker;
+         marker.timestamp = sequence;
+
+         ev9::socket::segment end;
+
+         end.iov_base = &marker;
+         end.iov_len = sizeof(marker);
+
+         for (int repeat = 0; repeat < 3; ++repeat)
+         {
+            _m_socket->write_datagrams(&end, 1);
+         }
+
+         res.syscalls = _m_socket->datagram_calls() - calls;
+
+         _reset_socket(nullptr);
+
+         return res;
+      }
+
+      void _reset_socket(ev9::socket* socket)
+      {
+         if (_m_socket != nullptr) delete _m_socket;
+
+         _m_socket = socket;
+      }
+
+      static std::int64_t _nanoseconds(clock::time_point time)
+      {
+         return (std::int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+      }
+
+      static double _seconds_since(clock::time_point start)
+      {
+         std::chrono::duration<double> elapsed = clock::now() - start;
+
+         return elapsed.count();
+      }
+
+      static void _print(const char* const label, const result& res)
+      {
+         std::printf("[%s] %lu packets, %lu bytes in %.3f s, %.3f Mpps, %.3f Gbit/s\n",
+                     label,
+                     (unsigned long)res.packets,
+                     (unsigned long)res.bytes,
+                     res.seconds,
+                     res.packets_per_second() / 1e6,
+                     res.gbits());
+
+         std::printf("[%s] %lu syscalls, %.1f packets/syscall%s\n",
+                     label,
+                     (unsigned long)res.syscalls,
+                     res.packets_per_syscall(),
+                     res.offload ? ", UDP offload on" : "");
+
+         if (res.lost || res.reordered || res.jitter > 0)
+         {
+            std::printf("[%s] lost %lu (%.3f%%), reordered %lu, jitter %.3f us%s\n",
+                        label,
+                        (unsigned long)res.lost,
+                        res.loss_percent(),
+                        (unsigned long)res.reordered,
+                        res.jitter * 1e6,
+                        res.kernel_timestamps ? "" : " (per batch)");
+         }
+      }
+
+   private: // Wire format
+
+      class header
+      {
+         public:  // Member Variables
+
+            std::uint64_t sequence;
+            std::uint64_t timestamp;
+
+      }; // end of class(header)
+
+      static const std::uint64_t end_marker = ~0ULL;
+
+      // Largest UDP payload over IPv4
+      static const std::size_t largest_packet = 65507;
+
+   private: // Member Variables
+
+      ev9::socket* _m_socket;
+
+      // Set by interrupt() from another thread
+      std::atomic<bool> _m_interrupted;
+
+      std::size_t _m_port;
+      std::size_t _m_packet_size;
+      std::size_t _m_byte_count;
+      std::size_t _m_batch;
+
+      double _m_duration;
+      double _m_idle_timeout;
+      double _m_rate;
+
+      bool _m_offload;
+      bool _m_receive_offload;
+      bool _m_receive_timestamps;
+
+}; // end of class(udp_bandwidth)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __UDP_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of udp.hpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,551 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: uring.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Thin io_uring wrapper over the raw system calls (no liburing). Owns the
+// submission and completion rings, registered files and buffers, and an
+// optional provided-buffer ring for multishot receives. Submissions queue
+// up in next() and go to the kernel together on submit(); completions are
+// popped straight from the shared ring without a system call when there
+// are any. ev9::socket uses this as its io_uring backend.
+//
+// Requirements: c++11, Linux 5.19+ for provided buffer rings and multishot
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __URING_HPP__
+#define __URING_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class uring
+{
+   public:  // Inner Classes
+
+      class completion
+      {
+         public:  // Constructor
+
+            completion() : user_data(0), result(0), flags(0) { }
+
+         public:  // Member Variables
+
+            std::uint64_t user_data;
+
+            int result;
+            unsigned int flags;
+
+      }; // end of class(completion)
+
+   public:  // Constructor | Destructor
+
+      uring(unsigned int entries = 64) { _ctor(entries); }
+      ~uring() { _dtor(); }
+
+   private: // Owns the ring mappings, not copyable
+
+      uring(const uring&);
+      uring& operator=(const uring&);
+
+   public:  // Public Member Functions
+
+      // False when the kernel has no io_uring or it is disabled for us
+      static bool available() { return _available(); }
+
+      // A zeroed entry to fill in; it is sent with the next submit()
+      io_uring_sqe* next() { return _next(); }
+
+      // Sends everything queued and waits for at least wait_for completions
+      void submit(unsigned int wait_for = 0) { _submit(wait_for); }
+
+      // peek() never enters the kernel; wait() does only when it must
+      bool peek(completion& out) { return _peek(out); }
+      void wait(completion& out) { _wait(out); }
+
+      bool supports(unsigned char opcode) const { return opcode < _m_supported.size() && _m_supported[opcode]; }
+
+      // Registered files are addressed by slot with IOSQE_FIXED_FILE; -1
+      // leaves a slot empty
+      bool register_files(const int* fds, unsigned int count) { return _register(IORING_REGISTER_FILES, fds, count) == 0; }
+      bool update_file(unsigned int slot, int fd) { return _update_file(slot, fd); }
+
+      // One registered buffer at index 0 for READ_FIXED/WRITE_FIXED;
+      // registering again replaces it
+      bool register_buffer(const void* address, std::size_t size) { return _register_buffer(address, size); }
+      bool contains_registered(const void* address, std::size_t size) const { return _contains_registered(address, size); }
+
+      // Provided buffers the kernel picks from for IOSQE_BUFFER_SELECT
+      bool setup_buffer_group(unsigned short group, unsigned int count, std::size_t size) { return _setup_buffer_group(group, count, size); }
+      char* group_buffer(unsigned short id) { return _m_group_memory + (std::size_t)id * _m_group_buffer_size; }
+      void recycle(unsigned short id) { _recycle(id); }
+      unsigned short buffer_group() const { return _m_group; }
+      bool has_buffer_group() const { return _m_group_ring != nullptr; }
+
+      // io_uring_enter calls made so far
+      std::size_t enters() const { return _m_enters; }
+      unsigned int entries() const { return _m_sq_entries; }
+
+      // Entries queued but not yet taken by the kernel, and room for more
+      unsigned int queued() const { return _m_local_tail - __atomic_load_n(_m_sq_head, __ATOMIC_ACQUIRE); }
+      unsigned int space() const { return _m_sq_entries - queued(); }
+
+   private: // Private Member Functions
+
+      void _ctor(unsigned int entries)
+      {
+         _m_fd = -1;
+         _m_enters = 0;
+         _m_ring = nullptr;
+         _m_ring_size = 0;
+         _m_cq_ring = nullptr;
+         _m_cq_ring_size = 0;
+         _m_sqes = nullptr;
+         _m_buffer_registered = false;
+         _m_registered_address = nullptr;
+         _m_registered_size = 0;
+         _m_group_ring = nullptr;
+         _m_group_memory = nullptr;
+         _m_group_count = 0;
+         _m_group_buffer_size = 0;
+         _m_group_tail = 0;
+         _m_group = 0;
+
+         io_uring_params params;
+
+         memset(&params, 0, sizeof(params));
+
+         // Completions are only reaped by the submitting thread
+         params.flags = IORING_SETUP_COOP_TASKRUN;
+
+         _m_fd = (int)::syscall(__NR_io_uring_setup, entries, &params);
+
+         if (_m_fd < 0 && errno == EINVAL)
+         {
+            // Older kernel without COOP_TASKRUN
+            memset(&params, 0, sizeof(params));
+
+            _m_fd = (int)::syscall(__NR_io_uring_setup, entries, &params);
+         }
+
+         if (_m_fd < 0)
+         {
+            throw std::runtime_error("io_uring is not available");
+         }
+
+         std::size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+         std::size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+         bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+         if (single_mmap && cq_size > sq_size) sq_size = cq_size;
+
+         _m_ring_size = sq_size;
+         _m_ring = (char*)::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _m_fd, IORING_OFF_SQ_RING);
+
+         if (_m_ring == MAP_FAILED)
+         {
+            _m_ring = nullptr;
+
+            _dtor();
+
+            throw std::runtime_error("Unable to map the io_uring submission ring");
+         }
+
+         if (single_mmap)
+         {
+            _m_cq_ring = _m_ring;
+         }
+
+         else
+         {
+            _m_cq_ring_size = cq_size;
+            _m_cq_ring = (char*)::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _m_fd, IORING_OFF_CQ_RING);
+
+            if (_m_cq_ring == MAP_FAILED)
+            {
+               _m_cq_ring = nullptr;
+
+               _dtor();
+
+               throw std::runtime_error("Unable to map the io_uring completion ring");
+            }
+         }
+
+         _m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+         _m_sqes = (io_uring_sqe*)::mmap(nullptr, _m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _m_fd, IORING_OFF_SQES);
+
+         if (_m_sqes == MAP_FAILED)
+         {
+            _m_sqes = nullptr;
+
+            _dtor();
+
+            throw std::runtime_error("Unable to map the io_uring submission entries");
+         }
+
+         _m_sq_head = (unsigned int*)(_m_ring + params.sq_off.head);
+         _m_sq_tail = (unsigned int*)(_m_ring + params.sq_off.tail);
+         _m_sq_mask = *(unsigned int*)(_m_ring + params.sq_off.ring_mask);
+         _m_sq_entries = params.sq_entries;
+
+         _m_cq_head = (unsigned int*)(_m_cq_ring + params.cq_off.head);
+         _m_cq_tail = (unsigned int*)(_m_cq_ring + params.cq_off.tail);
+         _m_cq_mask = *(unsigned int*)(_m_cq_ring + params.cq_off.ring_mask);
+         _m_cqes = (io_uring_cqe*)(_m_cq_ring + params.cq_off.cqes);
+
+         // Entry i of the index array always points at sqe i
+         unsigned int* array = (unsigned int*)(_m_ring + params.sq_off.array);
+
+         for (unsigned int index = 0; index < params.sq_entries; ++index)
+         {
+            array[index] = index;
+         }
+
+         _m_local_tail = *_m_sq_tail;
+
+         _probe();
+      }
+
+      void _dtor()
+      {
+         if (_m_group_ring != nullptr) ::munmap(_m_group_ring, _group_ring_size());
+         if (_m_group_memory != nullptr) ::munmap(_m_group_memory, (std::size_t)_m_group_count * _m_group_buffer_size);
+
+         if (_m_sqes != nullptr) ::munmap(_m_sqes, _m_sqes_size);
+         if (_m_cq_ring != nullptr && _m_cq_ring != _m_ring) ::munmap(_m_cq_ring, _m_cq_ring_size);
+         if (_m_ring != nullptr) ::munmap(_m_ring, _m_ring_size);
+
+         // Unregistering drops the ring's references to the files now rather
+         // than from the kernel's deferred teardown, so a listener's port is
+         // free again as soon as its socket is closed. Closing the ring
+         // cancels anything still in flight.
+         if (_m_fd >= 0) _register(IORING_UNREGISTER_FILES, nullptr, 0);
+         if (_m_fd >= 0) ::close(_m_fd);
+
+         _m_group_ring = nullptr;
+         _m_group_memory = nullptr;
+         _m_sqes = nullptr;
+         _m_cq_ring = nullptr;
+         _m_ring = nullptr;
+         _m_fd = -1;
+      }
+
+      static bool _available()
+      {
+         static const bool available = _probe_available();
+
+         return available;
+      }
+
+      static bool _probe_available()
+      {
+         io_uring_params params;
+
+         memset(&params, 0, sizeof(params));
+
+         int fd = (int)::syscall(__NR_io_uring_setup, 2, &params);
+
+         if (fd < 0) return false;
+
+         ::close(fd);
+
+         return true;
+      }
+
+      void _probe()
+      {
+         const unsigned int op_count = 256;
+
+         std::vector<char> memory(sizeof(io_uring_probe) + op_count * sizeof(io_uring_probe_op), 0);
+
+         io_uring_probe* probe = (io_uring_probe*)&memory[0];
+
+         _m_supported.assign(op_count, false);
+
+         if (_register(IORING_REGISTER_PROBE, probe, op_count) != 0)
+         {
+            return;
+         }
+
+         for (unsigned int index = 0; index < probe->ops_len && index < op_count; ++index)
+         {
+            _m_supported[probe->ops[index].op] = (probe->ops[index].flags & IO_URING_OP_SUPPORTED) != 0;
+         }
+      }
+
+      int _register(unsigned int opcode, const void* argument, unsigned int count)
+      {
+         return (int)::syscall(__NR_io_uring_register, _m_fd, opcode, argument, count);
+      }
+
+      bool _update_file(unsigned int slot, int fd)
+      {
+         io_uring_files_update update;
+
+         memset(&update, 0, sizeof(update));
+
+         update.offset = slot;
+         update.fds = (std::uint64_t)(std::uintptr_t)&fd;
+
+         return _register(IORING_REGISTER_FILES_UPDATE, &update, 1) == 1;
+      }
+
+      bool _register_buffer(const void* address, std::size_t size)
+      {
+         if (_m_buffer_registered)
+         {
+            _register(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+
+            _m_buffer_registered = false;
+         }
+
+         iovec buffer;
+
+         buffer.iov_base = (void*)address;
+         buffer.iov_len = size;
+
+         _m_buffer_registered = _register(IORING_REGISTER_BUFFERS, &buffer, 1) == 0;
+
+         _m_registered_address = _m_buffer_registered ? (const char*)address : nullptr;
+         _m_registered_size = _m_buffer_registered ? size : 0;
+
+         return _m_buffer_registered;
+      }
+
+      bool _contains_registered(const void* address, std::size_t size) const
+      {
+         const char* start = (const char*)address;
+
+         return _m_buffer_registered && start >= _m_registered_address && start + size <= _m_registered_address + _m_registered_size;
+      }
+
+      std::size_t _group_ring_size() const
+      {
+         return (std::size_t)_m_group_count * sizeof(io_uring_buf);
+      }
+
+      bool _setup_buffer_group(unsigned short group, unsigned int count, std::size_t size)
+      {
+         // The ring size has to be a power of two
+         if (_m_group_ring != nullptr || count == 0 || (count & (count - 1)) != 0 || count > 32768)
+         {
+            return false;
+         }
+
+         _m_group_count = count;
+         _m_group_buffer_size = size;
+
+         void* ring = ::mmap(nullptr, _group_ring_size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+         void* memory = ::mmap(nullptr, (std::size_t)count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+
+         io_uring_buf_reg registration;
+
+         memset(&registration, 0, sizeof(registration));
+
+         registration.ring_addr = (std::uint64_t)(std::uintptr_t)ring;
+         registration.ring_entries = count;
+         registration.bgid = group;
+
+         if (ring == MAP_FAILED || memory == MAP_FAILED || _register(IORING_REGISTER_PBUF_RING, &registration, 1) != 0)
+         {
+            if (ring != MAP_FAILED) ::munmap(ring, _group_ring_size());
+            if (memory != MAP_FAILED) ::munmap(memory, (std::size_t)count * size);
+
+            _m_group_count = 0;
+
+            return false;
+         }
+
+         _m_group = group;
+         _m_group_ring = (io_uring_buf_ring*)ring;
+         _m_group_memory = (char*)memory;
+         _m_group_tail = 0;
+
+         for (unsigned int id = 0; id < count; ++id)
+         {
+            _recycle((unsigned short)id);
+         }
+
+         return true;
+      }
+
+      void _recycle(unsigned short id)
+      {
+         // Only addr, len and bid are written: the ring's tail lives in the
+         // first entry's reserved field. The entries start at the ring
+         // itself; bufs[] is offset in C++, where an empty struct has size.
+         io_uring_buf* buffer = (io_uring_buf*)_m_group_ring + (_m_group_tail & (_m_group_count - 1));
+
+         buffer->addr = (std::uint64_t)(std::uintptr_t)group_buffer(id);
+         buffer->len = (unsigned int)_m_group_buffer_size;
+         buffer->bid = id;
+
+         ++_m_group_tail;
+
+         __atomic_store_n(&_m_group_ring->tail, _m_group_tail, __ATOMIC_RELEASE);
+      }
+
+      io_uring_sqe* _next()
+      {
+         // Full: hand what is queued to the kernel to make room
+         while (_m_local_tail - __atomic_load_n(_m_sq_head, __ATOMIC_ACQUIRE) >= _m_sq_entries)
+         {
+            _submit(0);
+         }
+
+         io_uring_sqe* sqe = &_m_sqes[_m_local_tail & _m_sq_mask];
+
+         memset(sqe, 0, sizeof(io_uring_sqe));
+
+         ++_m_local_tail;
+
+         return sqe;
+      }
+
+      void _submit(unsigned int wait_for)
+      {
+         __atomic_store_n(_m_sq_tail, _m_local_tail, __ATOMIC_RELEASE);
+
+         while (true)
+         {
+            unsigned int to_submit = _m_local_tail - __atomic_load_n(_m_sq_head, __ATOMIC_ACQUIRE);
+
+            unsigned int flags = wait_for ? IORING_ENTER_GETEVENTS : 0;
+
+            long result = ::syscall(__NR_io_uring_enter, _m_fd, to_submit, wait_for, flags, nullptr, 0);
+
+            ++_m_enters;
+
+            if (result >= 0)
+            {
+               return;
+            }
+
+            if (errno == EINTR)
+            {
+               continue;
+            }
+
+            // Completion ring overflowing; the caller has to reap first
+            if (errno == EBUSY || errno == EAGAIN)
+            {
+               return;
+            }
+
+            throw std::runtime_error("io_uring_enter failed");
+         }
+      }
+
+      bool _peek(completion& out)
+      {
+         unsigned int head = *_m_cq_head;
+
+         if (head == __atomic_load_n(_m_cq_tail, __ATOMIC_ACQUIRE))
+         {
+            return false;
+         }
+
+         const io_uring_cqe& cqe = _m_cqes[head & _m_cq_mask];
+
+         out.user_data = cqe.user_data;
+         out.result = cqe.res;
+         out.flags = cqe.flags;
+
+         __atomic_store_n(_m_cq_head, head + 1, __ATOMIC_RELEASE);
+
+         return true;
+      }
+
+      void _wait(completion& out)
+      {
+         while (!_peek(out))
+         {
+            _submit(1);
+         }
+      }
+
+   private: // Member Variables
+
+      int _m_fd;
+
+      std::size_t _m_enters;
+
+      char* _m_ring;
+      std::size_t _m_ring_size;
+      char* _m_cq_ring;
+      std::size_t _m_cq_ring_size;
+
+      io_uring_sqe* _m_sqes;
+      std::size_t _m_sqes_size;
+
+      unsigned int* _m_sq_head;
+      unsigned int* _m_sq_tail;
+      unsigned int _m_sq_mask;
+      unsigned int _m_sq_entries;
+      unsigned int _m_local_tail;
+
+      unsigned int* _m_cq_head;
+      unsigned int* _m_cq_tail;
+      unsigned int _m_cq_mask;
+      io_uring_cqe* _m_cqes;
+
+      std::vector<bool> _m_supported;
+
+      bool _m_buffer_registered;
+      const char* _m_registered_address;
+      std::size_t _m_registered_size;
+
+      io_uring_buf_ring* _m_group_ring;
+      char* _m_group_memory;
+      unsigned int _m_group_count;
+      std::size_t _m_group_buffer_size;
+      unsigned short _m_group_tail;
+      unsigned short _m_group;
+
+}; // end of class(uring)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __URING_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of uring.hpp
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,325 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: writer.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Userspace write coalescing for an ev9::socket. Small writes are copied
+// into one buffer and go to the kernel together, so a stream of tiny
+// messages pays for a syscall per buffer instead of per message. The
+// buffer is sent when it reaches the size threshold, when its oldest byte
+// has waited longer than the delay threshold, or on flush(). A write that
+// does not fit goes out in the same writev as the buffered bytes.
+//
+// There is no timer thread: the delay is checked on every write and by
+// flush_if_due(), which an idle caller (an event loop tick, say) should
+// call so the last message of a burst is not held forever.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __WRITER_HPP__
+#define __WRITER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "framing.hpp"
+#include "socket.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class buffered_writer
+{
+   public:  // Type definitions
+
+      typedef std::chrono::steady_clock clock;
+
+      class policy
+      {
+         public:  // Constructor
+
+            policy() : threshold(64 * 1024), max_delay(0) { }
+
+         public:  // Member Variables
+
+            // Bytes buffered before a send; also the buffer's capacity
+            std::size_t threshold;
+
+            // Seconds the oldest buffered byte may wait, 0 for no limit
+            double max_delay;
+
+      }; // end of class(policy)
+
+   public:  // Constructor | Destructor
+
+      buffered_writer(socket& connection, frame_side side = side_connected) { _ctor(connection, side, policy()); }
+      buffered_writer(socket& connection, frame_side side, const policy& flush_policy) { _ctor(connection, side, flush_policy); }
+
+      // Sends whatever is still buffered; errors are dropped here, call
+      // flush() first to see them
+      ~buffered_writer() { _dtor(); }
+
+   private: // Holds a reference to the socket, not copyable
+
+      buffered_writer(const buffered_writer&);
+      buffered_writer& operator=(const buffered_writer&);
+
+   public:  // Public Member Functions
+
+      void write(const char* const buffer, std::size_t size) { _write(buffer, size, nullptr); }
+      void write(const std::string& message) { _write(message.data(), message.size(), nullptr); }
+
+      // One length-prefixed frame (see framing.hpp)
+      void write_frame(const char* const payload, std::size_t size) { _write_frame(payload, size); }
+
+      void flush() { _flush(nullptr, 0); }
+      bool flush_if_due() { return _flush_if_due(clock::now()); }
+
+      std::size_t buffered() const { return _m_used; }
+      const policy& get_policy() const { return _m_policy; }
+
+      // Calls to write() or write_frame(), the write or writev calls that
+      // carried them, and the bytes sent
+      std::size_t writes() const { return _m_writes; }
+      std::size_t syscalls() const { return _m_syscalls; }
+      std::size_t bytes() const { return _m_bytes; }
+      double writes_per_syscall() const { return _m_syscalls > 0 ? (double)_m_writes / _m_syscalls : 0; }
+
+   private: // Private Member Functions
+
+      void _ctor(socket& connection, frame_side side, const policy& flush_policy)
+      {
+         if (flush_policy.threshold == 0)
+         {
+            throw std::runtime_error("Write coalescing threshold must be greater than zero");
+         }
+
+         if (flush_policy.max_delay < 0)
+         {
+            throw std::runtime_error("Write coalescing delay cannot be negative");
+         }
+
+         _m_socket = &connection;
+         _m_side = side;
+         _m_policy = flush_policy;
+
+         _m_max_delay = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(flush_policy.max_delay));
+
+         _m_buffer.resize(flush_policy.threshold);
+         _m_used = 0;
+
+         _m_writes = 0;
+         _m_syscalls = 0;
+         _m_bytes = 0;
+      }
+
+      void _dtor()
+      {
+         try
+         {
+            _flush(nullptr, 0);
+         }
+
+         catch (std::exception&)
+         {
+         }
+      }
+
+      void _write(const char* const buffer, std::size_t size, const char* const header)
+      {
+         ++_m_writes;
+
+         std::size_t header_size = header != nullptr ? frame_header_size : 0;
+
+         if (_m_used + header_size + size > _m_buffer.size())
+         {
+            // Too big to buffer: the buffered bytes lead the same send
+            if (header != nullptr)
+            {
+               _append(header, header_size);
+            }
+
+            _flush(buffer, size);
+
+            return;
+         }
+
+         if (header != nullptr)
+         {
+            _append(header, header_size);
+         }
+
+         _append(buffer, size);
+
+         if (_m_used == _m_buffer.size())
+         {
+            _flush(nullptr, 0);
+         }
+
+         else if (_m_max_delay != clock::duration::zero())
+         {
+            _flush_if_due(clock::now());
+         }
+      }
+
+      void _write_frame(const char* const payload, std::size_t size)
+      {
+         if (size > 0xFFFFFFFFULL)
+         {
+            throw std::runtime_error("Frame payload does not fit a 32 bit length");
+         }
+
+         char header[frame_header_size];
+
+         encode_frame_header(header, (std::uint32_t)size);
+
+         if (_m_used + frame_header_size > _m_buffer.size())
+         {
+            // No room even for the prefix; start from an empty buffer
+            _flush(nullptr, 0);
+         }
+
+         _write(payload, size, header);
+      }
+
+      void _append(const char* const buffer, std::size_t size)
+      {
+         if (size == 0)
+         {
+            return;
+         }
+
+         // Only the delay threshold needs the clock
+         if (_m_used == 0 && _m_max_delay != clock::duration::zero())
+         {
+            _m_oldest = clock::now();
+         }
+
+         std::memcpy(&_m_buffer[_m_used], buffer, size);
+
+         _m_used += size;
+      }
+
+      bool _flush_if_due(clock::time_point now)
+      {
+         if (_m_used == 0 || _m_max_delay == clock::duration::zero() || now - _m_oldest < _m_max_delay)
+         {
+            return false;
+         }
+
+         _flush(nullptr, 0);
+
+         return true;
+      }
+
+      // Sends the buffer followed by an optional payload that was not
+      // copied into it
+      void _flush(const char* const extra, std::size_t extra_size)
+      {
+         if (_m_used == 0 && extra_size == 0)
+         {
+            return;
+         }
+
+         #if _WIN32
+            _send(_m_buffer.data(), _m_used);
+            _send(extra, extra_size);
+         #else
+            socket::segment segments[2];
+
+            std::size_t count = 0;
+
+            if (_m_used > 0)
+            {
+               segments[count].iov_base = &_m_buffer[0];
+               segments[count].iov_len = _m_used;
+
+               ++count;
+            }
+
+            if (extra_size > 0)
+            {
+               segments[count].iov_base = (void*)extra;
+               segments[count].iov_len = extra_size;
+
+               ++count;
+            }
+
+            std::size_t calls = _m_socket->vector_calls();
+
+            std::size_t amount = _m_side == side_connected ? _m_socket->write(segments, count) : _m_socket->write_back(segments, count);
+
+            _m_syscalls += _m_socket->vector_calls() - calls;
+            _m_bytes += amount;
+         #endif
+
+         _m_used = 0;
+      }
+
+      #if _WIN32
+         void _send(const char* const buffer, std::size_t size)
+         {
+            for (std::size_t offset = 0; offset < size; ++_m_syscalls)
+            {
+               offset += _m_side == side_connected ? _m_socket->write(buffer + offset, size - offset) : _m_socket->write_back(buffer + offset, size - offset);
+            }
+
+            _m_bytes += size;
+         }
+      #endif
+
+   private: // Member Variables
+
+      socket* _m_socket;
+      frame_side _m_side;
+
+      policy _m_policy;
+      clock::duration _m_max_delay;
+
+      std::vector<char> _m_buffer;
+      std::size_t _m_used;
+
+      // When the first byte now in the buffer was written
+      clock::time_point _m_oldest;
+
+      std::size_t _m_writes;
+      std::size_t _m_syscalls;
+      std::size_t _m_bytes;
+
+}; // end of class(buffered_writer)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __WRITER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
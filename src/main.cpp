@@ -8,26 +8,1391 @@
 // Time-period:
 //
 // 10-December-14: Version 1.0: Created
-// 10-December-14: Version 1.0: Last Updated
+// 17-October-26: Version 1.1: Last Updated
 //
 // Notes:
 //
+// bandwidth_test [-s | -c host] [-p port] [-l payload] [-t seconds]
+//                [-n bytes] [-i interval] [-m copy|sendfile|zerocopy]
+//                [-F file] [-Z] [-P streams] [-S] [-L] [-N iterations]
+//                [-B classic|uring|both] [-u] [-b rate] [-G]
+//                [-o option=value ...] [-A throughput|latency]
+//                [-W workers] [-a compact|scatter|node]
+//                [-T tcp|unix|unix-datagram|shm|all] [-M] [-V]
+//                [-H] [-K] [-R runs]
+//
+//    -s    receive from senders until killed
+//    -c    run the sending side against host
+//    -m    how the sender hands data to the kernel
+//    -F    file to sendfile from (a memfd of the payload by default)
+//    -Z    run every send mode in turn and compare cycles per byte
+//    -P    parallel streams, each on its own thread and port (port + i)
+//    -S    sweep 1, 2, 4 ... up to -P streams and tabulate the scaling
+//    -L    ping-pong latency instead of throughput (-l is the message size,
+//          64 bytes by default; -N fixes the round trips instead of -t)
+//    -B    socket backend; both runs classic then io_uring and compares
+//    -u    UDP instead of TCP: packets per second, loss, reordering and
+//          jitter (-l is the packet size, 1472 bytes by default)
+//    -b    UDP send rate in bits per second, with an optional K, M or G
+//    -G    UDP segmentation/receive offload (GSO on the sender, GRO on the
+//          receiver)
+//    -o    socket option, repeatable: sndbuf=bytes, rcvbuf=bytes (K or M
+//          suffix), nodelay=0|1, cork=0|1, quickack=0|1, busypoll=us,
+//          cc=algorithm
+//    -W    with -s: serve on n worker threads, each with its own
+//          SO_REUSEPORT listener on the same port and pinned to a core.
+//          Each worker serves one connection at a time, so up to n senders
+//          run at once; the kernel may queue one behind another on a busy
+//          worker even when some are idle, and its time counts from accept
+//    -a    pin stream threads and put their payloads on the local NUMA
+//          node: compact fills a core then its neighbours, scatter spreads
+//          over nodes and cores, node gives stream i all of node i % n.
+//          Implies the parallel path even for one stream; the placement and
+//          each stream's CPU and buffer node are printed with the results.
+//    -T    transport for the copy mode and -L on this host: TCP, AF_UNIX
+//          stream or seqpacket, or a shared memory ring pair (Linux); all
+//          runs each over loopback in turn and compares them
+//    -V    frame the copy stream into -l byte chunks, each with a sequence
+//          number and a CRC32C the receiver checks as the data arrives;
+//          give it to both sides
+//    -H    take every payload from one pool of 2 MiB aligned, huge page
+//          backed buffers that are faulted in once and reused by each
+//          stream, trial and comparison run; the page faults of the whole
+//          process and what the pool mapped are printed at the end
+//    -K    -H with the pool's memory mlocked as well
+//    -R    send that many runs back to back over one warm connection from
+//          a connection pool, so short probes pay for one handshake between
+//          them; runs are framed in band, so -s needs -R as well (any count)
+//    -M    memory bandwidth baseline instead: read, write, copy and triad
+//          with every SIMD kernel the CPU has, over working sets from L1
+//          to DRAM on one thread, then over 1 thread to all of them
+//    -A    auto-tune: sweep the payload size and the -o options one at a
+//          time, keeping the best value of each, for the highest
+//          throughput or the lowest median round trip. -t is per trial and
+//          defaults to 1 second; against -c host only the sending side is
+//          tuned.
+//
+// With neither -s nor -c both sides run in this process over loopback.
+//
 // Requirements: POSIX sockets
 //
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-//#include "socket.hpp"
-#include "test.hpp"
+#include "bandwidth.hpp"
+#include "buffer_pool.hpp"
+#include "latency.hpp"
+#include "memory.hpp"
+#include "parallel.hpp"
+#include "udp.hpp"
+
+#if __linux__
+   #include "server.hpp"
+#endif
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct options
+{
+   std::string host;
+   std::string send_file;
+
+   bool server;
+   bool compare_modes;
+   bool sweep_streams;
+   bool latency;
+   bool compare_backends;
+   bool udp;
+   bool offload;
+   bool memory;
+   bool verify;
+
+   std::size_t port;
+   std::size_t payload;
+   std::size_t byte_count;
+   std::size_t streams;
+   std::size_t iterations;
+   std::size_t workers;
+
+   // Framed runs over one pooled connection with -R, 0 otherwise
+   std::size_t runs;
+
+   double duration;
+   double interval;
+   double rate;
+
+   ev9::bandwidth::send_mode mode;
+   ev9::bandwidth::backend backend;
+
+   ev9::socket::options socket_options;
+
+   ev9::placement placement;
+
+   ev9::transport_kind transport;
+   bool compare_transports;
+
+   // Shared by every stream object with -H, null otherwise
+   ev9::buffer_pool* pool;
+
+   // 0 off, otherwise tune_throughput or tune_latency
+   int tune;
+};
+
+enum tune_target
+{
+   tune_throughput = 1,
+   tune_latency
+};
+
+// The receiving side of a run in this process. If the sending side throws,
+// the destructor runs stop, which has to unblock the thread, and joins, so
+// the error unwinds past no joinable thread; join() rethrows what the
+// thread itself threw.
+class peer_thread
+{
+   public:  // Constructor | Destructor
+
+      peer_thread(const std::function<void()>& function, const std::function<void()>& stop) : _m_stop(stop), _m_thread(&peer_thread::_body, this, function) { }
+
+      ~peer_thread()
+      {
+         if (_m_thread.joinable())
+         {
+            _m_stop();
+            _m_thread.join();
+         }
+      }
+
+   private: // Owns a running thread, not copyable
+
+      peer_thread(const peer_thread&);
+      peer_thread& operator=(const peer_thread&);
+
+   public:  // Public Member Functions
+
+      void join()
+      {
+         _m_thread.join();
+
+         if (_m_failure) std::rethrow_exception(_m_failure);
+      }
+
+   private: // Private Member Functions
+
+      void _body(std::function<void()> function)
+      {
+         try
+         {
+            function();
+         }
+
+         catch (...)
+         {
+            _m_failure = std::current_exception();
+         }
+      }
+
+   private: // Member Variables
+
+      std::function<void()> _m_stop;
+
+      // Before the thread, which may set it as soon as it starts
+      std::exception_ptr _m_failure;
+
+      std::thread _m_thread;
+
+}; // end of class(peer_thread)
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-/*int main()
+void usage()
+{
+   std::printf("usage: bandwidth_test [-s | -c host] [-p port] [-l payload bytes]\n"
+               "                      [-t seconds] [-n bytes] [-i interval seconds]\n"
+               "                      [-m copy|sendfile|zerocopy] [-F file] [-Z]\n"
+               "                      [-P streams] [-S] [-L] [-N iterations]\n"
+               "                      [-B classic|uring|both] [-u] [-b rate] [-G]\n"
+               "                      [-o option=value ...] [-A throughput|latency]\n"
+               "                      [-W workers] [-a compact|scatter|node]\n"
+               "                      [-T tcp|unix|unix-datagram|shm|all] [-M] [-V]\n"
+               "                      [-H] [-K] [-R runs]\n");
+}
+
+bool parse_mode(const std::string& name, ev9::bandwidth::send_mode& mode)
+{
+   if (name == "copy") mode = ev9::bandwidth::mode_copy;
+   else if (name == "sendfile") mode = ev9::bandwidth::mode_sendfile;
+   else if (name == "zerocopy") mode = ev9::bandwidth::mode_zerocopy;
+   else return false;
+
+   return true;
+}
+
+bool readable(const std::string& path)
+{
+   std::FILE* file = std::fopen(path.c_str(), "rb");
+
+   if (file == nullptr)
+   {
+      return false;
+   }
+
+   std::fclose(file);
+
+   return true;
+}
+
+// The placement line that goes with results over this many streams
+std::string describe_placement(const options& opts, std::size_t streams)
+{
+   ev9::topology layout;
+
+   return layout.describe(opts.placement, layout.place(opts.placement, streams));
+}
+
+bool parse_transport(const std::string& name, options& opts)
+{
+   if (name == "all") opts.compare_transports = true;
+   else if (!ev9::parse_transport_kind(name, opts.transport)) return false;
+
+   return true;
+}
+
+bool parse_backend(const std::string& name, options& opts)
+{
+   if (name == "classic") opts.backend = ev9::bandwidth::backend_classic;
+   else if (name == "uring") opts.backend = ev9::bandwidth::backend_uring;
+   else if (name == "both") opts.compare_backends = true;
+   else return false;
+
+   return true;
+}
+
+double parse_rate(const std::string& text)
+{
+   char* suffix = nullptr;
+
+   double rate = std::strtod(text.c_str(), &suffix);
+
+   switch (suffix != nullptr ? *suffix : 0)
+   {
+      case 'k': case 'K': return rate * 1e3;
+      case 'm': case 'M': return rate * 1e6;
+      case 'g': case 'G': return rate * 1e9;
+      default: return rate;
+   }
+}
+
+std::size_t parse_size(const std::string& text)
+{
+   char* suffix = nullptr;
+
+   std::size_t size = std::strtoul(text.c_str(), &suffix, 10);
+
+   switch (suffix != nullptr ? *suffix : 0)
+   {
+      case 'k': case 'K': return size * 1024;
+      case 'm': case 'M': return size * 1024 * 1024;
+      default: return size;
+   }
+}
+
+bool parse_socket_option(const std::string& text, ev9::socket::options& socket_options)
+{
+   std::size_t separator = text.find('=');
+
+   if (separator == std::string::npos)
+   {
+      return false;
+   }
+
+   std::string name = text.substr(0, separator);
+   std::string value = text.substr(separator + 1);
+
+   if (name == "sndbuf") socket_options.send_buffer = parse_size(value);
+   else if (name == "rcvbuf") socket_options.receive_buffer = parse_size(value);
+   else if (name == "nodelay") socket_options.no_delay = value == "1" ? 1 : 0;
+   else if (name == "cork") socket_options.cork = value == "1";
+   else if (name == "quickack") socket_options.quick_ack = value == "1";
+   else if (name == "busypoll") socket_options.busy_poll = (unsigned int)std::strtoul(value.c_str(), nullptr, 10);
+   else if (name == "cc") socket_options.congestion = value;
+   else return false;
+
+   return true;
+}
+
+bool parse_tune(const std::string& name, options& opts)
+{
+   if (name == "throughput") opts.tune = tune_throughput;
+   else if (name == "latency") opts.tune = tune_latency;
+   else return false;
+
+   return true;
+}
+
+void configure_sender(ev9::bandwidth& sender, const options& opts, ev9::bandwidth::send_mode mode)
+{
+   sender.set_backend(opts.backend);
+   sender.set_duration(opts.duration);
+   sender.set_byte_count(opts.byte_count);
+   sender.set_interval(opts.interval);
+   sender.set_send_mode(mode);
+   sender.set_socket_options(opts.socket_options);
+   sender.set_transport(opts.transport);
+   sender.set_verify(opts.verify);
+   sender.set_buffer_pool(opts.pool);
+
+   if (!opts.send_file.empty()) sender.set_send_file(opts.send_file);
+}
+
+ev9::bandwidth::result run_sender(const options& opts, ev9::bandwidth::send_mode mode)
+{
+   ev9::bandwidth sender(opts.port, opts.payload);
+
+   configure_sender(sender, opts, mode);
+
+   return sender.send(opts.host);
+}
+
+ev9::bandwidth::result run_loopback(const options& opts, ev9::bandwidth::send_mode mode, ev9::bandwidth::result& received)
+{
+   ev9::bandwidth receiver(opts.port, opts.payload);
+   ev9::bandwidth sender(opts.port, opts.payload);
+
+   receiver.set_interval(opts.interval);
+   receiver.set_backend(opts.backend);
+   receiver.set_socket_options(opts.socket_options);
+   receiver.set_transport(opts.transport);
+   receiver.set_verify(opts.verify);
+   receiver.set_buffer_pool(opts.pool);
+
+   configure_sender(sender, opts, mode);
+
+   receiver.listen();
+
+   peer_thread receiving_thread([&]() { received = receiver.receive(); }, [&]() { receiver.interrupt(); });
+
+   ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+   receiving_thread.join();
+
+   return sent;
+}
+
+// -R: one sender streams every run over the connection it leases, and
+// the pool shows how many handshakes that took
+void repeat_runs(const options& opts)
+{
+   ev9::connection_pool connections(1);
+
+   connections.set_socket_options(opts.socket_options);
+
+   ev9::bandwidth sender(opts.port, opts.payload);
+
+   configure_sender(sender, opts, opts.mode);
+
+   sender.set_connection_pool(&connections);
+
+   std::vector<ev9::bandwidth::result> sent;
+   std::vector<ev9::bandwidth::result> received(opts.runs);
+
+   if (!opts.host.empty())
+   {
+      for (std::size_t run = 0; run < opts.runs; ++run) sent.push_back(sender.send(opts.host));
+   }
+
+   else
+   {
+      ev9::bandwidth receiver(opts.port, opts.payload);
+
+      receiver.set_interval(opts.interval);
+      receiver.set_socket_options(opts.socket_options);
+      receiver.set_verify(opts.verify);
+      receiver.set_buffer_pool(opts.pool);
+      receiver.set_framed_runs(true);
+      receiver.listen();
+
+      peer_thread receiving_thread([&]()
+      {
+         for (std::size_t run = 0; run < opts.runs; ++run) received[run] = receiver.receive();
+      },
+      [&]() { receiver.interrupt(); });
+
+      for (std::size_t run = 0; run < opts.runs; ++run) sent.push_back(sender.send("127.0.0.1"));
+
+      receiving_thread.join();
+   }
+
+   for (std::size_t run = 0; run < opts.runs; ++run)
+   {
+      std::string label = "run " + std::to_string(run + 1);
+
+      ev9::bandwidth::print((label + " sender").c_str(), sent[run]);
+
+      if (opts.host.empty()) ev9::bandwidth::print((label + " receiver").c_str(), received[run]);
+   }
+
+   std::printf("[connections] %lu runs, %lu handshakes, %lu served warm\n", (unsigned long)opts.runs, (unsigned long)connections.misses(), (unsigned long)connections.hits());
+}
+
+ev9::parallel_bandwidth::results run_parallel(const options& opts, std::size_t streams)
+{
+   ev9::parallel_bandwidth sender(opts.port, streams, opts.payload);
+
+   sender.set_duration(opts.duration);
+   sender.set_byte_count(opts.byte_count);
+   sender.set_interval(opts.interval);
+   sender.set_send_mode(opts.mode);
+   sender.set_backend(opts.backend);
+   sender.set_socket_options(opts.socket_options);
+   sender.set_placement(opts.placement);
+   sender.set_transport(opts.transport);
+   sender.set_verify(opts.verify);
+   sender.set_buffer_pool(opts.pool);
+
+   if (!opts.send_file.empty()) sender.set_send_file(opts.send_file);
+
+   if (!opts.host.empty())
+   {
+      return sender.send(opts.host);
+   }
+
+   ev9::parallel_bandwidth receiver(opts.port, streams, opts.payload);
+
+   ev9::parallel_bandwidth::results received;
+
+   receiver.set_interval(opts.interval);
+   receiver.set_backend(opts.backend);
+   receiver.set_socket_options(opts.socket_options);
+   receiver.set_placement(opts.placement);
+   receiver.set_transport(opts.transport);
+   receiver.set_verify(opts.verify);
+   receiver.set_buffer_pool(opts.pool);
+   receiver.listen();
+
+   peer_thread receiving_thread([&]() { received = receiver.receive(); }, [&]() { receiver.interrupt(); });
+
+   ev9::parallel_bandwidth::results sent = sender.send("127.0.0.1");
+
+   receiving_thread.join();
+
+   return sent;
+}
+
+void sweep_streams(const options& opts)
+{
+   std::vector<std::size_t> counts;
+
+   for (std::size_t streams = 1; streams < opts.streams; streams *= 2) counts.push_back(streams);
+
+   counts.push_back(opts.streams);
+
+   std::vector<ev9::parallel_bandwidth::results> results;
+
+   for (std::size_t streams : counts)
+   {
+      results.push_back(run_parallel(opts, streams));
+   }
+
+   std::printf("%8s %12s %14s %10s\n", "streams", "Gbit/s", "Gbit/s/stream", "fairness");
+
+   for (std::size_t index = 0; index < counts.size(); ++index)
+   {
+      double total = ev9::parallel_bandwidth::aggregate(results[index]).gbits();
+
+      std::printf("%8lu %12.3f %14.3f %10.4f\n", (unsigned long)counts[index], total, total / counts[index], ev9::parallel_bandwidth::fairness(results[index]));
+   }
+
+   std::printf("%u hardware threads, placement %s\n", std::thread::hardware_concurrency(), describe_placement(opts, opts.streams).c_str());
+}
+
+void compare_modes(const options& opts)
+{
+   const ev9::bandwidth::send_mode modes[] = { ev9::bandwidth::mode_copy, ev9::bandwidth::mode_sendfile, ev9::bandwidth::mode_zerocopy };
+
+   std::vector<ev9::bandwidth::result> results;
+
+   for (ev9::bandwidth::send_mode mode : modes)
+   {
+      ev9::bandwidth::result received;
+
+      if (opts.host.empty()) results.push_back(run_loopback(opts, mode, received));
+      else results.push_back(run_sender(opts, mode));
+   }
+
+   std::printf("%10s %12s %14s %14s %12s\n", "mode", "Gbit/s", "cycles/byte", "cpu ns/byte", "copied");
+
+   for (std::size_t index = 0; index < results.size(); ++index)
+   {
+      const ev9::bandwidth::result& res = results[index];
+
+      std::printf("%10s %12.3f %14.3f %14.3f %12lu\n",
+                  ev9::bandwidth::mode_name(modes[index]),
+                  res.gbits(),
+                  res.cycles_per_byte(),
+                  res.bytes ? res.cpu_seconds * 1e9 / res.bytes : 0,
+                  (unsigned long)res.zerocopy_copied);
+   }
+
+   if (opts.host.empty())
+   {
+      std::printf("note: loopback delivery copies MSG_ZEROCOPY pages, run against a remote receiver for real numbers\n");
+   }
+}
+
+void compare_backends(const options& opts)
+{
+   const ev9::bandwidth::backend backends[] = { ev9::bandwidth::backend_classic, ev9::bandwidth::backend_uring };
+
+   std::vector<ev9::bandwidth::result> sent;
+   std::vector<ev9::bandwidth::result> received;
+
+   for (ev9::bandwidth::backend kind : backends)
+   {
+      options run = opts;
+
+      run.backend = kind;
+
+      received.push_back(ev9::bandwidth::result());
+
+      if (opts.host.empty()) sent.push_back(run_loopback(run, opts.mode, received.back()));
+      else sent.push_back(run_sender(run, opts.mode));
+   }
+
+   std::printf("%10s %12s %16s %14s %16s\n", "backend", "Gbit/s", "sender B/call", "cycles/byte", "receiver B/call");
+
+   for (std::size_t index = 0; index < sent.size(); ++index)
+   {
+      // A fallback shows up as classic on both rows
+      std::printf("%10s %12.3f %16.0f %14.3f %16.0f\n",
+                  ev9::bandwidth::backend_name(sent[index].uring ? ev9::bandwidth::backend_uring : ev9::bandwidth::backend_classic),
+                  sent[index].gbits(),
+                  sent[index].bytes_per_syscall(),
+                  sent[index].cycles_per_byte(),
+                  received[index].bytes_per_syscall());
+   }
+}
+
+void run_memory()
+{
+   ev9::memory_bandwidth suite;
+
+   suite.print(suite.size_sweep(1));
+
+   std::printf("\n");
+
+   suite.print(suite.thread_sweep(suite.sizes().back()));
+}
+
+void compare_transports(const options& opts)
+{
+   const ev9::transport_kind kinds[] = { ev9::transport_tcp, ev9::transport_unix, ev9::transport_unix_datagram, ev9::transport_shm };
+
+   if (opts.latency) std::printf("%14s %12s %12s %12s %12s\n", "transport", "mean us", "p50 us", "p99 us", "p99.9 us");
+   else std::printf("%14s %12s %16s %14s %16s\n", "transport", "Gbit/s", "sender B/call", "cycles/byte", "receiver B/call");
+
+   for (ev9::transport_kind kind : kinds)
+   {
+      options run = opts;
+
+      run.transport = kind;
+
+      if (opts.latency)
+      {
+         ev9::latency server(run.port);
+         ev9::latency client(run.port, run.payload);
+
+         server.set_socket_options(run.socket_options);
+         server.set_transport(kind);
+         server.listen();
+
+         client.set_duration(run.duration);
+         client.set_iterations(run.iterations);
+         client.set_socket_options(run.socket_options);
+         client.set_transport(kind);
+
+         peer_thread serving_thread([&]() { server.serve(); }, [&]() { server.interrupt(); });
+
+         const ev9::histogram& samples = client.ping("127.0.0.1");
+
+         serving_thread.join();
+
+         std::printf("%14s %12.2f %12.2f %12.2f %12.2f\n",
+                     ev9::transport_kind_name(kind),
+                     samples.mean() / 1e3,
+                     samples.percentile(50) / 1e3,
+                     samples.percentile(99) / 1e3,
+                     samples.percentile(99.9) / 1e3);
+      }
+
+      else
+      {
+         ev9::bandwidth::result received;
+
+         ev9::bandwidth::result sent = run_loopback(run, run.mode, received);
+
+         // shm moves bytes through the ring, so its calls are ring calls
+         std::printf("%14s %12.3f %16.0f %14.3f %16.0f\n",
+                     ev9::transport_kind_name(kind),
+                     sent.gbits(),
+                     sent.bytes_per_syscall(),
+                     sent.cycles_per_byte(),
+                     received.bytes_per_syscall());
+      }
+   }
+}
+
+void configure_udp(ev9::udp_bandwidth& side, const options& opts)
 {
-   
+   side.set_duration(opts.duration);
+   side.set_byte_count(opts.byte_count);
+   side.set_rate(opts.rate);
+   side.set_offload(opts.offload);
+}
+
+void run_udp(const options& opts)
+{
+   ev9::udp_bandwidth sender(opts.port, opts.payload);
+
+   configure_udp(sender, opts);
+
+   if (!opts.host.empty())
+   {
+      ev9::udp_bandwidth::print("sender", sender.send(opts.host));
+
+      return;
+   }
+
+   ev9::udp_bandwidth receiver(opts.port);
+
+   ev9::udp_bandwidth::result received;
+
+   configure_udp(receiver, opts);
+
+   receiver.listen();
+
+   peer_thread receiving_thread([&]() { received = receiver.receive(); }, [&]() { receiver.interrupt(); });
+
+   ev9::udp_bandwidth::result sent = sender.send("127.0.0.1");
+
+   receiving_thread.join();
+
+   ev9::udp_bandwidth::print("sender", sent);
+   ev9::udp_bandwidth::print("receiver", received);
+}
+
+void serve_udp(const options& opts)
+{
+   ev9::udp_bandwidth receiver(opts.port);
+
+   configure_udp(receiver, opts);
+
+   receiver.listen();
+
+   while (true)
+   {
+      ev9::udp_bandwidth::print("receiver", receiver.receive());
+   }
+}
+
+void run_latency(const options& opts)
+{
+   ev9::latency client(opts.port, opts.payload);
+
+   client.set_duration(opts.duration);
+   client.set_iterations(opts.iterations);
+   client.set_socket_options(opts.socket_options);
+   client.set_transport(opts.transport);
+
+   if (!opts.host.empty())
+   {
+      ev9::latency::print("latency", opts.payload, client.ping(opts.host));
+
+      return;
+   }
+
+   ev9::latency server(opts.port);
+
+   server.set_socket_options(opts.socket_options);
+   server.set_transport(opts.transport);
+   server.listen();
+
+   peer_thread serving_thread([&]() { server.serve(); }, [&]() { server.interrupt(); });
+
+   ev9::latency::print("latency", opts.payload, client.ping("127.0.0.1"));
+
+   serving_thread.join();
+}
+
+void serve_latency(const options& opts)
+{
+   ev9::latency server(opts.port);
+
+   server.set_socket_options(opts.socket_options);
+   server.set_transport(opts.transport);
+   server.listen();
+
+   while (true)
+   {
+      std::size_t round_trips = server.serve();
+
+      std::printf("[latency server] echoed %lu round trips\n", (unsigned long)round_trips);
+   }
+}
+
+const char* const tune_knobs[] = { "payload", "sndbuf", "rcvbuf", "nodelay", "cork", "quickack", "busypoll", "cc" };
+
+const std::size_t tune_knob_count = sizeof(tune_knobs) / sizeof(tune_knobs[0]);
+
+// How one knob of opts is written on the command line
+std::string tune_label(std::size_t knob, const options& opts)
+{
+   const ev9::socket::options& socket_options = opts.socket_options;
+
+   switch (knob)
+   {
+      case 0: return "-l " + std::to_string(opts.payload);
+      case 1: return "sndbuf=" + (socket_options.send_buffer ? std::to_string(socket_options.send_buffer) : std::string("default"));
+      case 2: return "rcvbuf=" + (socket_options.receive_buffer ? std::to_string(socket_options.receive_buffer) : std::string("default"));
+      case 3: return socket_options.no_delay < 0 ? std::string("nodelay=default") : socket_options.no_delay ? "nodelay=1" : "nodelay=0";
+      case 4: return socket_options.cork ? "cork=1" : "cork=0";
+      case 5: return socket_options.quick_ack ? "quickack=1" : "quickack=0";
+      case 6: return "busypoll=" + std::to_string(socket_options.busy_poll);
+      default: return "cc=" + (socket_options.congestion.empty() ? std::string("default") : socket_options.congestion);
+   }
+}
+
+// Every value the sweep tries for one knob, the rest taken from best
+std::vector<options> tune_values(std::size_t knob, const options& best)
+{
+   const std::size_t payloads[] = { 16 * 1024, 64 * 1024, 128 * 1024, 256 * 1024, 1024 * 1024 };
+   const std::size_t buffers[] = { 0, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+
+   std::vector<options> values;
+
+   options candidate = best;
+
+   switch (knob)
+   {
+      case 0:
+         for (std::size_t payload : payloads) { candidate.payload = payload; values.push_back(candidate); }
+         break;
+
+      case 1:
+         for (std::size_t buffer : buffers) { candidate.socket_options.send_buffer = buffer; values.push_back(candidate); }
+         break;
+
+      case 2:
+         for (std::size_t buffer : buffers) { candidate.socket_options.receive_buffer = buffer; values.push_back(candidate); }
+         break;
+
+      case 3: case 4: case 5:
+         for (int flag = 0; flag < 2; ++flag)
+         {
+            if (knob == 3) candidate.socket_options.no_delay = flag;
+            if (knob == 4) candidate.socket_options.cork = flag != 0;
+            if (knob == 5) candidate.socket_options.quick_ack = flag != 0;
+
+            values.push_back(candidate);
+         }
+         break;
+
+      case 6:
+         for (unsigned int microseconds : { 0u, 50u }) { candidate.socket_options.busy_poll = microseconds; values.push_back(candidate); }
+         break;
+
+      default:
+         for (const std::string& name : ev9::socket::congestion_controls()) { candidate.socket_options.congestion = name; values.push_back(candidate); }
+         break;
+   }
+
+   return values;
+}
+
+// Whether the kernel takes the options, so a trial cannot fail half way
+// with the other side waiting on it
+bool tune_supported(const ev9::socket::options& socket_options)
+{
+   try
+   {
+      ev9::socket probe((std::size_t)0);
+
+      probe.set_options(socket_options);
+
+      return true;
+   }
+
+   catch (std::exception&)
+   {
+      return false;
+   }
+}
+
+// Median round trip in microseconds, or Gbit/s at the receiver (at the
+// sender against a remote host)
+double tune_trial(const options& opts)
+{
+   if (opts.tune == tune_latency)
+   {
+      ev9::latency client(opts.port, opts.payload);
+
+      client.set_duration(opts.duration);
+      client.set_warmup(100);
+      client.set_socket_options(opts.socket_options);
+
+      if (!opts.host.empty())
+      {
+         return client.ping(opts.host).percentile(50) / 1e3;
+      }
+
+      ev9::latency server(opts.port);
+
+      server.set_socket_options(opts.socket_options);
+      server.listen();
+
+      peer_thread serving_thread([&]() { server.serve(); }, [&]() { server.interrupt(); });
+
+      double median = client.ping("127.0.0.1").percentile(50) / 1e3;
+
+      serving_thread.join();
+
+      return median;
+   }
+
+   if (!opts.host.empty())
+   {
+      return run_sender(opts, opts.mode).gbits();
+   }
+
+   ev9::bandwidth::result received;
+
+   run_loopback(opts, opts.mode, received);
+
+   return received.gbits();
+}
+
+void auto_tune(const options& opts)
+{
+   bool latency = opts.tune == tune_latency;
+
+   const char* unit = latency ? "p50 us" : "Gbit/s";
+
+   options best = opts;
+
+   double best_score = tune_trial(best);
+
+   std::printf("%10s %-28s %12s\n", "knob", "value", unit);
+   std::printf("%10s %-28s %12.3f\n", "baseline", "", best_score);
+
+   for (std::size_t knob = 0; knob < tune_knob_count; ++knob)
+   {
+      // The message size is the workload being measured, not a knob, and
+      // a cork holds every message back for up to 200 ms
+      if (latency && (knob == 0 || knob == 4)) continue;
+
+      std::string current = tune_label(knob, best);
+
+      for (const options& candidate : tune_values(knob, best))
+      {
+         std::string label = tune_label(knob, candidate);
+
+         if (label == current) continue;
+
+         if (!tune_supported(candidate.socket_options))
+         {
+            std::printf("%10s %-28s %12s\n", tune_knobs[knob], label.c_str(), "unsupported");
+
+            continue;
+         }
+
+         double score = tune_trial(candidate);
+
+         bool better = latency ? score < best_score : score > best_score;
+
+         std::printf("%10s %-28s %12.3f%s\n", tune_knobs[knob], label.c_str(), score, better ? "  *" : "");
+
+         if (better)
+         {
+            best = candidate;
+            best_score = score;
+            current = label;
+         }
+      }
+   }
+
+   std::string arguments = latency ? "-L" : tune_label(0, best);
+
+   for (std::size_t knob = 1; knob < tune_knob_count; ++knob)
+   {
+      if (tune_label(knob, best) != tune_label(knob, opts)) arguments += " -o " + tune_label(knob, best);
+   }
+
+   std::printf("best: %.3f %s with %s\n", best_score, unit, arguments.c_str());
+}
+
+void serve(const options& opts)
+{
+   std::vector<ev9::bandwidth*> receivers;
+   std::vector<std::thread> threads;
+
+   ev9::topology layout;
+
+   ev9::topology::plan plan = layout.place(opts.placement, opts.streams);
+
+   if (opts.placement != ev9::placement_none)
+   {
+      std::printf("placement %s\n", layout.describe(opts.placement, plan).c_str());
+   }
+
+   // Ports are served independently so a sender can use any number of
+   // streams up to -P, which is what a -S sweep needs.
+   for (std::size_t index = 0; index < opts.streams; ++index)
+   {
+      receivers.push_back(new ev9::bandwidth(opts.port + index, opts.payload));
+
+      receivers.back()->set_interval(opts.interval);
+      receivers.back()->set_backend(opts.backend);
+      receivers.back()->set_socket_options(opts.socket_options);
+      receivers.back()->set_transport(opts.transport);
+      receivers.back()->set_verify(opts.verify);
+      receivers.back()->set_buffer_pool(opts.pool);
+      receivers.back()->set_framed_runs(opts.runs != 0);
+      receivers.back()->listen();
+   }
+
+   for (std::size_t index = 0; index < opts.streams; ++index)
+   {
+      threads.push_back(std::thread([&, index]()
+      {
+         std::string label = "receiver:" + std::to_string(opts.port + index);
+
+         if (!plan[index].empty())
+         {
+            ev9::topology::pin_current(plan[index]);
+
+            receivers[index]->set_buffer_node(layout.node_of(plan[index][0]));
+         }
+
+         while (true)
+         {
+            ev9::bandwidth::print(label.c_str(), receivers[index]->receive());
+         }
+      }));
+   }
+
+   for (std::thread& thread : threads)
+   {
+      thread.join();
+   }
+}
+
+void serve_sharded(const options& opts)
+{
+   #if __linux__
+      ev9::sharded_server server(opts.port, opts.workers);
+
+      server.set_socket_options(opts.socket_options);
+
+      // One receiver per worker for its read buffer and interval clock
+      std::vector<std::unique_ptr<ev9::bandwidth> > receivers;
+
+      for (std::size_t worker = 0; worker < server.workers(); ++worker)
+      {
+         receivers.push_back(std::unique_ptr<ev9::bandwidth>(new ev9::bandwidth(opts.port, opts.payload)));
+
+         receivers.back()->set_interval(opts.interval);
+         receivers.back()->set_verify(opts.verify);
+         receivers.back()->set_buffer_pool(opts.pool);
+         receivers.back()->set_framed_runs(opts.runs != 0);
+      }
+
+      server.start([&](ev9::socket& connection, std::size_t worker)
+      {
+         std::string label = "receiver:worker " + std::to_string(worker);
+
+         // Framed runs keep coming until the sender closes the connection
+         do
+         {
+            ev9::bandwidth::result res = receivers[worker]->drain(connection);
+
+            if (res.bytes != 0 || !receivers[worker]->connection_held()) ev9::bandwidth::print(label.c_str(), res);
+         }
+         while (receivers[worker]->connection_held());
+      });
+
+      std::printf("serving port %lu on %lu workers%s\n", (unsigned long)opts.port, (unsigned long)server.workers(), server.steered() ? ", steered by cpu" : "");
+
+      while (true)
+      {
+         std::this_thread::sleep_for(std::chrono::seconds(60));
+      }
+   #else
+      (void)opts;
+
+      throw std::runtime_error("-W needs SO_REUSEPORT balancing (Linux)");
+   #endif
+}
+
+void report_pool(const ev9::buffer_pool& pool, const ev9::page_faults& faults)
+{
+   const double mib = 1024.0 * 1024.0;
+
+   std::printf("[process] %lu minor, %lu major page faults\n", (unsigned long)faults.minor, (unsigned long)faults.major);
+
+   std::printf("[pool] %.1f MiB mapped, %.1f MiB hugetlb, %.1f MiB transparent huge pages, %.1f MiB locked, %lu hits, %lu misses\n",
+               pool.mapped_bytes() / mib,
+               pool.hugetlb_bytes() / mib,
+               pool.transparent_bytes() / mib,
+               pool.locked_bytes() / mib,
+               (unsigned long)pool.hits(),
+               (unsigned long)pool.misses());
+}
+
+// The first pair of flags that cannot run together, as a message, or an
+// empty string. pool is the -H or -K given, null for neither.
+std::string find_conflict(const options& opts, const char* const pool)
+{
+   std::string message;
+
+   auto check = [&message](bool first_given, const std::string& first, bool second_given, const std::string& second)
+   {
+      if (message.empty() && first_given && second_given) message = first + " cannot be combined with " + second;
+   };
+
+   bool placed = opts.placement != ev9::placement_none;
+   bool local = opts.transport != ev9::transport_tcp || opts.compare_transports;
+   bool other_mode = opts.mode != ev9::bandwidth::mode_copy;
+   bool uring = opts.backend != ev9::bandwidth::backend_classic;
+   bool streams = opts.streams > 1;
+
+   std::string mode = std::string("-m ") + ev9::bandwidth::mode_name(opts.mode);
+   std::string transport = opts.compare_transports ? "-T all" : std::string("-T ") + ev9::transport_kind_name(opts.transport);
+   std::string parallel = "-P " + std::to_string(opts.streams);
+
+   if (opts.streams == 0) return "-P needs at least one stream";
+   if (opts.workers && !opts.server) return "-W only applies to the receiver, -s";
+   if (opts.memory && (opts.server || !opts.host.empty())) return "-M runs on its own, without -s or -c";
+
+   // -A latency turns -L on, so -A is checked first wherever both are
+   const std::string tune = "-A";
+
+   // The pool hands out stream payloads; placement maps its own per node
+   if (pool != nullptr)
+   {
+      check(true, pool, opts.tune, tune);
+      check(true, pool, opts.latency, "-L");
+      check(true, pool, opts.udp, "-u");
+      check(true, pool, opts.memory, "-M");
+      check(true, pool, placed, "-a");
+   }
+
+   check(opts.tune, tune, opts.udp, "-u");
+   check(opts.tune, tune, opts.server, "-s");
+
+   // UDP paces its own packets on one socket
+   check(opts.udp, "-u", opts.latency, "-L");
+   check(opts.udp, "-u", other_mode, mode);
+   check(opts.udp, "-u", opts.compare_modes, "-Z");
+   check(opts.udp, "-u", opts.compare_backends, "-B both");
+   check(opts.udp, "-u", uring, "-B uring");
+   check(opts.udp, "-u", opts.sweep_streams, "-S");
+   check(opts.udp, "-u", streams, parallel);
+
+   // Workers drain the plain TCP stream
+   check(opts.workers != 0, "-W", opts.latency, "-L");
+   check(opts.workers != 0, "-W", opts.udp, "-u");
+   check(opts.workers != 0, "-W", streams, parallel);
+   check(opts.workers != 0, "-W", uring, "-B uring");
+
+   // Only the stream paths, plain or parallel, know how to place threads
+   check(placed, "-a", opts.tune, tune);
+   check(placed, "-a", opts.latency, "-L");
+   check(placed, "-a", opts.udp, "-u");
+   check(placed, "-a", opts.workers != 0, "-W");
+   check(placed, "-a", opts.compare_modes, "-Z");
+   check(placed, "-a", opts.compare_backends, "-B both");
+
+   // Local transports carry the plain copy stream and ping-pong, nothing else
+   check(local, transport, opts.udp, "-u");
+   check(local, transport, opts.tune, tune);
+   check(local, transport, opts.workers != 0, "-W");
+   check(local, transport, opts.compare_modes, "-Z");
+   check(local, transport, opts.compare_backends, "-B both");
+   check(local, transport, other_mode, mode);
+   check(local, transport, uring, "-B uring");
+
+   check(opts.compare_transports, transport, opts.server, "-s");
+   check(opts.compare_transports, transport, !opts.host.empty(), "-c");
+   check(opts.compare_transports, transport, streams, parallel);
+   check(opts.compare_transports, transport, opts.sweep_streams, "-S");
+   check(opts.compare_transports, transport, placed, "-a");
+
+   // Only the copy stream has chunks to check
+   check(opts.verify, "-V", opts.tune, tune);
+   check(opts.verify, "-V", opts.latency, "-L");
+   check(opts.verify, "-V", opts.udp, "-u");
+   check(opts.verify, "-V", opts.compare_modes, "-Z");
+   check(opts.verify, "-V", other_mode, mode);
+
+   // Runs are framed on one plain TCP copy stream; a server frames each port
+   check(opts.runs != 0, "-R", opts.tune, tune);
+   check(opts.runs != 0, "-R", opts.latency, "-L");
+   check(opts.runs != 0, "-R", opts.udp, "-u");
+   check(opts.runs != 0, "-R", opts.memory, "-M");
+   check(opts.runs != 0, "-R", opts.compare_modes, "-Z");
+   check(opts.runs != 0, "-R", opts.compare_backends, "-B both");
+   check(opts.runs != 0, "-R", opts.sweep_streams, "-S");
+   check(opts.runs != 0, "-R", placed, "-a");
+   check(opts.runs != 0, "-R", local, transport);
+   check(opts.runs != 0, "-R", other_mode, mode);
+   check(opts.runs != 0, "-R", uring, "-B uring");
+   check(opts.runs != 0, "-R", streams && !opts.server, parallel);
+
+   if (message.empty() && opts.verify && opts.payload < 32) message = "-V needs a payload (-l) of at least 32 bytes";
+
+   return message;
+}
+
+int main(int argc, char** argv)
+{
+   options opts;
+
+   opts.server = false;
+   opts.compare_modes = false;
+   opts.sweep_streams = false;
+   opts.latency = false;
+   opts.memory = false;
+   opts.verify = false;
+   opts.compare_backends = false;
+   opts.udp = false;
+   opts.offload = false;
+   opts.rate = 0;
+   opts.streams = 1;
+   opts.iterations = 0;
+   opts.workers = 0;
+   opts.runs = 0;
+   opts.port = 5201;
+   opts.payload = 128 * 1024;
+   opts.byte_count = 0;
+   opts.duration = 10;
+   opts.interval = 1;
+   opts.mode = ev9::bandwidth::mode_copy;
+   opts.backend = ev9::bandwidth::backend_classic;
+   opts.tune = 0;
+   opts.placement = ev9::placement_none;
+   opts.transport = ev9::transport_tcp;
+   opts.compare_transports = false;
+   opts.pool = nullptr;
+
+   std::size_t payload = 0;
+
+   bool pooled = false;
+   bool locked = false;
+
+   bool duration_given = false;
+
+   for (int index = 1; index < argc; ++index)
+   {
+      std::string arg = argv[index];
+
+      bool has_value = index + 1 < argc;
+
+      if (arg == "-s") opts.server = true;
+      else if (arg == "-Z") opts.compare_modes = true;
+      else if (arg == "-S") opts.sweep_streams = true;
+      else if (arg == "-L") opts.latency = true;
+      else if (arg == "-M") opts.memory = true;
+      else if (arg == "-V") opts.verify = true;
+      else if (arg == "-H") pooled = true;
+      else if (arg == "-K") pooled = locked = true;
+      else if (arg == "-u") opts.udp = true;
+      else if (arg == "-G") opts.offload = true;
+      else if (arg == "-b" && has_value) opts.rate = parse_rate(argv[++index]);
+      else if (arg == "-N" && has_value) opts.iterations = std::strtoul(argv[++index], nullptr, 10);
+      else if (arg == "-P" && has_value) opts.streams = std::strtoul(argv[++index], nullptr, 10);
+      else if (arg == "-W" && has_value) opts.workers = std::strtoul(argv[++index], nullptr, 10);
+      else if (arg == "-R" && has_value) opts.runs = std::strtoul(argv[++index], nullptr, 10);
+      else if (arg == "-c" && has_value) opts.host = argv[++index];
+      else if (arg == "-p" && has_value) opts.port = std::strtoul(argv[++index], nullptr, 10);
+      else if (arg == "-l" && has_value) payload = std::strtoul(argv[++index], nullptr, 10);
+      else if (arg == "-t" && has_value) { opts.duration = std::atof(argv[++index]); duration_given = true; }
+      else if (arg == "-n" && has_value) opts.byte_count = std::strtoul(argv[++index], nullptr, 10);
+      else if (arg == "-i" && has_value) opts.interval = std::atof(argv[++index]);
+      else if (arg == "-F" && has_value) opts.send_file = argv[++index];
+      else if (arg == "-m" && has_value && parse_mode(argv[index + 1], opts.mode)) ++index;
+      else if (arg == "-B" && has_value && parse_backend(argv[index + 1], opts)) ++index;
+      else if (arg == "-A" && has_value && parse_tune(argv[index + 1], opts)) ++index;
+      else if (arg == "-a" && has_value && ev9::parse_placement(argv[index + 1], opts.placement)) ++index;
+      else if (arg == "-T" && has_value && parse_transport(argv[index + 1], opts)) ++index;
+
+      else if (arg == "-o" && has_value && parse_socket_option(argv[index + 1], opts.socket_options)) ++index;
+
+      else
+      {
+         usage();
+
+         return 1;
+      }
+   }
+
+   #if !_WIN32
+      // A receiver that goes away mid-transfer should surface as a write error
+      std::signal(SIGPIPE, SIG_IGN);
+   #endif
+
+   if (opts.tune == tune_latency) opts.latency = true;
+
+   if (payload) opts.payload = payload;
+   else if (opts.latency) opts.payload = 64;
+   else if (opts.udp) opts.payload = 1472;
+
+   if (opts.tune && !duration_given) opts.duration = 1;
+
+   std::string conflict = find_conflict(opts, pooled ? (locked ? "-K" : "-H") : nullptr);
+
+   if (!conflict.empty())
+   {
+      std::fprintf(stderr, "%s\n", conflict.c_str());
+
+      usage();
+
+      return 1;
+   }
+
+   // Before any receiver in this process starts waiting on the sender
+   if (!opts.send_file.empty() && !opts.server && !readable(opts.send_file))
+   {
+      std::fprintf(stderr, "cannot open %s\n", opts.send_file.c_str());
+
+      return 1;
+   }
+
+   ev9::buffer_pool pool;
+
+   if (pooled)
+   {
+      pool.set_lock(locked);
+
+      opts.pool = &pool;
+   }
+
+   ev9::page_faults faults = ev9::page_faults::now();
+
+   try
+   {
+      if (opts.memory)
+      {
+         run_memory();
+      }
+
+      else if (opts.compare_transports)
+      {
+         compare_transports(opts);
+      }
+
+      else if (opts.server && opts.latency)
+      {
+         serve_latency(opts);
+      }
+
+      else if (opts.server && opts.udp)
+      {
+         serve_udp(opts);
+      }
+
+      else if (opts.tune)
+      {
+         auto_tune(opts);
+      }
+
+      else if (opts.udp)
+      {
+         run_udp(opts);
+      }
+
+      else if (opts.server && opts.workers)
+      {
+         serve_sharded(opts);
+      }
+
+      else if (opts.server)
+      {
+         serve(opts);
+      }
+
+      else if (opts.latency)
+      {
+         run_latency(opts);
+      }
+
+      else if (opts.compare_modes)
+      {
+         compare_modes(opts);
+      }
+
+      else if (opts.compare_backends)
+      {
+         compare_backends(opts);
+      }
+
+      else if (opts.sweep_streams)
+      {
+         sweep_streams(opts);
+      }
+
+      else if (opts.streams > 1 || opts.placement != ev9::placement_none)
+      {
+         ev9::parallel_bandwidth::print("sender", run_parallel(opts, opts.streams));
+
+         std::printf("[sender] placement %s\n", describe_placement(opts, opts.streams).c_str());
+      }
+
+      else if (opts.runs)
+      {
+         repeat_runs(opts);
+      }
+
+      else if (!opts.host.empty())
+      {
+         ev9::bandwidth::print("sender", run_sender(opts, opts.mode));
+      }
+
+      else
+      {
+         ev9::bandwidth::result received;
+
+         ev9::bandwidth::result sent = run_loopback(opts, opts.mode, received);
+
+         ev9::bandwidth::print("sender", sent);
+         ev9::bandwidth::print("receiver", received);
+      }
+
+      if (pooled) report_pool(pool, ev9::page_faults::now() - faults);
+   }
+
+   catch (std::exception& e)
+   {
+      std::printf("%s\n", e.what());
+
+      return 1;
+   }
+
    return 0;
-}*/
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // end of main.cpp
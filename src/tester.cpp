@@ -8,7 +8,7 @@
 // Time-period:
 //
 // Dec 11, 2014: Version 1.0: Created
-// Dec 11, 2014: Version 1.0: Last Updated
+// Oct 17, 2026: Version 1.1: Last Updated
 //
 // Notes:
 //
@@ -22,4 +22,40 @@
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-ev9::tester* ev9::tester::m_test_object = nullptr;
\ No newline at end of file
+void ev9::tester::_work(std::size_t index, std::shared_ptr<worker_token> token, std::size_t seen, bool resume)
+{
+   while (true)
+   {
+      if (!resume)
+      {
+         std::unique_lock<std::mutex> lock(_m_pool_lock);
+
+         // Parked until the next run or shutdown
+         _m_wake.wait(lock, [&]() { return _m_stopping || _m_generation != seen; });
+
+         if (_m_stopping)
+         {
+            return;
+         }
+
+         seen = _m_generation;
+      }
+
+      resume = false;
+
+      if (!_m_tasks[index].run(token))
+      {
+         // Abandoned after a timeout, the tester may already be gone
+         return;
+      }
+
+      {
+         std::lock_guard<std::mutex> lock(_m_pool_lock);
+
+         if (--_m_active == 0)
+         {
+            _m_done.notify_all();
+         }
+      }
+   }
+}
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: benchmark.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Microbenchmarks for the tester. A benchmark runs its warmup iterations,
+// then its timed ones on steady_clock. Each timed sample repeats the
+// function enough times to take at least a few microseconds, which keeps
+// clock overhead and resolution out of short kernels, and is stored as
+// nanoseconds per call.
+//
+// do_not_optimize() and clobber_memory() stop the compiler from deleting a
+// kernel whose result is unused or from keeping its stores in registers.
+//
+// Requirements: c++11
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __BENCHMARK_HPP__
+#define __BENCHMARK_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if _WIN32
+   #include <intrin.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Forces value to be materialised, as if it were read by an opaque call
+template<typename type> inline void do_not_optimize(const type& value)
+{
+   #if _WIN32
+      const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+
+      (void)*sink;
+
+      _ReadWriteBarrier();
+   #else
+      asm volatile("" : : "r,m"(value) : "memory");
+   #endif
+}
+
+// Forces every pending store to memory before the next statement
+inline void clobber_memory()
+{
+   #if _WIN32
+      _ReadWriteBarrier();
+   #else
+      asm volatile("" : : : "memory");
+   #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class benchmark
+{
+   public:  // Type definitions
+
+      typedef std::chrono::steady_clock clock;
+
+      class result
+      {
+         public:
+
+            result() : iterations(0), calls_per_sample(0), mean(0), stddev(0), min(0), median(0), confidence(0) { }
+
+            std::string name;
+
+            std::size_t iterations;
+            std::size_t calls_per_sample;
+
+            // Nanoseconds per call
+            double mean;
+            double stddev;
+            double min;
+            double median;
+
+            // Half width of the 95% confidence interval of the mean
+            double confidence;
+
+      }; // end of class(result)
+
+   public:  // Constructor | Destructor
+
+      benchmark(const std::string& name, const std::function<void()>& function, std::size_t iterations = 30, std::size_t warmup = 3) { _ctor(name, function, iterations, warmup); }
+      ~benchmark() { }
+
+   public:  // Public Member Functions
+
+      result run() const { return _run(); }
+
+      const std::string& name() const { return _m_name; }
+
+      // Statistics of samples measured elsewhere, in their own unit;
+      // print() reads them as nanoseconds per call
+      static result summarize(const std::string& name, std::vector<double> samples) { return _summarize(name, samples); }
+
+      static void print_header() { _print_header(); }
+      static void print(const result& current) { _print(current); }
+
+   private: // Private Member Functions
+
+      void _ctor(const std::string& name, const std::function<void()>& function, std::size_t iterations, std::size_t warmup)
+      {
+         if (iterations == 0)
+         {
+            throw std::runtime_error("A benchmark needs at least one iteration");
+         }
+
+         _m_name = name;
+         _m_function = function;
+         _m_iterations = iterations;
+         _m_warmup = warmup;
+      }
+
+      result _run() const
+      {
+         const std::chrono::nanoseconds minimum_sample(5000);
+
+         // Warmup doubles the calls per sample until one sample is long
+         // enough to time, and always runs at least once
+         std::size_t calls = 1;
+
+         for (std::size_t iteration = 0; iteration < _m_warmup || iteration == 0; ++iteration)
+         {
+            while (_time(calls) < minimum_sample && calls < (std::size_t(1) << 30))
+            {
+               calls *= 2;
+            }
+         }
+
+         std::vector<double> samples;
+
+         samples.reserve(_m_iterations);
+
+         for (std::size_t iteration = 0; iteration < _m_iterations; ++iteration)
+         {
+            std::chrono::duration<double, std::nano> elapsed = _time(calls);
+
+            samples.push_back(elapsed.count() / calls);
+         }
+
+         result summary = _summarize(_m_name, samples);
+
+         summary.calls_per_sample = calls;
+
+         return summary;
+      }
+
+      clock::duration _time(std::size_t calls) const
+      {
+         clock::time_point start = clock::now();
+
+         for (std::size_t call = 0; call < calls; ++call)
+         {
+            _m_function();
+
+            clobber_memory();
+         }
+
+         return clock::now() - start;
+      }
+
+      static result _summarize(const std::string& name, std::vector<double> samples)
+      {
+         result summary;
+
+         summary.name = name;
+         summary.iterations = samples.size();
+
+         if (samples.empty())
+         {
+            return summary;
+         }
+
+         std::sort(samples.begin(), samples.end());
+
+         double total = 0;
+
+         for (double sample : samples)
+         {
+            total += sample;
+         }
+
+         std::size_t count = samples.size();
+
+         summary.mean = total / count;
+         summary.min = samples.front();
+         summary.median = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+
+         if (count > 1)
+         {
+            double squares = 0;
+
+            for (double sample : samples)
+            {
+               squares += (sample - summary.mean) * (sample - summary.mean);
+            }
+
+            summary.stddev = std::sqrt(squares / (count - 1));
+            summary.confidence = _student_t(count - 1) * summary.stddev / std::sqrt((double)count);
+         }
+
+         return summary;
+      }
+
+      // Two sided 95% critical value of Student's t distribution
+      static double _student_t(std::size_t degrees_of_freedom)
+      {
+         static const double table[] =
+         {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+         };
+
+         if (degrees_of_freedom <= sizeof(table) / sizeof(table[0]))
+         {
+            return table[degrees_of_freedom - 1];
+         }
+
+         return degrees_of_freedom <= 60 ? 2.000 : 1.960;
+      }
+
+      static void _print_header()
+      {
+         std::printf("%-28s %8s %12s %12s %12s %12s %12s\n", "benchmark", "samples", "mean ns", "stddev ns", "min ns", "median ns", "95% ci ns");
+      }
+
+      static void _print(const result& current)
+      {
+         std::printf("%-28s %8lu %12.1f %12.1f %12.1f %12.1f %12s\n",
+                     current.name.c_str(),
+                     (unsigned long)current.iterations,
+                     current.mean,
+                     current.stddev,
+                     current.min,
+                     current.median,
+                     ("+/- " + _format(current.confidence)).c_str());
+      }
+
+      static std::string _format(double value)
+      {
+         char buffer[32];
+
+         std::snprintf(buffer, sizeof(buffer), "%.1f", value);
+
+         return buffer;
+      }
+
+   private: // Member Variables
+
+      std::string _m_name;
+      std::function<void()> _m_function;
+
+      std::size_t _m_iterations;
+      std::size_t _m_warmup;
+
+}; // end of class(benchmark)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __BENCHMARK_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
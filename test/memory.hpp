@@ -0,0 +1,815 @@
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//
+// Author: Jarret Shook
+//
+// Module: memory.hpp
+//
+// Time-period:
+//
+// Oct 17, 2026: Version 1.0: Created
+// Oct 17, 2026: Version 1.0: Last Updated
+//
+// Notes:
+//
+// Memory bandwidth baseline for the network numbers. The STREAM kernels
+// run on arrays of doubles:
+//
+//    read    sum += a[i]
+//    write   a[i] = s
+//    copy    a[i] = b[i]
+//    triad   a[i] = b[i] + s * c[i]
+//
+// Each kernel comes scalar, SSE2, AVX2 and AVX-512, picked at run time
+// from what the CPU supports. Kernels that store can also use
+// non-temporal stores, which skip the cache and the read-for-ownership
+// of the lines they write. Bytes are counted the STREAM way, without
+// that extra read, so a cached store shows up as the slower one once
+// the arrays outgrow the caches.
+//
+// A measurement runs on the workers of an ev9::tester, one test per
+// thread, pinned by a placement (scatter unless set). The working set is
+// the total for all threads, split evenly between them, so a size keeps
+// its cache level as the thread count grows. Each thread maps and touches
+// its own arrays, then all start together; a sample is every thread's
+// bytes over the slowest thread's time, best of a few.
+//
+// Requirements: c++11; SIMD kernels need GCC or Clang on x86
+//
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __MEMORY_HPP__
+#define __MEMORY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+#include "tester.hpp"
+#include "topology.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+   #define EV9_MEMORY_X86 1
+
+   #include <immintrin.h>
+#else
+   #define EV9_MEMORY_X86 0
+#endif
+
+// Keeps the scalar kernels scalar: GCC would otherwise vectorize them, or
+// turn the copy into a call to memcpy
+#if defined(__GNUC__) && !defined(__clang__)
+   #define EV9_SCALAR_KERNEL __attribute__((optimize("no-tree-vectorize", "no-tree-loop-distribute-patterns")))
+#else
+   #define EV9_SCALAR_KERNEL
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ev9 {
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class memory_bandwidth
+{
+   public:  // Type definitions
+
+      enum operation
+      {
+         op_read,
+         op_write,
+         op_copy,
+         op_triad
+      };
+
+      enum kernel
+      {
+         kernel_scalar,
+         kernel_sse2,
+         kernel_avx2,
+         kernel_avx512
+      };
+
+      class result
+      {
+         public:
+
+            result() : op(op_read), isa(kernel_scalar), non_temporal(false), working_set(0), threads(0), bytes(0), seconds(0) { }
+
+            operation op;
+            kernel isa;
+            bool non_temporal;
+
+            // Bytes of arrays for all threads together
+            std::size_t working_set;
+            std::size_t threads;
+
+            std::size_t bytes;
+            double seconds;
+
+            double gbytes() const { return seconds > 0 ? bytes / seconds / 1e9 : 0; }
+
+      }; // end of class(result)
+
+      typedef std::vector<result> results;
+
+   public:  // Constructor | Destructor
+
+      memory_bandwidth() { _ctor(); }
+      ~memory_bandwidth() { }
+
+   public:  // Public Member Functions
+
+      // One measurement, on threads tester workers
+      result measure(operation op, kernel isa, bool non_temporal, std::size_t working_set, std::size_t threads) { return _measure(op, isa, non_temporal, working_set, threads); }
+
+      // Every operation and supported kernel, with and without
+      // non-temporal stores, over sizes() on threads workers
+      results size_sweep(std::size_t threads) { return _sweep(sizes(), std::vector<std::size_t>(1, threads)); }
+
+      // The same over thread_counts() at one working set
+      results thread_sweep(std::size_t working_set) { return _sweep(std::vector<std::size_t>(1, working_set), thread_counts()); }
+
+      // Bytes each thread moves per sample, 64 MiB by default
+      void set_sample_bytes(std::size_t bytes) { _m_sample_bytes = bytes; }
+
+      // Samples per measurement, of which the best is kept
+      void set_repetitions(std::size_t count) { _m_repetitions = count < 1 ? 1 : count; }
+
+      void set_placement(placement policy) { _m_placement = policy; }
+
+      // Working sets from 16 KiB up, by factors of four, to past four times
+      // the last level cache; capped at max_bytes
+      std::vector<std::size_t> sizes(std::size_t max_bytes = 1024UL * 1024 * 1024) const { return _sizes(max_bytes); }
+
+      // 1, 2, 4... up to every CPU this process may run on
+      std::vector<std::size_t> thread_counts() const { return _thread_counts(); }
+
+      // Data and unified cache sizes in bytes, innermost first
+      const std::vector<std::size_t>& caches() const { return _m_caches; }
+
+      // "L1", "L2", "L3" or "DRAM": the innermost cache the working set
+      // fits in
+      std::string level(std::size_t working_set) const { return _level(working_set); }
+
+      static bool supported(kernel isa) { return _supported(isa); }
+      static std::vector<kernel> kernels() { return _kernels(); }
+
+      static const char* operation_name(operation op) { return _operation_name(op); }
+      static const char* kernel_name(kernel isa) { return _kernel_name(isa); }
+
+      // Arrays of count doubles the operation touches
+      static std::size_t arrays(operation op) { return op == op_triad ? 3 : (op == op_copy ? 2 : 1); }
+
+      // One pass of a kernel over count doubles, count a multiple of 16 and
+      // the arrays 64 byte aligned; returns the sum for read, 0 otherwise
+      static double pass(operation op, kernel isa, bool non_temporal, double* a, const double* b, const double* c, std::size_t count) { return _pass(op, isa, non_temporal, a, b, c, count); }
+
+      // A table per result set: a row for each kernel, a column for each
+      // working set or thread count, in GB/s
+      void print(const results& res) const { _print(res); }
+
+   private: // Start line for the threads of one sample
+
+      class barrier
+      {
+         public:
+
+            barrier(std::size_t count) : _m_count(count), _m_waiting(0), _m_generation(0) { }
+
+            void wait()
+            {
+               std::unique_lock<std::mutex> lock(_m_mutex);
+
+               std::size_t generation = _m_generation;
+
+               if (++_m_waiting == _m_count)
+               {
+                  _m_waiting = 0;
+                  ++_m_generation;
+
+                  _m_released.notify_all();
+
+                  return;
+               }
+
+               _m_released.wait(lock, [&]() { return _m_generation != generation; });
+            }
+
+         private:
+
+            std::mutex _m_mutex;
+            std::condition_variable _m_released;
+
+            std::size_t _m_count;
+            std::size_t _m_waiting;
+            std::size_t _m_generation;
+
+      }; // end of class(barrier)
+
+   private: // Private Member Functions
+
+      void _ctor()
+      {
+         _m_sample_bytes = 64 * 1024 * 1024;
+         _m_repetitions = 3;
+         _m_placement = placement_scatter;
+
+         _m_cpus = _m_topology.cpus().size();
+
+         if (_m_cpus == 0) _m_cpus = 1;
+
+         #if __linux__
+            for (int index = 0; ; ++index)
+            {
+               std::string path = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+
+               std::ifstream type_file(path + "type");
+               std::ifstream size_file(path + "size");
+
+               std::string type;
+               std::size_t size = 0;
+               char unit = 0;
+
+               if (!(type_file >> type) || !(size_file >> size)) break;
+
+               if (type == "Instruction") continue;
+
+               if (size_file >> unit)
+               {
+                  if (unit == 'K') size *= 1024;
+                  else if (unit == 'M') size *= 1024 * 1024;
+               }
+
+               _m_caches.push_back(size);
+            }
+         #endif
+
+         // Something plausible where the caches cannot be read
+         if (_m_caches.empty())
+         {
+            _m_caches.push_back(32 * 1024);
+            _m_caches.push_back(1024 * 1024);
+            _m_caches.push_back(32 * 1024 * 1024);
+         }
+      }
+
+      result _measure(operation op, kernel isa, bool non_temporal, std::size_t working_set, std::size_t threads)
+      {
+         if (!_supported(isa))
+         {
+            throw std::runtime_error(std::string("This CPU has no ") + _kernel_name(isa));
+         }
+
+         if (threads == 0)
+         {
+            throw std::runtime_error("At least one thread is required");
+         }
+
+         // Whole 64 byte lines of every array, two vectors of the widest kernel
+         std::size_t count = working_set / threads / arrays(op) / sizeof(double);
+
+         count -= count % 16;
+
+         if (count == 0) count = 16;
+
+         std::size_t thread_bytes = count * arrays(op) * sizeof(double);
+         std::size_t passes = std::max<std::size_t>(1, _m_sample_bytes / thread_bytes);
+
+         std::vector<std::vector<double> > seconds(threads, std::vector<double>(_m_repetitions, 0));
+
+         barrier start(threads);
+
+         tester pool(threads);
+
+         pool.set_placement(_m_placement);
+
+         for (std::size_t thread = 0; thread < threads; ++thread)
+         {
+            pool.run([&, thread]()
+            {
+               // Mapped and touched here, so the pages sit on this worker's node
+               node_buffer memory(thread_bytes + 64);
+
+               double* a = (double*)(((std::uintptr_t)memory.data() + 63) & ~(std::uintptr_t)63);
+               double* b = op == op_read || op == op_write ? a : a + count;
+               double* c = op == op_triad ? b + count : b;
+
+               std::fill(a, a + count * arrays(op), 1.0);
+
+               do_not_optimize(_pass(op, isa, non_temporal, a, b, c, count));
+
+               for (std::size_t repetition = 0; repetition < _m_repetitions; ++repetition)
+               {
+                  start.wait();
+
+                  auto begin = std::chrono::steady_clock::now();
+
+                  double sum = 0;
+
+                  for (std::size_t index = 0; index < passes; ++index)
+                  {
+                     sum += _pass(op, isa, non_temporal, a, b, c, count);
+
+                     clobber_memory();
+                  }
+
+                  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+                  do_not_optimize(sum);
+
+                  seconds[thread][repetition] = elapsed.count();
+               }
+            });
+         }
+
+         if (pool.run_tests(false) != 0)
+         {
+            throw std::runtime_error("A memory bandwidth thread failed");
+         }
+
+         result res;
+
+         res.op = op;
+         res.isa = isa;
+         res.non_temporal = non_temporal;
+         res.working_set = working_set;
+         res.threads = threads;
+         res.bytes = passes * thread_bytes * threads;
+
+         for (std::size_t repetition = 0; repetition < _m_repetitions; ++repetition)
+         {
+            double slowest = 0;
+
+            for (std::size_t thread = 0; thread < threads; ++thread)
+            {
+               slowest = std::max(slowest, seconds[thread][repetition]);
+            }
+
+            if (res.seconds == 0 || slowest < res.seconds) res.seconds = slowest;
+         }
+
+         return res;
+      }
+
+      results _sweep(const std::vector<std::size_t>& working_sets, const std::vector<std::size_t>& threads)
+      {
+         const operation operations[] = { op_read, op_write, op_copy, op_triad };
+
+         results res;
+
+         for (operation op : operations)
+         {
+            for (kernel isa : _kernels())
+            {
+               for (int non_temporal = 0; non_temporal < 2; ++non_temporal)
+               {
+                  // Scalar code has no portable non-temporal store
+                  if (non_temporal && (op == op_read || isa == kernel_scalar)) continue;
+
+                  for (std::size_t working_set : working_sets)
+                  {
+                     for (std::size_t thread_count : threads)
+                     {
+                        res.push_back(_measure(op, isa, non_temporal != 0, working_set, thread_count));
+                     }
+                  }
+               }
+            }
+         }
+
+         return res;
+      }
+
+      std::vector<std::size_t> _sizes(std::size_t max_bytes) const
+      {
+         std::vector<std::size_t> res;
+
+         std::size_t last = 4 * _m_caches.back();
+
+         for (std::size_t size = 16 * 1024; size <= max_bytes; size *= 4)
+         {
+            res.push_back(size);
+
+            if (size > last) break;
+         }
+
+         return res;
+      }
+
+      std::vector<std::size_t> _thread_counts() const
+      {
+         std::vector<std::size_t> res;
+
+         for (std::size_t count = 1; count < _m_cpus; count *= 2)
+         {
+            res.push_back(count);
+         }
+
+         res.push_back(_m_cpus);
+
+         return res;
+      }
+
+      std::string _level(std::size_t working_set) const
+      {
+         for (std::size_t index = 0; index < _m_caches.size(); ++index)
+         {
+            if (working_set <= _m_caches[index]) return "L" + std::to_string(index + 1);
+         }
+
+         return "DRAM";
+      }
+
+      static bool _supported(kernel isa)
+      {
+         #if EV9_MEMORY_X86
+            switch (isa)
+            {
+               case kernel_scalar: return true;
+               case kernel_sse2: return __builtin_cpu_supports("sse2") != 0;
+               case kernel_avx2: return __builtin_cpu_supports("avx2") != 0;
+               case kernel_avx512: return __builtin_cpu_supports("avx512f") != 0;
+            }
+
+            return false;
+         #else
+            return isa == kernel_scalar;
+         #endif
+      }
+
+      static std::vector<kernel> _kernels()
+      {
+         const kernel all[] = { kernel_scalar, kernel_sse2, kernel_avx2, kernel_avx512 };
+
+         std::vector<kernel> res;
+
+         for (kernel isa : all)
+         {
+            if (_supported(isa)) res.push_back(isa);
+         }
+
+         return res;
+      }
+
+      static const char* _operation_name(operation op)
+      {
+         switch (op)
+         {
+            case op_write: return "write";
+            case op_copy: return "copy";
+            case op_triad: return "triad";
+            default: return "read";
+         }
+      }
+
+      static const char* _kernel_name(kernel isa)
+      {
+         switch (isa)
+         {
+            case kernel_sse2: return "sse2";
+            case kernel_avx2: return "avx2";
+            case kernel_avx512: return "avx512";
+            default: return "scalar";
+         }
+      }
+
+      static double _pass(operation op, kernel isa, bool non_temporal, double* a, const double* b, const double* c, std::size_t count)
+      {
+         #if EV9_MEMORY_X86
+            switch (isa)
+            {
+               case kernel_sse2: return _pass_sse2(op, non_temporal, a, b, c, count);
+               case kernel_avx2: return _pass_avx2(op, non_temporal, a, b, c, count);
+               case kernel_avx512: return _pass_avx512(op, non_temporal, a, b, c, count);
+               default: break;
+            }
+         #else
+            (void)isa;
+            (void)non_temporal;
+         #endif
+
+         return _pass_scalar(op, a, b, c, count);
+      }
+
+      EV9_SCALAR_KERNEL static double _pass_scalar(operation op, double* a, const double* b, const double* c, std::size_t count)
+      {
+         const double scalar = 3.0;
+
+         switch (op)
+         {
+            case op_read:
+            {
+               // Four sums, so the adds do not wait on each other
+               double sum[4] = { 0, 0, 0, 0 };
+
+               for (std::size_t index = 0; index < count; index += 4)
+               {
+                  sum[0] += a[index];
+                  sum[1] += a[index + 1];
+                  sum[2] += a[index + 2];
+                  sum[3] += a[index + 3];
+               }
+
+               return sum[0] + sum[1] + sum[2] + sum[3];
+            }
+
+            case op_write:
+               for (std::size_t index = 0; index < count; ++index) a[index] = scalar;
+               break;
+
+            case op_copy:
+               for (std::size_t index = 0; index < count; ++index) a[index] = b[index];
+               break;
+
+            case op_triad:
+               for (std::size_t index = 0; index < count; ++index) a[index] = b[index] + scalar * c[index];
+               break;
+         }
+
+         return 0;
+      }
+
+      #if EV9_MEMORY_X86
+
+      // Each SIMD pass handles two vectors per iteration. The kernels are
+      // compiled for their instruction set whatever the build flags, and
+      // only called once supported() has said yes.
+
+      __attribute__((target("sse2"))) static double _pass_sse2(operation op, bool non_temporal, double* a, const double* b, const double* c, std::size_t count)
+      {
+         const __m128d scalar = _mm_set1_pd(3.0);
+
+         switch (op)
+         {
+            case op_read:
+            {
+               __m128d sum0 = _mm_setzero_pd();
+               __m128d sum1 = _mm_setzero_pd();
+
+               for (std::size_t index = 0; index < count; index += 4)
+               {
+                  sum0 = _mm_add_pd(sum0, _mm_load_pd(a + index));
+                  sum1 = _mm_add_pd(sum1, _mm_load_pd(a + index + 2));
+               }
+
+               double lanes[2];
+
+               _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+
+               return lanes[0] + lanes[1];
+            }
+
+            case op_write:
+               if (non_temporal) for (std::size_t index = 0; index < count; index += 4) { _mm_stream_pd(a + index, scalar); _mm_stream_pd(a + index + 2, scalar); }
+               else for (std::size_t index = 0; index < count; index += 4) { _mm_store_pd(a + index, scalar); _mm_store_pd(a + index + 2, scalar); }
+               break;
+
+            case op_copy:
+               if (non_temporal) for (std::size_t index = 0; index < count; index += 4) { _mm_stream_pd(a + index, _mm_load_pd(b + index)); _mm_stream_pd(a + index + 2, _mm_load_pd(b + index + 2)); }
+               else for (std::size_t index = 0; index < count; index += 4) { _mm_store_pd(a + index, _mm_load_pd(b + index)); _mm_store_pd(a + index + 2, _mm_load_pd(b + index + 2)); }
+               break;
+
+            case op_triad:
+               for (std::size_t index = 0; index < count; index += 4)
+               {
+                  __m128d first = _mm_add_pd(_mm_load_pd(b + index), _mm_mul_pd(scalar, _mm_load_pd(c + index)));
+                  __m128d second = _mm_add_pd(_mm_load_pd(b + index + 2), _mm_mul_pd(scalar, _mm_load_pd(c + index + 2)));
+
+                  if (non_temporal) { _mm_stream_pd(a + index, first); _mm_stream_pd(a + index + 2, second); }
+                  else { _mm_store_pd(a + index, first); _mm_store_pd(a + index + 2, second); }
+               }
+               break;
+         }
+
+         // Streaming stores are weakly ordered
+         if (non_temporal) _mm_sfence();
+
+         return 0;
+      }
+
+      __attribute__((target("avx2"))) static double _pass_avx2(operation op, bool non_temporal, double* a, const double* b, const double* c, std::size_t count)
+      {
+         const __m256d scalar = _mm256_set1_pd(3.0);
+
+         switch (op)
+         {
+            case op_read:
+            {
+               __m256d sum0 = _mm256_setzero_pd();
+               __m256d sum1 = _mm256_setzero_pd();
+
+               for (std::size_t index = 0; index < count; index += 8)
+               {
+                  sum0 = _mm256_add_pd(sum0, _mm256_load_pd(a + index));
+                  sum1 = _mm256_add_pd(sum1, _mm256_load_pd(a + index + 4));
+               }
+
+               double lanes[4];
+
+               _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+
+               return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            }
+
+            case op_write:
+               if (non_temporal) for (std::size_t index = 0; index < count; index += 8) { _mm256_stream_pd(a + index, scalar); _mm256_stream_pd(a + index + 4, scalar); }
+               else for (std::size_t index = 0; index < count; index += 8) { _mm256_store_pd(a + index, scalar); _mm256_store_pd(a + index + 4, scalar); }
+               break;
+
+            case op_copy:
+               if (non_temporal) for (std::size_t index = 0; index < count; index += 8) { _mm256_stream_pd(a + index, _mm256_load_pd(b + index)); _mm256_stream_pd(a + index + 4, _mm256_load_pd(b + index + 4)); }
+               else for (std::size_t index = 0; index < count; index += 8) { _mm256_store_pd(a + index, _mm256_load_pd(b + index)); _mm256_store_pd(a + index + 4, _mm256_load_pd(b + index + 4)); }
+               break;
+
+            case op_triad:
+               for (std::size_t index = 0; index < count; index += 8)
+               {
+                  __m256d first = _mm256_add_pd(_mm256_load_pd(b + index), _mm256_mul_pd(scalar, _mm256_load_pd(c + index)));
+                  __m256d second = _mm256_add_pd(_mm256_load_pd(b + index + 4), _mm256_mul_pd(scalar, _mm256_load_pd(c + index + 4)));
+
+                  if (non_temporal) { _mm256_stream_pd(a + index, first); _mm256_stream_pd(a + index + 4, second); }
+                  else { _mm256_store_pd(a + index, first); _mm256_store_pd(a + index + 4, second); }
+               }
+               break;
+         }
+
+         if (non_temporal) _mm_sfence();
+
+         // Leaves no dirty upper halves to slow down SSE code that follows
+         _mm256_zeroupper();
+
+         return 0;
+      }
+
+      __attribute__((target("avx512f"))) static double _pass_avx512(operation op, bool non_temporal, double* a, const double* b, const double* c, std::size_t count)
+      {
+         const __m512d scalar = _mm512_set1_pd(3.0);
+
+         switch (op)
+         {
+            case op_read:
+            {
+               __m512d sum0 = _mm512_setzero_pd();
+               __m512d sum1 = _mm512_setzero_pd();
+
+               for (std::size_t index = 0; index < count; index += 16)
+               {
+                  sum0 = _mm512_add_pd(sum0, _mm512_load_pd(a + index));
+                  sum1 = _mm512_add_pd(sum1, _mm512_load_pd(a + index + 8));
+               }
+
+               double lanes[8];
+
+               _mm512_storeu_pd(lanes, _mm512_add_pd(sum0, sum1));
+
+               _mm256_zeroupper();
+
+               return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+            }
+
+            case op_write:
+               if (non_temporal) for (std::size_t index = 0; index < count; index += 16) { _mm512_stream_pd(a + index, scalar); _mm512_stream_pd(a + index + 8, scalar); }
+               else for (std::size_t index = 0; index < count; index += 16) { _mm512_store_pd(a + index, scalar); _mm512_store_pd(a + index + 8, scalar); }
+               break;
+
+            case op_copy:
+               if (non_temporal) for (std::size_t index = 0; index < count; index += 16) { _mm512_stream_pd(a + index, _mm512_load_pd(b + index)); _mm512_stream_pd(a + index + 8, _mm512_load_pd(b + index + 8)); }
+               else for (std::size_t index = 0; index < count; index += 16) { _mm512_store_pd(a + index, _mm512_load_pd(b + index)); _mm512_store_pd(a + index + 8, _mm512_load_pd(b + index + 8)); }
+               break;
+
+            case op_triad:
+               for (std::size_t index = 0; index < count; index += 16)
+               {
+                  __m512d first = _mm512_add_pd(_mm512_load_pd(b + index), _mm512_mul_pd(scalar, _mm512_load_pd(c + index)));
+                  __m512d second = _mm512_add_pd(_mm512_load_pd(b + index + 8), _mm512_mul_pd(scalar, _mm512_load_pd(c + index + 8)));
+
+                  if (non_temporal) { _mm512_stream_pd(a + index, first); _mm512_stream_pd(a + index + 8, second); }
+                  else { _mm512_store_pd(a + index, first); _mm512_store_pd(a + index + 8, second); }
+               }
+               break;
+         }
+
+         if (non_temporal) _mm_sfence();
+
+         _mm256_zeroupper();
+
+         return 0;
+      }
+
+      #endif
+
+      void _print(const results& res) const
+      {
+         if (res.empty())
+         {
+            return;
+         }
+
+         // Columns in the order the results came, rows by kernel
+         std::vector<std::pair<std::size_t, std::size_t> > columns;
+         std::vector<std::size_t> rows;
+
+         for (std::size_t index = 0; index < res.size(); ++index)
+         {
+            std::pair<std::size_t, std::size_t> column(res[index].working_set, res[index].threads);
+
+            if (std::find(columns.begin(), columns.end(), column) == columns.end()) columns.push_back(column);
+
+            bool seen = false;
+
+            for (std::size_t row : rows)
+            {
+               seen = seen || (res[row].op == res[index].op && res[row].isa == res[index].isa && res[row].non_temporal == res[index].non_temporal);
+            }
+
+            if (!seen) rows.push_back(index);
+         }
+
+         bool by_threads = columns.size() > 1 && columns[0].first == columns[1].first;
+
+         if (by_threads) std::printf("GB/s, %s working set (%s), threads across\n", _size_name(columns[0].first).c_str(), _level(columns[0].first).c_str());
+         else std::printf("GB/s, %lu thread%s, working set across\n", (unsigned long)columns[0].second, columns[0].second == 1 ? "" : "s");
+
+         std::printf("%-18s", "kernel");
+
+         for (const std::pair<std::size_t, std::size_t>& column : columns)
+         {
+            std::string heading = by_threads ? std::to_string(column.second) : _size_name(column.first) + " " + _level(column.first);
+
+            std::printf(" %11s", heading.c_str());
+         }
+
+         std::printf("\n");
+
+         for (std::size_t row : rows)
+         {
+            std::string name = std::string(_operation_name(res[row].op)) + " " + _kernel_name(res[row].isa) + (res[row].non_temporal ? " nt" : "");
+
+            std::printf("%-18s", name.c_str());
+
+            for (const std::pair<std::size_t, std::size_t>& column : columns)
+            {
+               for (const result& current : res)
+               {
+                  if (current.op == res[row].op && current.isa == res[row].isa && current.non_temporal == res[row].non_temporal && current.working_set == column.first && current.threads == column.second)
+                  {
+                     std::printf(" %11.2f", current.gbytes());
+                  }
+               }
+            }
+
+            std::printf("\n");
+         }
+      }
+
+      static std::string _size_name(std::size_t bytes)
+      {
+         if (bytes >= 1024 * 1024 * 1024 && bytes % (1024 * 1024 * 1024) == 0) return std::to_string(bytes >> 30) + "G";
+         if (bytes >= 1024 * 1024 && bytes % (1024 * 1024) == 0) return std::to_string(bytes >> 20) + "M";
+         if (bytes >= 1024 && bytes % 1024 == 0) return std::to_string(bytes >> 10) + "K";
+
+         return std::to_string(bytes);
+      }
+
+   private: // Member Variables
+
+      topology _m_topology;
+
+      std::vector<std::size_t> _m_caches;
+      std::size_t _m_cpus;
+
+      std::size_t _m_sample_bytes;
+      std::size_t _m_repetitions;
+      placement _m_placement;
+
+}; // end of class(memory_bandwidth)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+} // end of namespace(ev9)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __MEMORY_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// end of memory.hpp
+////////////////////////////////////////////////////////////////////////////////
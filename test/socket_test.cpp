@@ -17,16 +17,97 @@
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+#include "async.hpp"
+#include "bandwidth.hpp"
+#include "buffer_pool.hpp"
+#include "crc32c.hpp"
+#include "framing.hpp"
+#include "histogram.hpp"
+#include "integrity.hpp"
+#include "latency.hpp"
+#include "local.hpp"
+#include "memory.hpp"
+#include "parallel.hpp"
+#include "pool.hpp"
+#include "reactor.hpp"
+#include "server.hpp"
 #include "socket.hpp"
 #include "test.hpp"
+#include "topology.hpp"
+#include "udp.hpp"
+#include "writer.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <thread>
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+// Runs the other half of a test. A throw on a bare std::thread, or a test
+// body that throws past a joinable one, terminates the whole suite; this
+// keeps the failure for join() to rethrow and joins when destroyed.
+class helper_thread
+{
+   public:  // Constructor | Destructor
+
+      explicit helper_thread(const std::function<void()>& function) : _m_thread(&helper_thread::_body, this, function) { }
+
+      ~helper_thread() { if (_m_thread.joinable()) _m_thread.join(); }
+
+   private: // Owns a running thread, not copyable
+
+      helper_thread(const helper_thread&);
+      helper_thread& operator=(const helper_thread&);
+
+   public:  // Public Member Functions
+
+      void join() { _join(); }
+
+   private: // Private Member Functions
+
+      void _body(std::function<void()> function)
+      {
+         try
+         {
+            function();
+         }
+
+         catch (...)
+         {
+            _m_failure = std::current_exception();
+         }
+      }
+
+      void _join()
+      {
+         _m_thread.join();
+
+         if (_m_failure)
+         {
+            std::rethrow_exception(_m_failure);
+         }
+      }
+
+   private: // Member Variables
+
+      // Before the thread, which may set it as soon as it starts
+      std::exception_ptr _m_failure;
+
+      std::thread _m_thread;
+
+}; // end of class(helper_thread)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void test_socket_ctor_dtor()
 {
    ev9::socket* socket;
@@ -72,14 +153,12 @@ void test_connect()
 {
    ev9::socket* socket;
    
-   // Sleep to allow the accept thread to finish.
-   std::this_thread::sleep_for(std::chrono::milliseconds(100));
-   
    try
    {
       socket = new ev9::socket(7000);
       
-      socket->connect();
+      // Retries until the accepting test is listening
+      socket->connect(5);
       
       delete socket;
    }
@@ -94,14 +173,11 @@ void test_connect_different_ip()
 {
    ev9::socket* socket;
    
-   // Sleep to allow the accept thread to finish.
-   std::this_thread::sleep_for(std::chrono::milliseconds(100));
-   
    try
    {
       socket = new ev9::socket("127.0.0.1", 7000);
       
-      socket->connect();
+      socket->connect(5);
       
       delete socket;
       
@@ -147,14 +223,11 @@ void test_write()
 {
    ev9::socket* socket;
    
-   // Sleep to allow the accept thread to finish.
-   std::this_thread::sleep_for(std::chrono::milliseconds(100));
-   
    try
    {
       socket = new ev9::socket(7001);
       
-      socket->connect();
+      socket->connect(5);
       
       socket->write("a");
       
@@ -171,9 +244,6 @@ void read_write_setup()
 {
    ev9::socket* socket;
    
-   // Sleep to allow the accept thread to finish.
-   std::this_thread::sleep_for(std::chrono::milliseconds(10));
-   
    try
    {
       socket = new ev9::socket(7002);
@@ -205,11 +275,9 @@ void test_read_write()
    {
       socket = new ev9::socket(7002);
       
-      std::thread connecting_thread(read_write_setup);
+      helper_thread connecting_thread(read_write_setup);
       
-      std::this_thread::sleep_for(std::chrono::milliseconds(50));
-      
-      socket->connect();
+      socket->connect(5);
       
       socket->write("a");
       
@@ -240,15 +308,2134 @@ void test_read_write()
    }
 }
 
-int main()
+void read_all_setup()
+{
+   ev9::socket socket(7004);
+
+   socket.connect(5);
+
+   std::string message(10000, 'z');
+
+   socket.write(message);
+
+   char reply[2];
+
+   if (socket.read_back_all(reply, sizeof(reply)) != sizeof(reply) || std::string(reply, sizeof(reply)) != "he")
+   {
+      throw std::runtime_error(TEST_INFORMATION + "reply does not start with he");
+   }
+
+   // A two byte buffer forces the vector read through several syscalls
+   socket.set_buffer_size(2);
+
+   std::vector<char> rest;
+
+   socket.read_back(rest);
+
+   if (std::string(rest.begin(), rest.end()) != "llo")
+   {
+      throw std::runtime_error(TEST_INFORMATION + "reply does not end with llo");
+   }
+}
+
+void test_read_all()
+{
+   try
+   {
+      ev9::socket socket(7004);
+
+      socket.bind();
+      socket.listen();
+
+      helper_thread connecting_thread(read_all_setup);
+
+      socket.accept();
+
+      std::vector<char> input(10000);
+
+      if (socket.read_all(&input[0], input.size()) != input.size() || input.back() != 'z')
+      {
+         throw std::runtime_error("did not read the whole message");
+      }
+
+      socket.write_back("hello");
+
+      connecting_thread.join();
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_bandwidth_byte_count()
+{
+   try
+   {
+      ev9::bandwidth receiver(7003, 64 * 1024);
+      ev9::bandwidth sender(7003, 64 * 1024);
+
+      sender.set_byte_count(1024 * 1024 + 17);
+
+      ev9::bandwidth::result received;
+
+      receiver.listen();
+
+      helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+      ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+      receiving_thread.join();
+
+      if (sent.bytes != 1024 * 1024 + 17 || received.bytes != sent.bytes)
+      {
+         throw std::runtime_error("byte counts do not match");
+      }
+
+      if (received.syscalls == 0 || received.intervals.empty())
+      {
+         throw std::runtime_error("no syscalls or intervals recorded");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_bandwidth_send_modes()
+{
+   try
+   {
+      const ev9::bandwidth::send_mode modes[] = { ev9::bandwidth::mode_sendfile, ev9::bandwidth::mode_zerocopy };
+
+      ev9::bandwidth receiver(7005, 64 * 1024);
+
+      receiver.listen();
+
+      // One listener serves both senders in turn
+      for (ev9::bandwidth::send_mode mode : modes)
+      {
+         ev9::bandwidth sender(7005, 64 * 1024);
+
+         sender.set_byte_count(3 * 64 * 1024 + 5);
+         sender.set_send_mode(mode);
+
+         ev9::bandwidth::result received;
+
+         helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+         ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+         receiving_thread.join();
+
+         if (sent.bytes != 3 * 64 * 1024 + 5 || received.bytes != sent.bytes)
+         {
+            throw std::runtime_error(std::string(ev9::bandwidth::mode_name(mode)) + " byte counts do not match");
+         }
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_parallel_streams()
+{
+   try
+   {
+      // Streams use ports 7010 through 7012
+      ev9::parallel_bandwidth receiver(7010, 3, 64 * 1024);
+      ev9::parallel_bandwidth sender(7010, 3, 64 * 1024);
+
+      sender.set_byte_count(512 * 1024);
+
+      ev9::parallel_bandwidth::results received;
+
+      receiver.listen();
+
+      helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+      ev9::parallel_bandwidth::results sent = sender.send("127.0.0.1");
+
+      receiving_thread.join();
+
+      if (sent.size() != 3 || ev9::parallel_bandwidth::aggregate(sent).bytes != 3 * 512 * 1024 || ev9::parallel_bandwidth::aggregate(received).bytes != 3 * 512 * 1024)
+      {
+         throw std::runtime_error("aggregate byte counts do not match");
+      }
+
+      double fairness = ev9::parallel_bandwidth::fairness(sent);
+
+      if (fairness <= 0 || fairness > 1.0000001)
+      {
+         throw std::runtime_error("fairness index out of range");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_histogram_percentiles()
+{
+   ev9::histogram samples(1000000, 3);
+
+   for (std::uint64_t value = 1; value <= 10000; ++value)
+   {
+      samples.record(value);
+   }
+
+   samples.record(5000000);
+
+   std::uint64_t median = samples.percentile(50);
+   std::uint64_t tail = samples.percentile(99.9);
+
+   // Three significant digits: within 0.1% of the exact answer
+   if (median < 4995 || median > 5006 || tail < 9985 || tail > 10011)
+   {
+      throw std::runtime_error(TEST_INFORMATION + "percentiles outside the histogram's precision");
+   }
+
+   if (samples.count() != 10001 || samples.min() != 1 || samples.max() != 1000000 || samples.overflow() != 1)
+   {
+      throw std::runtime_error(TEST_INFORMATION + "count, min, max or overflow is wrong");
+   }
+
+   ev9::histogram other(1000000, 3);
+
+   other.record(20000, 10001);
+   other.merge(samples);
+
+   if (other.count() != 20002 || other.percentile(100) != 1000000 || other.percentile(25) > 5006)
+   {
+      throw std::runtime_error(TEST_INFORMATION + "merged histogram is wrong");
+   }
+}
+
+void test_latency_ping_pong()
+{
+   try
+   {
+      ev9::latency server(7013);
+      ev9::latency client(7013, 3000);
+
+      client.set_warmup(10);
+      client.set_iterations(200);
+
+      server.listen();
+
+      std::size_t round_trips = 0;
+
+      helper_thread serving_thread([&]() { round_trips = server.serve(); });
+
+      const ev9::histogram& samples = client.ping("127.0.0.1");
+
+      serving_thread.join();
+
+      if (samples.count() != 200 || round_trips != 210 || samples.min() == 0 || samples.percentile(50) > samples.max())
+      {
+         throw std::runtime_error("round trips were not all recorded");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void scatter_gather_setup()
+{
+   ev9::socket socket(7007);
+
+   socket.connect(5);
+
+   // Large enough that writev completes partially against a socket buffer
+   std::string header = "header";
+   std::string body(6 * 1024 * 1024, 'b');
+
+   ev9::socket::segment segments[3];
+
+   segments[0].iov_base = &header[0];
+   segments[0].iov_len = header.size();
+   segments[1].iov_base = nullptr;
+   segments[1].iov_len = 0;
+   segments[2].iov_base = &body[0];
+   segments[2].iov_len = body.size();
+
+   if (socket.write(segments, 3) != header.size() + body.size())
+   {
+      throw std::runtime_error(TEST_INFORMATION + "short vectored write");
+   }
+}
+
+void test_scatter_gather()
+{
+   try
+   {
+      ev9::socket socket(7007);
+
+      socket.bind();
+      socket.listen();
+
+      helper_thread connecting_thread(scatter_gather_setup);
+
+      socket.accept();
+
+      std::vector<char> first(4);
+      std::vector<char> second(6 * 1024 * 1024 + 2);
+
+      ev9::socket::segment segments[2];
+
+      segments[0].iov_base = &first[0];
+      segments[0].iov_len = first.size();
+      segments[1].iov_base = &second[0];
+      segments[1].iov_len = second.size();
+
+      std::size_t amount_read = socket.read(segments, 2);
+
+      connecting_thread.join();
+
+      if (amount_read != first.size() + second.size())
+      {
+         throw std::runtime_error("short vectored read");
+      }
+
+      if (std::string(first.begin(), first.end()) != "head" || second[0] != 'e' || second[1] != 'r' || second[2] != 'b' || second.back() != 'b')
+      {
+         throw std::runtime_error("vectored read split the stream wrongly");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void uring_client()
+{
+   ev9::socket socket(7009);
+
+   socket.connect(5);
+   socket.use_uring();
+
+   std::vector<char> payload(1024 * 1024);
+
+   for (std::size_t index = 0; index < payload.size(); ++index)
+   {
+      payload[index] = (char)(index * 7);
+   }
+
+   // Writes from the registered buffer go out as WRITE_FIXED
+   socket.register_buffer(&payload[0], payload.size());
+
+   for (std::size_t offset = 0; offset < payload.size(); )
+   {
+      offset += socket.write(&payload[offset], payload.size() - offset);
+   }
+
+   std::string hello = "hello ";
+   std::string world = "world";
+
+   std::vector<ev9::socket::segment> segments(2);
+
+   segments[0].iov_base = &hello[0];
+   segments[0].iov_len = hello.size();
+   segments[1].iov_base = &world[0];
+   segments[1].iov_len = world.size();
+
+   if (socket.write(segments) != 11)
+   {
+      throw std::runtime_error(TEST_INFORMATION + "short vectored write");
+   }
+
+   char reply[5];
+
+   if (socket.read_back_all(reply, sizeof(reply)) != sizeof(reply) || std::string(reply, sizeof(reply)) != "pong!")
+   {
+      throw std::runtime_error(TEST_INFORMATION + "wrong reply");
+   }
+}
+
+void test_uring_backend()
 {
-   ev9::test socket_test(0);
+   try
+   {
+      ev9::socket server(7009);
+
+      server.bind();
+      server.listen();
+
+      // Without io_uring this runs the same checks on the classic calls
+      bool uring = server.use_uring();
+
+      helper_thread client_thread(uring_client);
+
+      server.accept();
+
+      std::vector<char> received(1024 * 1024 + 11);
+
+      std::size_t amount_read = server.read_all(&received[0], received.size());
+
+      server.write_back("pong!", 5);
+
+      char end;
+
+      bool closed = server.read(&end, 1) == 0;
+
+      client_thread.join();
+
+      server.close_accepted();
+
+      if (amount_read != received.size() || !closed)
+      {
+         throw std::runtime_error("short read through the backend");
+      }
+
+      for (std::size_t index = 0; index < 1024 * 1024; ++index)
+      {
+         if (received[index] != (char)(index * 7))
+         {
+            throw std::runtime_error("payload corrupted through the backend");
+         }
+      }
+
+      if (std::string(received.end() - 11, received.end()) != "hello world")
+      {
+         throw std::runtime_error("vectored write reordered");
+      }
+
+      if (uring != server.uring_enabled() || (uring && server.ring_enters() == 0))
+      {
+         throw std::runtime_error("backend not in use");
+      }
+
+      // The listener is still armed for a second connection
+      helper_thread second_client([]()
+      {
+         ev9::socket socket(7009);
+
+         socket.connect();
+         socket.write("again", 5);
+      });
+
+      server.accept();
+
+      char again[5];
+
+      amount_read = server.read_all(again, sizeof(again));
+
+      second_client.join();
+
+      if (amount_read != sizeof(again) || std::string(again, sizeof(again)) != "again")
+      {
+         throw std::runtime_error("second connection not served");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_udp_datagrams()
+{
+   try
+   {
+      ev9::socket receiver(7014, ev9::socket::protocol_udp);
+
+      receiver.bind();
+
+      ev9::socket sender(std::string("127.0.0.1"), 7014, ev9::socket::protocol_udp);
+
+      sender.connect();
+
+      std::string first(10, 'a');
+      std::string second(20, 'b');
+      std::string third(30, 'c');
+
+      ev9::socket::segment datagrams[3];
+
+      datagrams[0].iov_base = &first[0];
+      datagrams[0].iov_len = first.size();
+      datagrams[1].iov_base = &second[0];
+      datagrams[1].iov_len = second.size();
+      datagrams[2].iov_base = &third[0];
+      datagrams[2].iov_len = third.size();
+
+      if (sender.write_datagrams(datagrams, 3) != 3 || sender.datagram_calls() != 1)
+      {
+         throw std::runtime_error("datagrams were not sent in one batch");
+      }
+
+      std::vector<char> memory(4 * 64);
+      std::vector<ev9::socket::segment> buffers(4);
+
+      std::size_t sizes[4];
+
+      for (std::size_t index = 0; index < buffers.size(); ++index)
+      {
+         buffers[index].iov_base = &memory[index * 64];
+         buffers[index].iov_len = 64;
+      }
+
+      receiver.set_receive_timeout(1);
+
+      std::size_t received = 0;
+
+      while (received < 3)
+      {
+         std::size_t count = receiver.read_datagrams(&buffers[received], buffers.size() - received, &sizes[received]);
+
+         if (count == 0)
+         {
+            throw std::runtime_error("datagrams did not arrive");
+         }
+
+         received += count;
+      }
+
+      if (sizes[0] != 10 || sizes[1] != 20 || sizes[2] != 30 || memory[0] != 'a' || memory[64] != 'b' || memory[128 + 29] != 'c')
+      {
+         throw std::runtime_error("datagram boundaries were not kept");
+      }
+
+      // Nothing else is queued, so the receive timeout ends the next read
+      receiver.set_receive_timeout(0.05);
+
+      if (receiver.read_datagrams(buffers.data(), buffers.size(), sizes) != 0)
+      {
+         throw std::runtime_error("unexpected datagram");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_udp_bandwidth()
+{
+   try
+   {
+      ev9::udp_bandwidth receiver(7015);
+      ev9::udp_bandwidth sender(7015, 1000);
+
+      // Slow enough that a loopback receiver keeps up
+      sender.set_byte_count(200 * 1000);
+      sender.set_rate(50e6);
+
+      receiver.listen();
+
+      ev9::udp_bandwidth::result received;
+
+      helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+      ev9::udp_bandwidth::result sent = sender.send("127.0.0.1");
+
+      receiving_thread.join();
+
+      if (sent.packets != 200 || received.packets == 0 || received.packets + received.lost != 200)
+      {
+         throw std::runtime_error("packets were not accounted for");
+      }
+
+      if (received.bytes != received.packets * 1000 || received.jitter < 0)
+      {
+         throw std::runtime_error("receiver statistics are inconsistent");
+      }
+
+      #if __linux__
+         // Rate limited batches arrive apart, so the jitter has samples
+         if (!received.kernel_timestamps || received.jitter <= 0)
+         {
+            throw std::runtime_error("jitter did not come from kernel receive times");
+         }
+      #endif
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_tester_batches()
+{
+   try
+   {
+      ev9::tester pool(4);
+
+      std::atomic<std::size_t> calls(0);
+
+      for (std::size_t run = 0; run < 50; ++run)
+      {
+         for (std::size_t index = 0; index < 8; ++index)
+         {
+            pool.run([&calls]() { ++calls; });
+         }
+
+         pool.run([]() { throw std::runtime_error("expected failure"); });
+
+         if (pool.run_tests(false) != 1)
+         {
+            throw std::runtime_error("failure was not reported for the batch");
+         }
+      }
+
+      if (calls != 50 * 8)
+      {
+         throw std::runtime_error("tests were lost between batches");
+      }
+
+      if (pool.threads_started() != 4)
+      {
+         throw std::runtime_error("worker threads were started more than once");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_benchmark_statistics()
+{
+   try
+   {
+      double values[] = { 5, 1, 4, 2, 3 };
+
+      ev9::benchmark::result summary = ev9::benchmark::summarize("known", std::vector<double>(values, values + 5));
+
+      if (summary.mean != 3 || summary.median != 3 || summary.min != 1)
+      {
+         throw std::runtime_error("mean, median or min is wrong");
+      }
+
+      // Sample deviation sqrt(2.5), t = 2.776 for four degrees of freedom
+      if (std::fabs(summary.stddev - 1.5811) > 1e-3 || std::fabs(summary.confidence - 1.9630) > 1e-3)
+      {
+         throw std::runtime_error("stddev or confidence interval is wrong");
+      }
+
+      ev9::test suite(2);
+
+      std::size_t calls = 0;
+
+      suite.add_benchmark("counter", [&calls]() { ++calls; }, 10, 2);
+      suite.add_benchmark("throws", []() { throw std::runtime_error("expected failure"); });
+
+      if (suite.run_tests(false) != 1)
+      {
+         throw std::runtime_error("benchmark failure was not reported");
+      }
+
+      const std::vector<ev9::benchmark::result>& results = suite.benchmark_results();
+
+      if (results.size() != 1 || results[0].iterations != 10 || results[0].calls_per_sample == 0)
+      {
+         throw std::runtime_error("benchmark did not record its samples");
+      }
+
+      if (calls < 10 * results[0].calls_per_sample || results[0].min <= 0 || results[0].min > results[0].median)
+      {
+         throw std::runtime_error("benchmark samples are inconsistent");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_tester_timeout()
+{
+   try
+   {
+      ev9::test suite(2);
+
+      std::atomic<std::size_t> calls(0);
+
+      // Outlives the tester: the abandoned thread is still sleeping
+      suite.add_test("hangs", []() { std::this_thread::sleep_for(std::chrono::seconds(2)); }, 0.05);
+
+      for (std::size_t index = 0; index < 6; ++index)
+      {
+         suite.add_test("quick", [&calls]() { ++calls; });
+      }
+
+      auto start = std::chrono::steady_clock::now();
+
+      std::size_t failed = suite.run_tests(false);
+
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      if (failed != 1 || calls != 6)
+      {
+         throw std::runtime_error("timed out test was not failed on its own");
+      }
+
+      if (elapsed.count() > 1)
+      {
+         throw std::runtime_error("run waited for the hung test");
+      }
+
+      const std::vector<ev9::tester::timing>& timings = suite.test_timings();
+
+      if (timings.size() != 7 || timings[0].name != "hangs" || !timings[0].timed_out || timings[0].seconds < 0.05)
+      {
+         throw std::runtime_error("timed out test is not the slowest");
+      }
+
+      if (suite.threads_started() != 3)
+      {
+         throw std::runtime_error("stuck worker was not replaced");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_socket_options()
+{
+   try
+   {
+      ev9::socket::options opts;
+
+      opts.send_buffer = 256 * 1024;
+      opts.receive_buffer = 128 * 1024;
+      opts.no_delay = true;
+
+      std::vector<std::string> congestion = ev9::socket::congestion_controls();
+
+      if (!congestion.empty()) opts.congestion = congestion.back();
+
+      ev9::socket server(7016);
+
+      server.set_options(opts);
+      server.bind();
+      server.listen();
+
+      helper_thread client_thread([&opts]()
+      {
+         ev9::socket client(7016);
+
+         client.set_options(opts);
+         client.connect();
+
+         char byte = 0;
+
+         client.read_back(&byte, 1);
+      });
+
+      server.accept();
+
+      // Linux doubles buffer sizes for bookkeeping; others keep them
+      ev9::socket::options effective = server.effective_options();
+
+      server.write_back("x");
+
+      client_thread.join();
+
+      if (!effective.no_delay)
+      {
+         throw std::runtime_error("TCP_NODELAY did not reach the accepted connection");
+      }
+
+      if (effective.send_buffer < opts.send_buffer || effective.receive_buffer < opts.receive_buffer)
+      {
+         throw std::runtime_error("buffer sizes were not applied");
+      }
+
+      if (!opts.congestion.empty() && effective.congestion != opts.congestion)
+      {
+         throw std::runtime_error("congestion control was not applied");
+      }
+
+      ev9::socket::options refused;
+
+      refused.congestion = "no-such-algorithm";
+
+      bool threw = false;
+
+      try
+      {
+         ev9::socket(7017).set_options(refused);
+      }
+
+      catch (std::runtime_error&)
+      {
+         threw = true;
+      }
+
+      if (!threw)
+      {
+         throw std::runtime_error("an unknown congestion control was accepted");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_framing()
+{
+   try
+   {
+      ev9::socket server(7018);
+
+      server.bind();
+      server.listen();
+
+      // Zero length, odd sizes that straddle reads, and one frame larger
+      // than the reader's buffer
+      std::vector<std::size_t> sizes;
+
+      for (std::size_t index = 0; index < 2000; ++index)
+      {
+         sizes.push_back(index % 97);
+      }
+
+      sizes.push_back(300 * 1024);
+      sizes.push_back(5);
+
+      helper_thread client_thread([&sizes]()
+      {
+         ev9::socket client(7018);
+
+         client.connect();
+
+         ev9::frame_writer writer(client);
+
+         std::vector<char> payload(300 * 1024);
+
+         for (std::size_t size : sizes)
+         {
+            for (std::size_t index = 0; index < size; ++index)
+            {
+               payload[index] = (char)(size + index);
+            }
+
+            writer.write(payload.data(), size);
+         }
+
+         // Announces more than the reader's limit
+         char header[ev9::frame_header_size];
+
+         ev9::encode_frame_header(header, 1024 * 1024);
+
+         client.write(header, sizeof(header));
+      });
+
+      server.accept();
+
+      ev9::frame_reader reader(server, ev9::side_accepted, 4096, 512 * 1024);
+      ev9::frame_reader::frame current;
+
+      for (std::size_t size : sizes)
+      {
+         if (!reader.next(current) || current.size != size)
+         {
+            throw std::runtime_error("frame boundaries were lost");
+         }
+
+         for (std::size_t index = 0; index < size; ++index)
+         {
+            if (current.data[index] != (char)(size + index))
+            {
+               throw std::runtime_error("frame payload was corrupted");
+            }
+         }
+      }
+
+      bool threw = false;
+
+      try
+      {
+         reader.next(current);
+      }
+
+      catch (std::runtime_error&)
+      {
+         threw = true;
+      }
+
+      client_thread.join();
+
+      if (!threw)
+      {
+         throw std::runtime_error("an oversized frame was accepted");
+      }
+
+      if (reader.reads() >= reader.frames())
+      {
+         throw std::runtime_error("small frames were not batched into shared reads");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_buffered_writer()
+{
+   try
+   {
+      ev9::socket server(7019);
+
+      server.bind();
+      server.listen();
+
+      std::string failure;
+
+      helper_thread client_thread([&failure]()
+      {
+         ev9::socket client(7019);
+
+         client.connect();
+
+         ev9::buffered_writer::policy policy;
+
+         policy.threshold = 4096;
+         policy.max_delay = 0.001;
+
+         ev9::buffered_writer writer(client, ev9::side_connected, policy);
+
+         for (std::size_t index = 0; index < 1000; ++index)
+         {
+            writer.write_frame("0123456789", 10);
+         }
+
+         // Larger than the buffer, sent behind what is already buffered
+         std::vector<char> large(10000, 'L');
+
+         writer.write_frame(large.data(), large.size());
+
+         if (writer.buffered() != 0)
+         {
+            failure = "an oversized write left bytes behind";
+         }
+
+         writer.write_frame("tail", 4);
+
+         std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+         if (!writer.flush_if_due() || writer.buffered() != 0)
+         {
+            failure = "the delay threshold did not flush";
+         }
+
+         if (writer.writes_per_syscall() < 10)
+         {
+            failure = "small writes were not coalesced";
+         }
+      });
+
+      server.accept();
+
+      ev9::frame_reader reader(server);
+      ev9::frame_reader::frame current;
+
+      for (std::size_t index = 0; index < 1000; ++index)
+      {
+         if (!reader.next(current) || current.str() != "0123456789")
+         {
+            throw std::runtime_error("coalesced frames were corrupted");
+         }
+      }
+
+      if (!reader.next(current) || current.size != 10000 || current.data[9999] != 'L')
+      {
+         throw std::runtime_error("the oversized frame was corrupted");
+      }
+
+      if (!reader.next(current) || current.str() != "tail" || reader.next(current))
+      {
+         throw std::runtime_error("the delayed frame was lost");
+      }
+
+      client_thread.join();
+
+      if (!failure.empty())
+      {
+         throw std::runtime_error(failure);
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_connect_timeout()
+{
+   try
+   {
+      // Nothing listens yet: refused attempts are retried until it does
+      helper_thread listening_thread([]()
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+         ev9::socket server(7021);
+
+         server.bind();
+         server.listen();
+         server.accept();
+      });
+
+      ev9::socket client(7021);
+
+      client.connect(5);
+
+      listening_thread.join();
+
+      bool threw = false;
+
+      auto start = std::chrono::steady_clock::now();
+
+      try
+      {
+         ev9::socket(7022).connect(0.1);
+      }
+
+      catch (std::runtime_error&)
+      {
+         threw = true;
+      }
+
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      if (!threw || elapsed.count() < 0.05 || elapsed.count() > 2)
+      {
+         throw std::runtime_error("connect did not give up at its deadline");
+      }
+
+      // A full accept queue drops the handshake, so the attempt itself runs
+      // out of time; the socket has to be left blocking as it was
+      ev9::socket full(7035);
+
+      full.bind();
+      full.listen(0);
+
+      ev9::socket queued("127.0.0.1", 7035);
+      ev9::socket late("127.0.0.1", 7035);
+
+      queued.connect(1);
+
+      threw = false;
+
+      try
+      {
+         late.connect(0.05);
+      }
+
+      catch (std::runtime_error&)
+      {
+         threw = true;
+      }
+
+      if (!threw || (::fcntl(late.native_handle(), F_GETFL, 0) & O_NONBLOCK) != 0)
+      {
+         throw std::runtime_error("a timed out connect left the socket non-blocking");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_connection_pool()
+{
+   try
+   {
+      ev9::socket server(7020);
+
+      server.bind();
+      server.listen();
+
+      std::atomic<bool> closed(false);
+      std::string failure;
+
+      helper_thread client_thread([&closed, &failure]()
+      {
+         ev9::connection_pool pool;
+
+         char reply = 0;
+
+         for (int index = 0; index < 3; ++index)
+         {
+            if (index == 2)
+            {
+               // The server hangs up on the idle connection
+               while (!closed) std::this_thread::yield();
+
+               std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            ev9::connection_pool::lease connection = pool.acquire("127.0.0.1", 7020);
+
+            connection->write("p");
+
+            if (connection->read_back_all(&reply, 1) != 1 || reply != 'q')
+            {
+               failure = "no reply over the pooled connection";
+            }
+
+            connection.release();
+         }
+
+         if (pool.hits() != 1 || pool.misses() != 2 || pool.stale() != 1 || pool.idle() != 1)
+         {
+            failure = "the pool did not reuse exactly the warm connection";
+         }
+      });
+
+      // Two requests on the first connection, one on its replacement
+      for (int connection = 0; connection < 2; ++connection)
+      {
+         server.accept();
+
+         for (int request = 0; request < 2 - connection; ++request)
+         {
+            char byte = 0;
+
+            if (server.read_all(&byte, 1) != 1 || byte != 'p')
+            {
+               throw std::runtime_error("a request did not arrive on the expected connection");
+            }
+
+            server.write_back("q");
+         }
+
+         server.close_accepted();
+
+         closed = true;
+      }
+
+      client_thread.join();
+
+      if (!failure.empty())
+      {
+         throw std::runtime_error(failure);
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_pooled_runs()
+{
+   try
+   {
+      ev9::connection_pool pool;
+
+      ev9::bandwidth receiver(7033, 5000);
+      ev9::bandwidth sender(7033, 5000);
+
+      receiver.set_framed_runs(true);
+      receiver.set_verify(true);
+      sender.set_connection_pool(&pool);
+      sender.set_verify(true);
+
+      // Not a whole number of bursts, so each run ends on a short one
+      sender.set_byte_count(100 * 5000 + 5);
+
+      std::vector<ev9::bandwidth::result> received(3);
+
+      receiver.listen();
+
+      helper_thread receiving_thread([&]()
+      {
+         for (ev9::bandwidth::result& res : received) res = receiver.receive();
+      });
+
+      for (std::size_t run = 0; run < received.size(); ++run)
+      {
+         ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+         if (sent.bytes != 100 * 5000 + 5 || sent.chunks != 101)
+         {
+            throw std::runtime_error("a pooled run sent the wrong amount");
+         }
+      }
+
+      receiving_thread.join();
+
+      for (const ev9::bandwidth::result& res : received)
+      {
+         if (res.bytes != 100 * 5000 + 5 || res.chunks != 101 || res.bad_chunks != 0)
+         {
+            throw std::runtime_error("a framed run arrived damaged");
+         }
+      }
+
+      if (pool.misses() != 1 || pool.hits() != 2 || !receiver.connection_held())
+      {
+         throw std::runtime_error("the runs did not share one connection");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_interrupted_receivers()
+{
+   try
+   {
+      ev9::bandwidth receiver(7034);
+      ev9::udp_bandwidth datagrams(7034);
+
+      receiver.listen();
+      datagrams.listen();
+
+      bool refused = false;
+
+      helper_thread receiving_thread([&]()
+      {
+         try
+         {
+            receiver.receive();
+         }
+
+         catch (std::runtime_error&)
+         {
+            refused = true;
+         }
+      });
+
+      ev9::udp_bandwidth::result empty;
+
+      empty.packets = 1;
+
+      helper_thread datagram_thread([&]() { empty = datagrams.receive(); });
+
+      // Neither has a sender; both have to come back once interrupted
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+      receiver.interrupt();
+      datagrams.interrupt();
+
+      receiving_thread.join();
+      datagram_thread.join();
+
+      if (!refused || empty.packets != 0)
+      {
+         throw std::runtime_error("an interrupted receiver did not give up");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_sharded_server()
+{
+   try
+   {
+      ev9::sharded_server server(7023, 2, 64);
+
+      server.start([](ev9::socket& connection, std::size_t)
+      {
+         char byte = 0;
+
+         if (connection.read_all(&byte, 1) == 1) connection.write_back("k");
+      });
+
+      std::vector<std::unique_ptr<helper_thread> > clients;
+      std::atomic<std::size_t> replies(0);
+
+      for (int index = 0; index < 4; ++index)
+      {
+         clients.push_back(std::unique_ptr<helper_thread>(new helper_thread([&replies]()
+         {
+            for (int request = 0; request < 5; ++request)
+            {
+               ev9::socket client(7023);
+
+               client.connect(5);
+               client.write("p");
+
+               char reply = 0;
+
+               if (client.read_back_all(&reply, 1) == 1 && reply == 'k') ++replies;
+            }
+         })));
+      }
+
+      for (std::unique_ptr<helper_thread>& client : clients)
+      {
+         client->join();
+      }
+
+      server.stop();
+
+      if (replies != 20 || server.accepted() != 20 || server.accepted(0) + server.accepted(1) != 20 || server.failed() != 0)
+      {
+         throw std::runtime_error("the shards did not serve every connection");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_topology_placement()
+{
+   try
+   {
+      ev9::topology layout;
+
+      std::size_t count = layout.cpus().size();
+
+      if (count == 0 || layout.nodes().empty() || layout.cores() == 0 || layout.cores() > count)
+      {
+         throw std::runtime_error("no CPUs, cores or nodes discovered");
+      }
+
+      // One thread per CPU visits every CPU exactly once
+      for (ev9::placement policy : { ev9::placement_compact, ev9::placement_scatter })
+      {
+         ev9::topology::plan plan = layout.place(policy, count);
+
+         std::vector<int> used;
+
+         for (const ev9::topology::cpu_set& set : plan)
+         {
+            if (set.size() != 1 || layout.node_of(set[0]) < 0) throw std::runtime_error(std::string(ev9::placement_name(policy)) + " placed a thread badly");
+
+            used.push_back(set[0]);
+         }
+
+         std::sort(used.begin(), used.end());
+
+         if (std::unique(used.begin(), used.end()) != used.end())
+         {
+            throw std::runtime_error(std::string(ev9::placement_name(policy)) + " placed two threads on one CPU");
+         }
+      }
+
+      ev9::topology::plan by_node = layout.place(ev9::placement_node, 3);
+
+      for (std::size_t thread = 0; thread < by_node.size(); ++thread)
+      {
+         int node = layout.nodes()[thread % layout.nodes().size()];
+
+         for (int cpu : by_node[thread])
+         {
+            if (layout.node_of(cpu) != node) throw std::runtime_error("node placement crossed nodes");
+         }
+      }
+
+      if (!layout.place(ev9::placement_none, 2)[0].empty() || layout.describe(ev9::placement_none, layout.place(ev9::placement_none, 2)) != "none")
+      {
+         throw std::runtime_error("placement none pinned a thread");
+      }
+
+      ev9::node_buffer buffer(1024 * 1024, layout.nodes()[0]);
+
+      if (buffer.size() != 1024 * 1024 || buffer[0] != 0 || buffer[buffer.size() - 1] != 0)
+      {
+         throw std::runtime_error("node buffer was not allocated zeroed");
+      }
+
+      if (buffer.bound() && buffer.resident_node() != layout.nodes()[0])
+      {
+         throw std::runtime_error("node buffer is not on its node");
+      }
+
+      // Streams use ports 7024 and 7025 and report where they ran
+      ev9::parallel_bandwidth receiver(7024, 2, 64 * 1024);
+      ev9::parallel_bandwidth sender(7024, 2, 64 * 1024);
+
+      sender.set_byte_count(256 * 1024);
+      sender.set_placement(ev9::placement_compact);
+      receiver.set_placement(ev9::placement_compact);
+
+      ev9::parallel_bandwidth::results received;
+
+      receiver.listen();
+
+      helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+      ev9::parallel_bandwidth::results sent = sender.send("127.0.0.1");
+
+      receiving_thread.join();
+
+      ev9::topology::plan plan = layout.place(ev9::placement_compact, 2);
+
+      for (std::size_t index = 0; index < sent.size(); ++index)
+      {
+         if (sent[index].bytes != 256 * 1024 || received[index].bytes != 256 * 1024)
+         {
+            throw std::runtime_error("placed streams lost bytes");
+         }
+
+         if (sent[index].cpu >= 0 && sent[index].cpu != plan[index][0])
+         {
+            throw std::runtime_error("stream " + std::to_string(index) + " ran off its CPU");
+         }
+      }
+
+      if (sender.placement_description().compare(0, 13, "compact cpus ") != 0)
+      {
+         throw std::runtime_error("placement missing from the description");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_local_transports()
+{
+   try
+   {
+      const ev9::transport_kind kinds[] = { ev9::transport_unix, ev9::transport_unix_datagram, ev9::transport_shm };
+
+      for (ev9::transport_kind kind : kinds)
+      {
+         std::string name = ev9::transport_kind_name(kind);
+
+         // Odd sizes, so shm wraps around its ring mid-write
+         {
+            std::unique_ptr<ev9::transport> server(ev9::make_local_transport(kind, 7026));
+            std::unique_ptr<ev9::transport> client(ev9::make_local_transport(kind, 7026));
+
+            server->bind();
+            server->listen(1);
+
+            std::vector<char> sent(3 * 1024 * 1024 + 7);
+
+            for (std::size_t index = 0; index < sent.size(); ++index) sent[index] = (char)(index * 31 + 7);
+
+            std::vector<char> received(sent.size());
+
+            std::size_t received_bytes = 0;
+
+            helper_thread serving_thread([&]()
+            {
+               server->accept();
+
+               received_bytes = server->read_all(&received[0], received.size());
+
+               server->write_back("done", 4);
+               server->close_accepted();
+            });
+
+            client->connect(5);
+
+            for (std::size_t offset = 0; offset < sent.size(); )
+            {
+               offset += client->write(&sent[offset], std::min<std::size_t>(sent.size() - offset, 40000));
+            }
+
+            char answer[4];
+
+            if (client->read_back_all(answer, sizeof(answer)) != 4 || std::memcmp(answer, "done", 4) != 0)
+            {
+               throw std::runtime_error(name + " lost the answer");
+            }
+
+            client->close();
+            serving_thread.join();
+            server->close();
+
+            if (received_bytes != sent.size() || received != sent)
+            {
+               throw std::runtime_error(name + " corrupted the stream");
+            }
+         }
+
+         // The bandwidth copy mode and latency run over it unchanged; the
+         // receiver keeps listening until it goes, so each gets its own port
+         ev9::bandwidth receiver(7027, 5000);
+         ev9::bandwidth sender(7027, 5000);
+
+         receiver.set_transport(kind);
+         sender.set_transport(kind);
+         sender.set_byte_count(1024 * 1024 + 3);
+
+         ev9::bandwidth::result received;
+
+         receiver.listen();
+
+         helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+         ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+         receiving_thread.join();
+
+         if (sent.bytes != 1024 * 1024 + 3 || received.bytes != sent.bytes || sent.transport != kind)
+         {
+            throw std::runtime_error(name + " bandwidth lost bytes");
+         }
+
+         ev9::latency server(7028);
+         ev9::latency client(7028, 3000);
+
+         server.set_transport(kind);
+         client.set_transport(kind);
+         client.set_warmup(10);
+         client.set_iterations(100);
+
+         server.listen();
+
+         std::size_t round_trips = 0;
+
+         helper_thread serving_thread([&]() { round_trips = server.serve(); });
+
+         const ev9::histogram& samples = client.ping("127.0.0.1");
+
+         serving_thread.join();
+
+         if (samples.count() != 100 || round_trips != 110)
+         {
+            throw std::runtime_error(name + " round trips were not all recorded");
+         }
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_memory_kernels()
+{
+   try
+   {
+      const ev9::memory_bandwidth::operation operations[] = { ev9::memory_bandwidth::op_read, ev9::memory_bandwidth::op_write, ev9::memory_bandwidth::op_copy, ev9::memory_bandwidth::op_triad };
+
+      std::vector<ev9::memory_bandwidth::kernel> kernels = ev9::memory_bandwidth::kernels();
+
+      if (kernels.empty() || kernels[0] != ev9::memory_bandwidth::kernel_scalar)
+      {
+         throw std::runtime_error("the scalar kernel is always supported");
+      }
+
+      // Every kernel computes the same thing, streamed or not
+      const std::size_t count = 48;
+
+      for (ev9::memory_bandwidth::kernel isa : kernels)
+      {
+         for (ev9::memory_bandwidth::operation op : operations)
+         {
+            for (bool non_temporal : { false, true })
+            {
+               std::string name = std::string(ev9::memory_bandwidth::operation_name(op)) + " " + ev9::memory_bandwidth::kernel_name(isa) + (non_temporal ? " nt" : "");
+
+               ev9::node_buffer memory(3 * count * sizeof(double));
+
+               double* a = (double*)memory.data();
+               double* b = a + count;
+               double* c = b + count;
+
+               for (std::size_t index = 0; index < count; ++index)
+               {
+                  a[index] = (double)index;
+                  b[index] = 2.0 * index;
+                  c[index] = 1.0;
+               }
+
+               double sum = ev9::memory_bandwidth::pass(op, isa, non_temporal, a, b, c, count);
+
+               for (std::size_t index = 0; index < count; ++index)
+               {
+                  double expected = (double)index;
+
+                  if (op == ev9::memory_bandwidth::op_write) expected = 3.0;
+                  else if (op == ev9::memory_bandwidth::op_copy) expected = 2.0 * index;
+                  else if (op == ev9::memory_bandwidth::op_triad) expected = 2.0 * index + 3.0;
+
+                  if (a[index] != expected) throw std::runtime_error(name + " stored the wrong value");
+               }
+
+               if (op == ev9::memory_bandwidth::op_read && sum != count * (count - 1) / 2.0)
+               {
+                  throw std::runtime_error(name + " summed wrong");
+               }
+            }
+         }
+      }
+
+      ev9::memory_bandwidth suite;
+
+      suite.set_sample_bytes(1024 * 1024);
+      suite.set_repetitions(2);
+
+      ev9::memory_bandwidth::result res = suite.measure(ev9::memory_bandwidth::op_triad, kernels.back(), false, 96 * 1024, 2);
+
+      // 96 KiB over two threads is 2048 doubles per array per thread
+      if (res.threads != 2 || res.bytes == 0 || res.bytes % (2 * 3 * 2048 * sizeof(double)) != 0 || res.gbytes() <= 0)
+      {
+         throw std::runtime_error("triad measured nothing");
+      }
+
+      std::vector<std::size_t> sizes = suite.sizes();
+      std::vector<std::size_t> threads = suite.thread_counts();
+
+      if (sizes.empty() || sizes[0] != 16 * 1024 || suite.level(sizes[0]) != "L1" || threads[0] != 1 || threads.back() != ev9::topology().cpus().size())
+      {
+         throw std::runtime_error("sweep ranges are off");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_crc32c_chunks()
+{
+   try
+   {
+      if (ev9::crc32c::compute("123456789", 9) != 0xE3069283 || ev9::crc32c::compute_software("123456789", 9) != 0xE3069283)
+      {
+         throw std::runtime_error("wrong CRC32C check value");
+      }
+
+      std::vector<char> data(20000);
+
+      for (std::size_t index = 0; index < data.size(); ++index) data[index] = (char)(index * 131 + (index >> 7));
+
+      // Lengths around the 3 KiB hardware block, from odd offsets
+      for (std::size_t size : { 0, 1, 7, 8, 3071, 3072, 3073, 9216, 19990 })
+      {
+         ev9::crc32c pieces;
+
+         pieces.update(&data[3], size / 3);
+         pieces.update(&data[3 + size / 3], size - size / 3);
+
+         if (ev9::crc32c::compute(&data[3], size) != ev9::crc32c::compute_software(&data[3], size) || pieces.value() != ev9::crc32c::compute_software(&data[3], size))
+         {
+            throw std::runtime_error("CRC32C of " + std::to_string(size) + " bytes differs between paths");
+         }
+      }
+
+      // Three chunks of 100, 0 and 2000 body bytes
+      std::vector<char> stream(3 * ev9::chunk_verifier::header_size + 2100);
+
+      std::size_t lengths[] = { 100, 0, 2000 };
+      std::size_t offset = 0;
+
+      for (std::size_t index = 0; index < 3; ++index)
+      {
+         std::memcpy(&stream[offset + ev9::chunk_verifier::header_size], &data[offset], lengths[index]);
+
+         ev9::chunk_verifier::stamp(&stream[offset], index, lengths[index]);
+
+         offset += ev9::chunk_verifier::header_size + lengths[index];
+      }
+
+      for (std::size_t piece : { 1, 7, 16, 5000 })
+      {
+         ev9::chunk_verifier verifier;
+
+         for (std::size_t position = 0; position < stream.size(); position += piece)
+         {
+            verifier.consume(&stream[position], std::min(piece, stream.size() - position));
+         }
+
+         verifier.finish();
+
+         if (verifier.chunks() != 3 || verifier.bad_chunks() != 0)
+         {
+            throw std::runtime_error("chunks read " + std::to_string(piece) + " bytes at a time did not verify");
+         }
+      }
+
+      ev9::chunk_verifier corrupt;
+
+      stream[ev9::chunk_verifier::header_size + 50] ^= 1;
+
+      corrupt.consume(&stream[0], stream.size() - 1);
+      corrupt.finish();
+
+      // The flipped bit fails the first chunk, the missing byte the last
+      if (corrupt.chunks() != 1 || corrupt.bad_chunks() != 2)
+      {
+         throw std::runtime_error("corruption or truncation went unnoticed");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_verified_stream()
+{
+   try
+   {
+      for (ev9::transport_kind kind : { ev9::transport_tcp, ev9::transport_shm })
+      {
+         ev9::bandwidth receiver(7029, 5000);
+         ev9::bandwidth sender(7029, 5000);
+
+         receiver.set_transport(kind);
+         receiver.set_verify(true);
+         sender.set_transport(kind);
+         sender.set_verify(true);
+
+         // Leaves 5 bytes after the last full chunk, so the one before it
+         // has to shrink to make room for a header
+         sender.set_byte_count(1000 * 5000 + 5);
+
+         ev9::bandwidth::result received;
+
+         receiver.listen();
+
+         helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+         ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+         receiving_thread.join();
+
+         if (sent.bytes != 1000 * 5000 + 5 || received.bytes != sent.bytes)
+         {
+            throw std::runtime_error("verified stream lost bytes");
+         }
+
+         if (!received.verified || received.chunks != sent.chunks || received.chunks != 1001 || received.bad_chunks != 0)
+         {
+            throw std::runtime_error(std::string("chunks failed verification over ") + ev9::transport_kind_name(kind));
+         }
+      }
+
+      ev9::bandwidth zerocopy(7029, 5000);
+
+      zerocopy.set_verify(true);
+      zerocopy.set_send_mode(ev9::bandwidth::mode_zerocopy);
+
+      bool refused = false;
+
+      try
+      {
+         zerocopy.connect("127.0.0.1");
+      }
+
+      catch (std::runtime_error&)
+      {
+         refused = true;
+      }
+
+      if (!refused)
+      {
+         throw std::runtime_error("verification accepted a mode that cannot stamp chunks");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+void test_buffer_pool()
+{
+   try
+   {
+      if (ev9::buffer_pool::rounded_size(1) != 4096 || ev9::buffer_pool::rounded_size(5000) != 8192 || ev9::buffer_pool::rounded_size(EV9_HUGE_PAGE_SIZE + 1) != 2 * EV9_HUGE_PAGE_SIZE)
+      {
+         throw std::runtime_error("buffer sizes rounded to the wrong class");
+      }
+
+      ev9::buffer_pool pool;
+
+      char* first = nullptr;
+
+      {
+         ev9::buffer_pool::lease buffer = pool.acquire(5000);
+
+         if (!buffer || buffer.size() != 8192 || (std::uintptr_t)buffer.data() % 4096 != 0)
+         {
+            throw std::runtime_error("pool buffer has the wrong size or alignment");
+         }
+
+         first = buffer.data();
+
+         // Moving hands over the buffer without returning it
+         ev9::buffer_pool::lease moved(std::move(buffer));
+
+         if (buffer || moved.data() != first)
+         {
+            throw std::runtime_error("moving a lease lost the buffer");
+         }
+      }
+
+      // Faulted in when the region was mapped, so touching it again is free
+      ev9::page_faults before = ev9::page_faults::now(true);
+
+      ev9::buffer_pool::lease again = pool.acquire(8000);
+
+      std::memset(again.data(), 1, again.size());
+
+      if (again.data() != first || pool.hits() != 1 || pool.misses() != 1)
+      {
+         throw std::runtime_error("released buffer was not reused");
+      }
+
+      if ((ev9::page_faults::now(true) - before).minor != 0)
+      {
+         throw std::runtime_error("reused buffer faulted");
+      }
+
+      // One region serves every buffer of a class until it runs out
+      std::vector<ev9::buffer_pool::lease> leases;
+
+      for (std::size_t index = 1; index < EV9_HUGE_PAGE_SIZE / 8192; ++index)
+      {
+         leases.push_back(pool.acquire(8192));
+      }
+
+      if (pool.misses() != 1 || pool.mapped_bytes() != EV9_HUGE_PAGE_SIZE)
+      {
+         throw std::runtime_error("size class did not share its region");
+      }
+
+      ev9::buffer_pool::lease large = pool.acquire(3 * 1024 * 1024);
+
+      if (large.size() != 2 * EV9_HUGE_PAGE_SIZE || pool.mapped_bytes() != 3 * EV9_HUGE_PAGE_SIZE)
+      {
+         throw std::runtime_error("large buffer did not get a region of its own");
+      }
+
+      // A stream on pooled payloads carries the same data
+      ev9::bandwidth receiver(7030, 100000);
+      ev9::bandwidth sender(7030, 100000);
+
+      receiver.set_buffer_pool(&pool);
+      receiver.set_verify(true);
+      sender.set_buffer_pool(&pool);
+      sender.set_verify(true);
+      sender.set_byte_count(100 * 100000);
+
+      ev9::bandwidth::result received;
+
+      receiver.listen();
+
+      helper_thread receiving_thread([&]() { received = receiver.receive(); });
+
+      ev9::bandwidth::result sent = sender.send("127.0.0.1");
+
+      receiving_thread.join();
+
+      if (received.bytes != sent.bytes || received.chunks != 100 || received.bad_chunks != 0)
+      {
+         throw std::runtime_error("stream over pooled payloads failed verification");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+#if __cplusplus >= 202002L && __linux__
+
+ev9::task<> async_echo_session(ev9::async_stream stream)
+{
+   char buffer[4096];
+
+   std::size_t amount_read;
+
+   while ((amount_read = co_await stream.async_read(buffer, sizeof(buffer))) != 0)
+   {
+      co_await stream.async_write(buffer, amount_read);
+   }
+}
+
+ev9::task<> async_echo_server(ev9::async_loop& loop, ev9::socket& listener, std::size_t sessions)
+{
+   for (std::size_t index = 0; index < sessions; ++index)
+   {
+      loop.spawn(async_echo_session(co_await ev9::async_accept(loop, listener)));
+   }
+}
+
+ev9::task<> async_echo_send(ev9::async_stream& stream, const std::string& message)
+{
+   co_await stream.async_write(message.data(), message.size());
+}
+
+ev9::task<std::size_t> async_echo_client(ev9::async_loop& loop, std::size_t id)
+{
+   ev9::socket connection("127.0.0.1", 7031);
+
+   ev9::async_stream stream = co_await ev9::async_connect(loop, connection);
+
+   // Larger than the socket buffers, so one coroutine writes while this
+   // one reads and both suspend
+   std::string message(300 * 1024, (char)('a' + id % 26));
+   std::string reply(message.size(), '\0');
+
+   loop.spawn(async_echo_send(stream, message));
+
+   std::size_t amount_read = co_await stream.async_read_all(&reply[0], reply.size());
+
+   if (amount_read != reply.size() || reply != message)
+   {
+      throw std::runtime_error("echo came back wrong");
+   }
+
+   co_return id;
+}
+
+ev9::task<> async_echo_check(ev9::async_loop& loop, std::size_t id, std::size_t& finished)
+{
+   std::size_t echoed = co_await async_echo_client(loop, id);
+
+   if (echoed == id) ++finished;
+}
+
+void test_async_sessions()
+{
+   try
+   {
+      ev9::async_loop loop;
+
+      ev9::socket listener(7031);
+
+      listener.bind();
+      listener.listen();
+
+      const std::size_t sessions = 200;
+
+      std::size_t finished = 0;
+
+      // Server and clients share one thread
+      loop.spawn(async_echo_server(loop, listener, sessions));
+
+      for (std::size_t index = 0; index < sessions; ++index)
+      {
+         loop.spawn(async_echo_check(loop, index, finished));
+      }
+
+      loop.run();
+
+      if (finished != sessions || loop.tasks() != 0)
+      {
+         throw std::runtime_error("not every session finished");
+      }
+
+      loop.forget(listener.native_handle());
+      listener.close();
+
+      // A failed spawned task surfaces from run()
+      bool refused = false;
+
+      try
+      {
+         loop.spawn(async_echo_check(loop, 0, finished));
+         loop.run();
+      }
+
+      catch (std::runtime_error&)
+      {
+         refused = true;
+      }
+
+      if (!refused)
+      {
+         throw std::runtime_error("connect to a closed port did not fail");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+#endif
+
+void reactor_client()
+{
+   ev9::socket socket(7008);
+
+   socket.connect();
+
+   std::string message(100000, 'e');
+
+   socket.write(message);
+}
+
+void test_reactor_connections()
+{
+   try
+   {
+      ev9::socket server(7008);
+
+      server.bind();
+      server.listen(16);
+
+      ev9::reactor reactor;
+
+      std::size_t accepted = 0;
+      std::size_t finished = 0;
+      std::size_t received = 0;
+
+      char buffer[4096];
+
+      reactor.listen(server, [&](ev9::reactor::connection&) { ++accepted; }, [&](ev9::reactor::connection& conn)
+      {
+         std::size_t amount_read;
+
+         while ((amount_read = conn.read(buffer, sizeof(buffer))) != 0)
+         {
+            received += amount_read;
+         }
+
+         if (conn.end_of_stream()) ++finished;
+      });
+
+      std::vector<std::unique_ptr<helper_thread> > clients;
+
+      for (int index = 0; index < 3; ++index)
+      {
+         clients.push_back(std::unique_ptr<helper_thread>(new helper_thread(reactor_client)));
+      }
+
+      // Three connections served from this one thread
+      while (finished < 3)
+      {
+         reactor.run_once(1000);
+      }
+
+      for (std::unique_ptr<helper_thread>& client : clients)
+      {
+         client->join();
+      }
+
+      if (accepted != 3 || received != 300000 || reactor.connections() != 0)
+      {
+         throw std::runtime_error("reactor did not serve every connection");
+      }
+   }
+
+   catch (std::exception& e)
+   {
+      throw std::runtime_error(TEST_INFORMATION + e.what());
+   }
+}
+
+int main()
+{
+   // Outlive the suite, whose benchmarks run when it is destroyed
+   std::vector<char> source(64 * 1024, 'a');
+   std::vector<char> destination(source.size());
+
+   // A connected loopback pair; 4 KiB goes through well inside the
+   // socket buffers, so one thread can write and then read it
+   ev9::socket loopback_server(7032);
+   ev9::socket loopback_client(7032);
+
+   loopback_server.bind();
+   loopback_server.listen();
+   loopback_client.connect(5);
+   loopback_server.accept();
+
+   // The client and server halves of these tests run as separate tasks, so
+   // every test needs a thread of its own or the suite deadlocks.
+   ev9::test socket_test(16);
+
+   // A stuck accept() or read() fails its test instead of hanging the suite
+   socket_test.set_timeout(30);
+
+   ADD_TEST(socket_test, test_socket_ctor_dtor);
+   ADD_TEST(socket_test, test_accepting_connection);
+   ADD_TEST(socket_test, test_read);
+   ADD_TEST(socket_test, test_connect);
+   ADD_TEST(socket_test, test_connect_different_ip);
+   ADD_TEST(socket_test, test_write);
+   ADD_TEST(socket_test, test_read_write);
+   ADD_TEST(socket_test, test_read_all);
+   ADD_TEST(socket_test, test_scatter_gather);
+   ADD_TEST(socket_test, test_reactor_connections);
+   ADD_TEST(socket_test, test_uring_backend);
+   ADD_TEST(socket_test, test_bandwidth_byte_count);
+   ADD_TEST(socket_test, test_bandwidth_send_modes);
+   ADD_TEST(socket_test, test_parallel_streams);
+   ADD_TEST(socket_test, test_histogram_percentiles);
+   ADD_TEST(socket_test, test_latency_ping_pong);
+   ADD_TEST(socket_test, test_udp_datagrams);
+   ADD_TEST(socket_test, test_udp_bandwidth);
+   ADD_TEST(socket_test, test_socket_options);
+   ADD_TEST(socket_test, test_framing);
+   ADD_TEST(socket_test, test_buffered_writer);
+   ADD_TEST(socket_test, test_connect_timeout);
+   ADD_TEST(socket_test, test_connection_pool);
+   ADD_TEST(socket_test, test_pooled_runs);
+   ADD_TEST(socket_test, test_interrupted_receivers);
+   ADD_TEST(socket_test, test_sharded_server);
+   ADD_TEST(socket_test, test_topology_placement);
+   ADD_TEST(socket_test, test_local_transports);
+   ADD_TEST(socket_test, test_memory_kernels);
+   ADD_TEST(socket_test, test_crc32c_chunks);
+   ADD_TEST(socket_test, test_verified_stream);
+   ADD_TEST(socket_test, test_buffer_pool);
+
+   #if __cplusplus >= 202002L && __linux__
+      ADD_TEST(socket_test, test_async_sessions);
+   #endif
+   ADD_TEST(socket_test, test_tester_batches);
+   ADD_TEST(socket_test, test_benchmark_statistics);
+   ADD_TEST(socket_test, test_tester_timeout);
+
+   socket_test.add_benchmark("copy 64 KiB", [&]()
+   {
+      std::memcpy(destination.data(), source.data(), source.size());
+
+      ev9::do_not_optimize(destination.data());
+   });
+
+   socket_test.add_benchmark("loopback write/read 4 KiB", [&]()
+   {
+      for (std::size_t sent = 0; sent < 4096; )
+      {
+         sent += loopback_client.write(source.data() + sent, 4096 - sent);
+      }
+
+      loopback_server.read_all(destination.data(), 4096);
 
-   socket_test.add_test(test_socket_ctor_dtor);
-   socket_test.add_test(test_accepting_connection);
-   socket_test.add_test(test_read);
-   socket_test.add_test(test_connect);
-   socket_test.add_test(test_connect_different_ip);
-   socket_test.add_test(test_write);
-   socket_test.add_test(test_read_write);
+      ev9::do_not_optimize(destination.data());
+   });
 }
\ No newline at end of file
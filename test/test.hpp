@@ -8,7 +8,7 @@
 // Time-period:
 //
 // Dec 11, 2014: Version 1.0: Created
-// Dec 11, 2014: Version 1.0: Last Updated
+// Oct 17, 2026: Version 1.1: Last Updated
 //
 // Notes:
 //
@@ -37,6 +37,8 @@
 
 #define PRINT_TEST_INFORMATION printf("%s:%s:%d --", __FILE__, __func__, __LINE__);
 
+#define ADD_TEST(suite, function) (suite).add_test(#function, function)
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -56,6 +58,13 @@ class test : public tester
    public:  // Member functions
    
       void add_test(const std::function<void()>& function) { _add_test(function); }
+      void add_test(const std::string& name, const std::function<void()>& function) { run(function, name); }
+
+      // Fails the test and moves on once it has run for timeout seconds
+      void add_test(const std::string& name, const std::function<void()>& function, double timeout) { run(function, name, timeout); }
+
+      // Timed after the tests, iterations samples following warmup ones
+      void add_benchmark(const std::string& name, const std::function<void()>& function, std::size_t iterations = 30, std::size_t warmup = 3) { _add_benchmark(name, function, iterations, warmup); }
    
    private: // Private member functions
    
@@ -63,6 +72,11 @@ class test : public tester
       {
          run(function);
       }
+
+      void _add_benchmark(const std::string& name, const std::function<void()>& function, std::size_t iterations, std::size_t warmup)
+      {
+         run_benchmark(benchmark(name, function, iterations, warmup));
+      }
     
 }; // end of class(tester_tester)
 
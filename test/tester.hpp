@@ -8,10 +8,42 @@
 // Time-period:
 //
 // Dec 11, 2014: Version 1.0: Created
-// Dec 11, 2014: Version 1.0: Last Updated
+// Oct 17, 2026: Version 1.1: Last Updated
 //
 // Notes:
 //
+// Tests are stored by value in one vector per run, the batch, which the
+// workers only read by index. Tests are dealt round-robin: worker i owns
+// indices i, i + threads, i + 2 * threads and so on, kept as a strided
+// range of two indices rather than a copied queue. A worker takes from the
+// front of its own range and, once that is empty, steals from the back of
+// another's, so a slow test only delays the tests behind it until an idle
+// worker takes them.
+//
+// The workers are a pool the tester starts on its first run and keeps
+// parked on a condition variable between runs, so run_tests() can be
+// called for batch after batch without creating threads. Whatever is
+// still queued when the tester is destroyed runs then. A finished batch
+// is kept until the next test is added, then cleared and reused. Test
+// names are packed into one string, so unnamed tests cost nothing.
+//
+// Every test is timed. A test with a timeout that runs past it is failed
+// and its thread is abandoned: it is detached and a new thread takes over
+// that worker's range. A thread cannot be cancelled safely, so the
+// abandoned one keeps running the test, holding on to the batch, and
+// exits without touching the tester once it returns, if it ever does.
+//
+// Failure messages go into a per-worker arena, one string of text and an
+// array of offsets into it, so a failing test does not allocate an object.
+//
+// Benchmarks run after the tests of the same run, one at a time on the
+// calling thread while the pool is parked, so they are not timed against
+// other work of the tester. Run time is measured on steady_clock.
+//
+// Workers float wherever the scheduler puts them unless a placement is
+// set (see topology.hpp); each worker, and any thread replacing it, is
+// then pinned to its CPU set and the report says where they ran.
+//
 // Requirements: c++11
 //
 ////////////////////////////////////////////////////////////////////////////////
@@ -23,12 +55,19 @@
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-#include "error.hpp"
+#include "benchmark.hpp"
+#include "topology.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
 #include <exception>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -47,6 +86,115 @@ class tester
    public:  // Type definitions
    
       typedef std::function<void()> test;
+      typedef std::chrono::steady_clock clock;
+
+      // Wall time of one test of the last run
+      class timing
+      {
+         public:
+
+            timing() : index(0), seconds(0), timed_out(false) { }
+
+            // Position the test was added at in its run
+            std::size_t index;
+
+            std::string name;
+            double seconds;
+            bool timed_out;
+
+      }; // end of class(timing)
+
+      class test_case
+      {
+         public:
+
+            test_case() : name_offset(0), name_length(0), timeout(0), seconds(0), timed_out(false) { }
+
+            test function;
+
+            // Name in the tester's name arena, no name if name_length is 0
+            std::uint32_t name_offset;
+            std::uint32_t name_length;
+
+            // Seconds, 0 for no deadline
+            double timeout;
+
+            clock::time_point start;
+            double seconds;
+            bool timed_out;
+
+      }; // end of class(test_case)
+
+      typedef std::vector<test_case> batch;
+
+      // Failure messages of one worker or one run, packed into one string
+      class error_arena
+      {
+         public:  // Public Member Functions
+
+            void add(std::size_t test, const std::string& message) { _add(test, message.data(), message.size()); }
+            void append(const error_arena& other) { _append(other); }
+
+            void clear() { _m_failures.clear(); _m_text.clear(); }
+
+            std::size_t size() const { return _m_failures.size(); }
+            std::size_t test(std::size_t index) const { return _m_failures[index].test; }
+            std::string message(std::size_t index) const { return _m_text.substr(_m_failures[index].offset, _m_failures[index].length); }
+
+         private: // Private Member Functions
+
+            void _add(std::size_t test, const char* message, std::size_t length)
+            {
+               failure current;
+
+               current.test = test;
+               current.offset = _m_text.size();
+               current.length = length;
+
+               _m_text.append(message, length);
+               _m_failures.push_back(current);
+            }
+
+            void _append(const error_arena& other)
+            {
+               for (const failure& current : other._m_failures)
+               {
+                  _add(current.test, other._m_text.data() + current.offset, current.length);
+               }
+            }
+
+         private: // Member Variables
+
+            class failure
+            {
+               public:
+
+                  std::size_t test;
+                  std::size_t offset;
+                  std::size_t length;
+
+            }; // end of class(failure)
+
+            std::vector<failure> _m_failures;
+            std::string _m_text;
+
+      }; // end of class(error_arena)
+
+      // Shared by a worker thread and the tester. Once abandoned is set the
+      // thread must not touch the tester, and tests keeps the batch it is
+      // running a test of alive.
+      class worker_token
+      {
+         public:
+
+            worker_token() : abandoned(false) { }
+
+            std::mutex lock;
+            bool abandoned;
+
+            std::shared_ptr<batch> tests;
+
+      }; // end of class(worker_token)
    
    public: // Private Inner Class
       
@@ -59,79 +207,145 @@ class tester
          
       public:  // Public Member Functions
          
-         void add_to_error_list(std::vector<error*>& error_list) { _add_to_error_list(error_list); }
-         void finish() { _finish(); }
-         void start() { _start(); }
+         void add_to_error_list(error_arena& errors) { errors.append(_m_errors); _m_errors.clear(); }
    
-         static void run(test_task* test) { test->_run(); }
+         // Runs tests until its own range and every other worker's are
+         // empty; false if the thread was abandoned and has to exit
+         bool run(const std::shared_ptr<worker_token>& token) { return _run(token); }
+
+         // Tests this worker took from another worker's range
+         std::size_t steals() const { return _m_steals; }
          
       private: // Private Member Functions
          
-         void  _add_to_error_list(std::vector<error*>& error_list)
-         {
-            for (ev9::error* err : _m_error_list)
-            {
-               error_list.push_back(err);
-            }
-         }
-         
          void _ctor()
          {
-            _m_thread = nullptr;
+            _m_workers = nullptr;
+            _m_worker_count = 0;
+            _m_index = 0;
+            _m_steals = 0;
+            _m_tests = nullptr;
+            _m_front = 0;
+            _m_end = 0;
+            _m_current = nullptr;
          }
          
          void _dtor()
          {
-            for (error* err : _m_error_list)
-            {
-               delete err;
-            }
+
          }
          
-         void _finish()
+         bool _next(std::size_t& index)
          {
-            if (_m_thread != nullptr)
             {
-               _m_thread->join();
-               
-               delete _m_thread;
+               std::lock_guard<std::mutex> lock(_m_queue_lock);
+
+               if (_m_front < _m_end)
+               {
+                  index = _m_front;
+
+                  _m_front += _m_worker_count;
+
+                  return true;
+               }
             }
+
+            // Own range is empty: steal from the opposite end of the others
+            for (std::size_t offset = 1; offset < _m_worker_count; ++offset)
+            {
+               test_task& victim = _m_workers[(_m_index + offset) % _m_worker_count];
+
+               std::lock_guard<std::mutex> lock(victim._m_queue_lock);
+
+               if (victim._m_front < victim._m_end)
+               {
+                  victim._m_end -= _m_worker_count;
+
+                  index = victim._m_end;
+
+                  ++_m_steals;
+
+                  return true;
+               }
+            }
+
+            // Nothing is added while a run is going, so every range is done
+            return false;
          }
-         
-         void _start()
-         {
-            _m_thread = new std::thread(run, this);
-         }
-         
-         void _run()
+
+         bool _run(const std::shared_ptr<worker_token>& token)
          {
-            for (std::size_t i = _m_start; i < _m_end; ++i)
+            std::size_t index;
+
+            while (_next(index))
             {
-               test* current_test = _m_task_list[i];
-               
+               test_case* current_test = &(*_m_tests)[index];
+
+               {
+                  std::lock_guard<std::mutex> lock(token->lock);
+
+                  current_test->start = clock::now();
+
+                  _m_current = current_test;
+               }
+
+               std::string message;
+               bool failed = false;
+
                try
                {
-                  (*current_test)();
+                  current_test->function();
                }
                
                catch(std::exception& e)
                {
-                  _m_error_list.push_back(new error(e.what()));
+                  message = e.what();
+                  failed = true;
                }
                
+               std::lock_guard<std::mutex> lock(token->lock);
+
+               if (token->abandoned)
+               {
+                  // Already failed by the tester
+                  return false;
+               }
+
+               std::chrono::duration<double> elapsed = clock::now() - current_test->start;
+
+               current_test->seconds = elapsed.count();
+
+               _m_current = nullptr;
+
+               if (failed)
+               {
+                  _m_errors.add(index, message);
+               }
             }
+
+            return true;
          }
          
       public: // Member Variables
          
-         std::vector<test*> _m_task_list;
-         std::size_t _m_start;
+         // This run's batch and the part of it still to run: every
+         // _m_worker_count-th index from _m_front up to _m_end
+         batch* _m_tests;
+         std::size_t _m_front;
          std::size_t _m_end;
-         
-         std::vector<error*> _m_error_list;
-         
-         std::thread* _m_thread;
-         
+         std::mutex _m_queue_lock;
+
+         // Every worker of the pool, this one at _m_index
+         test_task* _m_workers;
+         std::size_t _m_worker_count;
+         std::size_t _m_index;
+         std::size_t _m_steals;
+         
+         // Test being run, guarded by the lock of the running thread's token
+         test_case* _m_current;
+         std::shared_ptr<worker_token> _m_token;
+
+         error_arena _m_errors;
          
       }; // end of class(test_task)
    
@@ -141,92 +355,185 @@ class tester
    
       virtual ~tester() { _dtor(); }
    
-   private:  // Constructor
+   private: // Owns its worker threads, not copyable
    
-      tester(std::size_t threads, void* object) { _ctor(threads, object); }
+      tester(const tester&);
+      tester& operator=(const tester&);
    
    public:  // Public Member Functions
     
    void collect_results() { _collect_results(); }
    void output_results() { _output_results(); }
-   void run(const test& function) { _run(function); }
+   void run(const test& function) { _run(function, std::string(), _m_timeout); }
+   void run(const test& function, const std::string& name) { _run(function, name, _m_timeout); }
+   void run(const test& function, const std::string& name, double timeout) { _run(function, name, timeout); }
+   void run_benchmark(const benchmark& current) { _m_benchmark_list.push_back(current); }
    void start_tests() { }
+
+   // Room for count more tests, so adding them does not regrow the batch
+   void reserve(std::size_t count) { _prepare_batch(); _m_batch->reserve(_m_batch->size() + count); }
     
+   // Runs every test added since the last run on the pool and returns the
+   // number that failed; print_results false skips the report
+   std::size_t run_tests(bool print_results = true) { return _run_tests(print_results); }
+
+   // Deadline in seconds for tests added without one, 0 to wait forever
+   void set_timeout(double seconds) { _m_timeout = seconds; }
+
+   // Where the workers run; takes effect when the pool starts, so set it
+   // before the first run
+   void set_placement(placement policy) { _set_placement(policy); }
+
+   // The placement as printed in the report, e.g. "compact cpus 0,1,2,3"
+   const std::string& placement_description() const { return _m_placement_description; }
+
+   // How many of the slowest tests the report lists
+   void set_slowest_count(std::size_t count) { _m_slowest_count = count; }
+
+   // Benchmark statistics from the last run, in the order added
+   const std::vector<benchmark::result>& benchmark_results() const { return _m_benchmark_results; }
+
+   // Test times from the last run, slowest first. Built on each call, and
+   // empty once tests for the next run are added.
+   std::vector<timing> test_timings() const { return _test_timings(); }
+
+   std::size_t thread_count() const { return _m_thread_count; }
+
+   // Threads created over the tester's lifetime: the pool, plus one for
+   // every test that timed out
+   std::size_t threads_started() const { return _m_threads_started; }
+
    private: // Private Member Functions
    
       void _collect_results()
       {
-         for (std::size_t index = 0; index < m_test_object->_m_thread_count; ++index)
+         for (std::size_t index = 0; index < _m_thread_count; ++index)
          {
-            test_task& task = m_test_object->_m_tasks[index];
-            
-            task.finish();
-            
-            task.add_to_error_list(_m_error_list);
+            _m_tasks[index].add_to_error_list(_m_errors);
          }
       }
    
       void _ctor(std::size_t threads)
-      {
-         _m_tasks = nullptr;
-         _m_thread_count = 0;
-         _m_total_tests = 0;
-         
-         if (tester::m_test_object == nullptr)
-         {
-             tester::m_test_object = new tester(threads, nullptr);
-         }
-      
-      }
-   
-      void _ctor(std::size_t threads, void* object)
       {
          if (threads == 0)
          {
             threads = std::thread::hardware_concurrency();
          }
          
+         if (threads == 0)
+         {
+            threads = 1;
+         }
+
          _m_thread_count = threads;
          _m_total_tests = 0;
+         _m_runs = 0;
+         _m_generation = 0;
+         _m_active = 0;
+         _m_stopping = false;
+         _m_timeout = 0;
+         _m_slowest_count = 5;
+         _m_threads_started = 0;
+         _m_deadlines = false;
+         _m_batch_done = false;
+
+         _m_placement_description = placement_name(placement_none);
+
+         _m_batch = std::make_shared<batch>();
          
          _m_tasks = new test_task[threads];
+
+         for (std::size_t i = 0; i < _m_thread_count; ++i)
+         {
+            _m_tasks[i]._m_workers = _m_tasks;
+            _m_tasks[i]._m_worker_count = _m_thread_count;
+            _m_tasks[i]._m_index = i;
+         }
       }
    
-   
       void _dtor()
       {
-         if (this == m_test_object)
+         bool pending = !_m_batch_done && !_m_batch->empty();
+
+         // A tester that was never run explicitly reports on the way out
+         if (pending || !_m_benchmark_list.empty() || _m_runs == 0)
          {
-            return;
+            _run_tests(true);
          }
          
-         _run_tests();
+         _stop_workers();
          
          delete [] _m_tasks;
-         
-         for (test* current_test : m_test_object->_m_task_list)
+      }
+   
+      std::string _name(std::size_t index) const
+      {
+         const test_case& current = (*_m_batch)[index];
+
+         if (current.name_length == 0)
          {
-            delete current_test;
+            return "test #" + std::to_string(index + 1);
          }
-         
-         delete m_test_object;
+
+         return _m_names.substr(current.name_offset, current.name_length);
       }
-   
+
       void _output_results()
       {
-         for (error* err : m_test_object->_m_error_list)
+         for (std::size_t index = 0; index < _m_errors.size(); ++index)
          {
-            err->print();
+            std::cout << _m_errors.message(index) << std::endl;
          }
          
-         std::size_t errors = _m_error_list.size();
+         if (!_m_benchmark_results.empty())
+         {
+            benchmark::print_header();
+
+            for (const benchmark::result& current : _m_benchmark_results)
+            {
+               benchmark::print(current);
+            }
+         }
+
+         // Insertion into a short sorted list, rather than sorting the run
+         std::vector<std::size_t> slowest;
+
+         const batch& tests = *_m_batch;
+
+         for (std::size_t index = 0; index < tests.size() && _m_slowest_count > 0; ++index)
+         {
+            if (slowest.size() == _m_slowest_count && tests[slowest.back()].seconds >= tests[index].seconds)
+            {
+               continue;
+            }
+
+            if (slowest.size() == _m_slowest_count) slowest.pop_back();
+
+            std::size_t position = slowest.size();
+
+            while (position > 0 && tests[slowest[position - 1]].seconds < tests[index].seconds) --position;
+
+            slowest.insert(slowest.begin() + position, index);
+         }
+
+         if (!slowest.empty())
+         {
+            std::printf("Slowest tests:\n");
+
+            for (std::size_t index : slowest)
+            {
+               std::printf("   %10.2f ms  %s%s\n", tests[index].seconds * 1e3, _name(index).c_str(), tests[index].timed_out ? " (timed out)" : "");
+            }
+         }
+
+         std::size_t errors = _m_errors.size();
          
          // Print the time processing took
          std::chrono::duration<double> elapsed_seconds = _m_end_time - _m_start_time;
          
          double elapsed_time = elapsed_seconds.count();
          
-         std::printf("--- Total Tests: %lu, Passed: %lu, Failed: %lu\nTested with %lu threads ", _m_total_tests, _m_total_tests - errors, errors, _m_thread_count);
+         std::printf("--- Total Tests: %lu, Passed: %lu, Failed: %lu\nTested with %lu threads (placement %s) ", _m_total_tests, _m_total_tests - errors, errors, _m_thread_count, _m_placement_description.c_str());
          
          if (elapsed_time < 1)
          {
@@ -241,76 +548,326 @@ class tester
          }
       }
    
-      void _run(const test& current_test)
+      // Starts a new batch if the last one has been run
+      void _prepare_batch()
       {
-         test* current_test_copy = new test(current_test);
-         
-         ++m_test_object->_m_total_tests;
-         
-         m_test_object->_m_task_list.push_back(current_test_copy);
+         if (!_m_batch_done)
+         {
+            return;
+         }
          
+         // An abandoned thread still holds the old batch: leave it to it
+         if (_m_batch.use_count() > 1)
+         {
+            _m_batch = std::make_shared<batch>();
+         }
+
+         else
+         {
+            _m_batch->clear();
+         }
+
+         _m_names.clear();
+
+         _m_deadlines = false;
+         _m_batch_done = false;
+      }
+
+      void _run(const test& current_test, const std::string& name, double timeout)
+      {
+         _prepare_batch();
+
+         _m_batch->push_back(test_case());
+
+         test_case& current_test_copy = _m_batch->back();
+
+         current_test_copy.function = current_test;
+         current_test_copy.name_offset = (std::uint32_t)_m_names.size();
+         current_test_copy.name_length = (std::uint32_t)name.size();
+         current_test_copy.timeout = timeout;
+
+         _m_names.append(name);
+
+         if (timeout > 0) _m_deadlines = true;
       }
    
-      static void _run_tests()
+      std::size_t _run_tests(bool print_results)
       {
-         m_test_object->_m_start_time = std::chrono::system_clock::now();
+         _prepare_batch();
          
-         m_test_object->_start_tests();
-         m_test_object->_collect_results();
+         _m_total_tests = _m_batch->size() + _m_benchmark_list.size();
+
+         _m_start_time = clock::now();
          
-         m_test_object->_m_end_time = std::chrono::system_clock::now();
+         _start_tests();
+         _wait_for_workers();
+         _collect_results();
+         _run_benchmarks();
          
-         m_test_object->_output_results();
+         _m_end_time = clock::now();
+
+         if (print_results)
+         {
+            _output_results();
+         }
+
+         std::size_t failed = _m_errors.size();
+
+         _m_errors.clear();
+         _m_benchmark_list.clear();
+
+         _m_batch_done = true;
+
+         ++_m_runs;
+
+         return failed;
       }
    
+      void _run_benchmarks()
+      {
+         _m_benchmark_results.clear();
+
+         for (const benchmark& current : _m_benchmark_list)
+         {
+            try
+            {
+               _m_benchmark_results.push_back(current.run());
+            }
+
+            catch(std::exception& e)
+            {
+               _m_errors.add(_m_batch->size(), current.name() + ": " + e.what());
+            }
+         }
+      }
+
       void _start_tests()
       {
-         std::size_t offset = (m_test_object->_m_task_list.size() / _m_thread_count);
-         std::size_t remainder = (m_test_object->_m_task_list.size() % _m_thread_count);
+         std::size_t count = _m_batch->size();
 
-         std::size_t shift_number = 0;
+         // Round-robin keeps neighbouring tests, which are often alike in
+         // cost, on different workers from the start
+         for (std::size_t i = 0; i < _m_thread_count; ++i)
+         {
+            std::size_t owned = count > i ? (count - i + _m_thread_count - 1) / _m_thread_count : 0;
+
+            _m_tasks[i]._m_tests = _m_batch.get();
+            _m_tasks[i]._m_front = i;
+            _m_tasks[i]._m_end = i + owned * _m_thread_count;
+         }
 
-         for (int i = 0; i < _m_thread_count && i < _m_task_list.size(); ++i)
+         // The pool is only created once; later runs unpark it
+         while (_m_threads.size() < _m_thread_count)
          {
-            m_test_object->_m_tasks[i]._m_task_list = _m_task_list;
-            m_test_object->_m_tasks[i]._m_start = i * offset + shift_number;
+            _m_threads.push_back(_spawn(_m_threads.size(), false));
+         }
 
-            std::size_t end = (i * offset + shift_number) + offset;
+         {
+            std::lock_guard<std::mutex> lock(_m_pool_lock);
+
+            _m_active = _m_thread_count;
+
+            ++_m_generation;
+         }
+
+         _m_wake.notify_all();
+      }
+
+      std::thread _spawn(std::size_t index, bool resume)
+      {
+         std::shared_ptr<worker_token> token = std::make_shared<worker_token>();
+
+         _m_tasks[index]._m_token = token;
+
+         ++_m_threads_started;
+
+         std::thread worker(&tester::_work, this, index, token, _m_generation, resume);
+
+         if (!_m_plan.empty())
+         {
+            topology::pin(worker, _m_plan[index]);
+         }
+
+         return worker;
+      }
+
+      void _set_placement(placement policy)
+      {
+         if (!_m_threads.empty())
+         {
+            throw std::runtime_error("Placement must be set before the tester's first run");
+         }
+
+         topology layout;
+
+         _m_plan = layout.place(policy, _m_thread_count);
+         _m_placement_description = layout.describe(policy, _m_plan);
+
+         if (policy == placement_none)
+         {
+            _m_plan.clear();
+         }
+      }
+
+      std::vector<timing> _test_timings() const
+      {
+         std::vector<timing> timings;
+
+         if (!_m_batch_done)
+         {
+            return timings;
+         }
+
+         timings.reserve(_m_batch->size());
+
+         for (std::size_t index = 0; index < _m_batch->size(); ++index)
+         {
+            timing current;
+
+            current.index = index;
+            current.name = _name(index);
+            current.seconds = (*_m_batch)[index].seconds;
+            current.timed_out = (*_m_batch)[index].timed_out;
+
+            timings.push_back(current);
+         }
+
+         std::stable_sort(timings.begin(), timings.end(), [](const timing& lhs, const timing& rhs) { return lhs.seconds > rhs.seconds; });
+
+         return timings;
+      }
+
+      void _wait_for_workers()
+      {
+         std::unique_lock<std::mutex> lock(_m_pool_lock);
+
+         if (!_m_deadlines)
+         {
+            _m_done.wait(lock, [this]() { return _m_active == 0; });
+
+            return;
+         }
+
+         // Wake up now and then to look for tests past their deadline
+         while (!_m_done.wait_for(lock, std::chrono::milliseconds(10), [this]() { return _m_active == 0; }))
+         {
+            lock.unlock();
+
+            _check_deadlines();
+
+            lock.lock();
+         }
+      }
+
+      void _check_deadlines()
+      {
+         clock::time_point now = clock::now();
+
+         for (std::size_t index = 0; index < _m_thread_count; ++index)
+         {
+            test_task& task = _m_tasks[index];
 
-            if (remainder)
-            {
-               ++end; // add an extra to account for left overs
-               --remainder;
-               ++shift_number;
-            }
-            
-            if (end > m_test_object->_m_task_list.size())
             {
-               end = m_test_object->_m_task_list.size();
+               std::lock_guard<std::mutex> lock(task._m_token->lock);
+
+               test_case* current_test = task._m_current;
+
+               if (current_test == nullptr || current_test->timeout <= 0)
+               {
+                  continue;
+               }
+
+               std::chrono::duration<double> elapsed = now - current_test->start;
+
+               if (elapsed.count() < current_test->timeout)
+               {
+                  continue;
+               }
+
+               // The stuck thread keeps the batch alive until the test
+               // returns, if it ever does
+               task._m_token->abandoned = true;
+               task._m_token->tests = _m_batch;
+               task._m_current = nullptr;
+
+               current_test->seconds = elapsed.count();
+               current_test->timed_out = true;
+
+               std::size_t test_index = current_test - _m_batch->data();
+
+               _m_errors.add(test_index, _name(test_index) + " -- timed out after " + std::to_string(current_test->timeout) + " seconds");
             }
-            
-            m_test_object->_m_tasks[i]._m_end = end;
-            
-            m_test_object->_m_tasks[i].start();
-            
+
+            // Hand the worker's range to a new thread, which also stands in
+            // for the stuck one in _m_active
+            _m_threads[index].detach();
+            _m_threads[index] = _spawn(index, true);
+         }
+      }
+
+      void _stop_workers()
+      {
+         {
+            std::lock_guard<std::mutex> lock(_m_pool_lock);
+
+            _m_stopping = true;
+         }
+
+         _m_wake.notify_all();
+
+         for (std::thread& thread : _m_threads)
+         {
+            thread.join();
          }
-         
       }
     
+      // Worker thread body, parked between runs (tester.cpp). seen is the
+      // generation the thread has already been woken for; resume starts it
+      // on the current run straight away.
+      void _work(std::size_t index, std::shared_ptr<worker_token> token, std::size_t seen, bool resume);
+
    private: // Member Variables
    
-      static tester* m_test_object;
-   
-      std::chrono::time_point<std::chrono::system_clock> _m_start_time;
-      std::chrono::time_point<std::chrono::system_clock> _m_end_time;
+      clock::time_point _m_start_time;
+      clock::time_point _m_end_time;
    
       std::size_t _m_total_tests;
       std::size_t _m_thread_count;
+      std::size_t _m_runs;
+      std::size_t _m_slowest_count;
+      std::size_t _m_threads_started;
+
+      double _m_timeout;
       
       test_task* _m_tasks;
       
-      std::vector<error*> _m_error_list;
-      std::vector<test*> _m_task_list;
+      // Tests of the current or, once _m_batch_done is set, the last run
+      std::shared_ptr<batch> _m_batch;
+      bool _m_batch_done;
+      bool _m_deadlines;
+
+      // Names of the batch's tests, back to back
+      std::string _m_names;
+
+      error_arena _m_errors;
+
+      std::vector<benchmark> _m_benchmark_list;
+      std::vector<benchmark::result> _m_benchmark_results;
+
+      std::vector<std::thread> _m_threads;
+
+      // CPU set per worker, empty when the workers are not placed
+      topology::plan _m_plan;
+      std::string _m_placement_description;
+
+      // Pool state: a new generation wakes the workers for a run, and the
+      // last one to finish it signals _m_done
+      std::mutex _m_pool_lock;
+      std::condition_variable _m_wake;
+      std::condition_variable _m_done;
+      std::size_t _m_generation;
+      std::size_t _m_active;
+      bool _m_stopping;
    
 }; // end of class(tester)
    
@@ -325,4 +882,4 @@ class tester
 #endif // __TESTER_HPP__
 
 ////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
+////////////////////////////////////////////////////////////////////////////////